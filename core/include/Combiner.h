@@ -64,6 +64,8 @@ public:
 	inline vector<FixPar> 	 getConstVars(){return constVars;};
 
 private:
+  void                    buildGausChi2Var(); // helper function for combine()
+
   vector<PDF_Abs*>        pdfs;        // holds all pdfs to be combined
   TString                 title;       // title of the combination, used in plots
   TString                 name;        // name of the combination, used to refer to it and as part of file names
@@ -57,6 +57,7 @@ class ControlPlots
 		vector<TCanvas*> ctrlPlotCanvases; ///< Pointers to the canvases of the control plots, see selectNewCanvas().
 		int              ctrlPadId;        ///< ID of currently selected pad, see selectNewPad().
 		TCut             ctrlPlotCuts;     ///< Cuts that are applied to all control plots.
+		TCut             ctrlPlotCutsFree; ///< ctrlPlotCuts, and only toys whose free fit was done (see --pruning).
 };
 
 #endif
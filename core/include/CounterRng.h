@@ -0,0 +1,80 @@
+/**
+ * Gamma Combination
+ * Date: Oct 2016
+ *
+ **/
+
+#ifndef CounterRng_h
+#define CounterRng_h
+
+#include <iostream>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "RooRandom.h"
+#include "Rtypes.h"
+#include "TMath.h"
+#include "TRandom.h"
+
+using namespace std;
+
+///
+/// Counter based random number generator, Philox4x32-10
+/// (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3", SC11).
+///
+/// The random numbers are a keyed bijection of a 128 bit counter. There is
+/// no state that evolves from one number to the next, so each stream is
+/// fully determined by its key and its first counter value, and any stream
+/// can be started directly, without drawing through the ones before it.
+///
+/// The key is the master seed of the program (--seed). The counter holds
+/// (nrun, scan point, toy, block): one stream per toy, that doesn't depend
+/// on which process generates it, on how many toys were generated before,
+/// or on the order in which the toys are generated. The last counter word
+/// counts the blocks of four numbers drawn from the stream; its upper 8 bits
+/// select a sub-stream, so that one toy can have independent streams for
+/// different purposes.
+///
+/// Code that still uses RooRandom::randomGenerator() seeds it through
+/// seedRooRandom(), from a stream that is numbered by the number of calls
+/// in this process.
+///
+class CounterRng
+{
+public:
+	CounterRng();
+	CounterRng(ULong64_t key, UInt_t c0, UInt_t c1, UInt_t c2, UInt_t subStream=0);
+
+	double                  gaus();
+	UInt_t                  seed();
+	double                  uniform();
+
+	static void             configure(ULong64_t masterSeed, int nrun);
+	static inline ULong64_t getMasterSeed(){return masterSeed;};
+	static void             seedRooRandom();
+	static CounterRng       stream(int point, int toy, UInt_t subStream=0);
+
+	static const UInt_t     kSubStreamGaus   = 0; ///< Gaussian toys
+	static const UInt_t     kSubStreamRooFit = 1; ///< seeds of RooFit generated toys
+	static const UInt_t     kSubStreamLegacy = 2; ///< seeds of RooRandom::randomGenerator()
+	static const UInt_t     kSubStreamMultiStart = 3; ///< start points of MultiStartFitter
+
+private:
+	UInt_t                  next();
+	void                    refill();
+
+	UInt_t key[2];          ///< the key, the master seed
+	UInt_t ctr[4];          ///< the counter of the next block
+	UInt_t out[4];          ///< the current block of random numbers
+	int iOut;               ///< next unused number of the block, 4 = empty
+	bool hasSpareGaus;      ///< gaus() has a second number left from Box-Muller
+	double spareGaus;
+
+	static ULong64_t masterSeed;    ///< key of all streams, set by configure()
+	static UInt_t nrun;             ///< first counter word of all streams
+	static UInt_t nLegacySeeds;     ///< number of calls of seedRooRandom() in this process
+	static bool configured;         ///< configure() was called
+};
+
+#endif
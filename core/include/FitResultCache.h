@@ -9,6 +9,7 @@
 #define FitResultCache_h
 
 #include "OptParser.h"
+#include "ParameterBinding.h"
 #include "Utils.h"
 
 using namespace std;
@@ -24,11 +25,17 @@ using namespace Utils;
 ///    the plugin scans we can refit multiple times with varying start
 ///    parameters
 ///
+/// If a ParameterBinding of the workspace parameters is given, all points
+/// are also kept as value vectors in the order of the binding. They can
+/// then be restored, or used as start parameters of the Fitter, without
+/// any lookup by name. The round robin database then only holds these
+/// vectors, use getValuesRoundRobinNminus() instead of getRoundRobinNminus().
+///
 class FitResultCache
 {
 public:
 
-	FitResultCache(OptParser *arg, int roundrobinsize=4);
+	FitResultCache(OptParser *arg, int roundrobinsize=4, ParameterBinding *binding=0);
 	~FitResultCache();
 
 	void storeParsAtFunctionCall(const RooArgSet* set);
@@ -38,6 +45,10 @@ public:
 	const RooArgSet* getRoundRobinNminus(int n);
 	const inline RooArgSet* getParsAtFunctionCall(){assert(_parsAtFunctionCall); return _parsAtFunctionCall->get(0);};
 	const inline RooArgSet* getParsAtGlobalMin(){assert(_parsAtGlobalMin); return _parsAtGlobalMin->get(0);};	
+	const inline vector<double>* getValuesAtGlobalMin(){assert(_binding); return &_valuesAtGlobalMin;};
+	const vector<double>* getValuesRoundRobinNminus(int n);
+	void restoreParsAtFunctionCall();
+	void restoreParsAtGlobalMin();
 
 private:
       
@@ -47,6 +58,12 @@ private:
 	RooDataSet* _parsAtFunctionCall;
 	RooDataSet* _parsAtGlobalMin;
 	vector<RooDataSet*> _parsRoundRobin;
+	ParameterBinding* _binding;          ///< if given, points are also stored as value vectors in its order
+	vector<double> _valuesAtFunctionCall;
+	vector<double> _valuesAtGlobalMin;
+	vector< vector<double> > _valuesRoundRobin;
+
+	int getRoundRobinId(int n);
 
 };
 
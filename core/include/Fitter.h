@@ -8,8 +8,11 @@
 #ifndef Fitter_h
 #define Fitter_h
 
+#include <map>
+
 #include "PDF_Abs.h"
 #include "OptParser.h"
+#include "ParameterBinding.h"
 #include "Utils.h"
 
 using namespace std;
@@ -19,7 +22,7 @@ class Fitter
 {
 public:
 
-    Fitter(OptParser *arg, RooWorkspace *w, TString name);
+    Fitter(OptParser *arg, RooWorkspace *w, TString name, ParameterBinding *binding=0);
     ~Fitter();
     
     void                    fit();
@@ -30,21 +33,66 @@ public:
     float                   getChi2();
     int                     getStatus();
     void                    print();
+    void                    resetPolicyStats();
     inline void             setStartpars(const RooArgSet* pars){setStartparsFirstFit(pars);};
-    inline void             setStartparsFirstFit(const RooArgSet* pars){startparsFirstFit=pars;};
-    inline void             setStartparsSecondFit(const RooArgSet* pars){startparsSecondFit=pars;};
+    inline void             setStartparsFirstFit(const RooArgSet* pars){startparsFirstFit=pars; startvaluesFirstFit=0;};
+    void                    setStartparsFirstFit(const vector<double>* values);
+    inline void             setStartparsSecondFit(const RooArgSet* pars){startparsSecondFit=pars; startvaluesSecondFit=0;};
+    void                    setStartparsSecondFit(const vector<double>* values);
     
     OptParser *arg;                     ///< command line arguments
     RooWorkspace *w;                    ///< holds all input pdfs, parameters, and observables, as well as the combination
     TString name;                       ///< Name of the pdf. Call combine() first.
     RooArgSet const * startparsFirstFit;      	///< start parameters to be used by all fit routines that run one fit, and by the first fit of fitTwice()
     RooArgSet const * startparsSecondFit;     	///< start parameters to be used by the second fit of fitTwice()
+    const vector<double>* startvaluesFirstFit;  ///< same as startparsFirstFit, in the order of the binding, takes precedence
+    const vector<double>* startvaluesSecondFit; ///< same as startparsSecondFit, in the order of the binding, takes precedence
     int nFit1Best;                      ///< counter, how many times did fit 1 of fitTwice() give smaller chi2
     int nFit2Best;                      ///< counter, how many times did fit 2 of fitTwice() give smaller chi2
     TString pdfName;                    ///< PDF name in workspace, derived from name
     TString obsName;                    ///< dataset name of observables
     TString parsName;                   ///< set name of physics parameters
-    RooFitResult *theResult;            ///< the final result
+    MinimizerSession *session;          ///< minimizer reused for all fits of this Fitter
+    ParameterBinding *binding;          ///< binding of the parameters, to load start parameters given as value vectors
+    bool ownsBinding;                   ///< true if binding was created by this Fitter
+    bool fitDone;                       ///< true once fit() was run
+    float theChi2;                      ///< minimum chi2 of the final result
+    float theEdm;                       ///< EDM of the final result
+    int theStatus;                      ///< MINUIT status of the final result
+    int theCovQual;                     ///< covariance quality of the final result
+    int theNfloat;                      ///< number of floating parameters of the final result
+
+private:
+
+    ///
+    /// What fitTwice() learned about one kind of fit, see --fitpolicy.
+    /// The scan fits and the free fits of the toys behave differently,
+    /// they are told apart by their number of floating parameters. Their
+    /// chi2 also depends on the scan point, see resetPolicyStats().
+    ///
+    struct PolicyStats
+    {
+      int nCalls;           ///< number of calls of fitTwice()
+      int nSkipped;         ///< number of calls where the second fit was skipped
+      int nTwice;           ///< number of calls where both fits were run
+      int nFit1Best;        ///< start parameters of the first fit won
+      int nFit2Best;        ///< start parameters of the second fit won
+      int nClean;           ///< both fits were run, and the one run first converged cleanly
+      int nChanged;         ///< ... and yet the one run second found a smaller minimum
+      double sumChi2;       ///< sum of the chi2 of the nClean clean fits
+      double sumChi2sq;     ///< sum of their squares
+    };
+
+    map<int,PolicyStats> policyStats;   ///< statistics of fitTwice() per number of floating parameters, at the current scan point
+    map<int,PolicyStats> policyTotals;  ///< the same, summed over the previous scan points, for print()
+
+    static void             addPolicyStats(map<int,PolicyStats>& to, const map<int,PolicyStats>& from);
+
+    bool                    isClean(float edm, int status, int covQual) const;
+    bool                    isSecondFitNeeded(const PolicyStats& s, float chi2, bool clean) const;
+    void                    loadStartpars(const RooArgSet* pars, const vector<double>* values);
+    void                    storeResult(MinimizerSession *s);
+    void                    storeResult(RooFitResult *r);
 };
 
 #endif
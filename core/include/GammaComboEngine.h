@@ -10,6 +10,7 @@
 
 #include "ColorBuilder.h"
 #include "Combiner.h"
+#include "CounterRng.h"
 #include "FileNameBuilder.h"
 #include "Graphviz.h"
 #include "MethodPluginScan.h"
@@ -90,6 +91,7 @@ class GammaComboEngine
 		void			printCombinerStructure(Combiner *c);
 		void			printBanner();
 		bool			pdfExists(int id);
+		bool			reuseProbScan(MethodProbScan *scanner);
 		void			savePlot();
 		void			scaleDownErrors();
 		void			scan();
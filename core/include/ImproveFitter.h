@@ -0,0 +1,48 @@
+/**
+ * Gamma Combination
+ * Date: Oct 2016
+ *
+ **/
+
+#ifndef ImproveFitter_h
+#define ImproveFitter_h
+
+#include "RooArgList.h"
+#include "RooFitResult.h"
+#include "RooFormulaVar.h"
+#include "RooWorkspace.h"
+
+#include "MinimizerSession.h"
+#include "RooImproveChi2Var.h"
+#include "Utils.h"
+
+using namespace std;
+using namespace Utils;
+
+///
+/// Finds the minimum with the improve method, the engine behind
+/// Utils::fitToMinImprove().
+///
+/// The augmented chi2 (a RooImproveChi2Var) and its minimizer are built
+/// once, and reused by every fit. Between fits only the position and
+/// width of the bump are updated in place, so that a fit costs the three
+/// minimizations and nothing else. Keep one object per combination,
+/// e.g. see MethodAbsScan::getImproveFitter().
+///
+class ImproveFitter
+{
+public:
+	ImproveFitter(RooWorkspace *w, TString name);
+	~ImproveFitter();
+
+	RooFitResult*           fit();
+
+private:
+	RooWorkspace *w;                ///< workspace holding the PDF
+	TString parsName;               ///< set name of the parameters
+	RooFormulaVar *llFormula;       ///< -2*log(pdf), used if the PDF has no native chi2
+	RooImproveChi2Var *fcn;         ///< the augmented chi2, minimized in all three steps
+	MinimizerSession *session;      ///< the persistent minimizer of fcn
+};
+
+#endif
@@ -18,6 +18,10 @@
 #include "TPaveText.h"
 #include "TF1.h"
 #include "TDatime.h"
+#include "TMD5.h"
+#include "TNamed.h"
+#include "TParameter.h"
+#include "TSystem.h"
 
 #include "Utils.h"
 #include "OneMinusClPlotAbs.h"
@@ -28,6 +32,8 @@
 #include "PullPlotter.h"
 #include "RooSlimFitResult.h"
 #include "FitResultCache.h"
+#include "ImproveFitter.h"
+#include "ParameterBinding.h"
 #include "CLInterval.h"
 #include "CLIntervalPrinter.h"
 #include "CLIntervalMaker.h"
@@ -57,6 +63,7 @@ class MethodAbsScan
 		float                           getCL(double val);
 		CLInterval                      getCLintervalCentral(int sigma=1);
 		inline Combiner* 				getCombiner() const {return combiner;};
+		inline TString                  getConfigHash() const {return configHash;};
 		int                             getDrawSolution();
 		inline bool                     getFilled(){return drawFilled;};
 		inline TH1F*                    getHCL(){return hCL;};
@@ -89,6 +96,7 @@ class MethodAbsScan
 		inline TString                  getTitle(){return title;};
 		inline RooWorkspace*            getWorkspace(){return w;};
 		virtual void                    initScan();
+		bool                            isScannerUpToDate(TString fName);
 		void                            loadParameters(RooSlimFitResult *r);
 		bool                            loadSolution(int i=0);
 		bool                            loadScanner(TString fName="");
@@ -131,6 +139,10 @@ class MethodAbsScan
 
 	protected:
 
+		TString computeConfigHash();
+		ImproveFitter*    getImproveFitter();
+		MinimizerSession* getMinimizerSession();
+		ParameterBinding* getParameterBinding();
 		void    sortSolutions();
 
 		TString name;       ///< basename, e.g. ggsz
@@ -153,6 +165,8 @@ class MethodAbsScan
 		RooWorkspace* w;
 		RooDataSet* obsDataset;     ///< save the nominal observables so we can restore them after we have fitted toys
 		RooDataSet* startPars;      ///< save the start parameter values before any scan
+		vector<double> startParsValues; ///< the same, in the order of getParameterBinding()
+		vector<double> startParsErrors; ///< their errors, in the order of getParameterBinding()
 		RooFitResult* globalMin;    ///< parameter values at a global minimum
 		TH1F* hCL;                  ///< 1-CL curve
 		TH2F* hCL2d;                ///< 1-CL curve
@@ -174,6 +188,12 @@ class MethodAbsScan
 		bool m_xrangeset; 			///< true if the x range was set manually (setXscanRange())
 		bool m_yrangeset; 			///< true if the y range was set manually (setYscanRange())
 		bool m_initialized; 		///< true if initScan() was called
+		MinimizerSession* minimizer; ///< minimizer reused by all fits of the PDF, see getMinimizerSession()
+		ImproveFitter* improver;     ///< improve method fitter reused by all fits of the PDF, see getImproveFitter()
+		ParameterBinding* parBinding; ///< binding of the parameters of the PDF, see getParameterBinding()
+		TString configHash;         ///< hash of the configuration at construction, see computeConfigHash()
+
+		static const int scannerFileVersion = 2; ///< version of the file format written by saveScanner()
 
 	private:
 
@@ -9,7 +9,10 @@
 #define MethodPluginScan_h
 
 #include <iostream>
+#include <stdio.h>
 #include <stdlib.h>
+#include <sys/wait.h>
+#include <unistd.h>
 
 #include "RooAddition.h"
 #include "RooArgSet.h"
@@ -49,6 +52,9 @@
 #include "MethodAbsScan.h"
 #include "MethodProbScan.h"
 #include "ProgressBar.h"
+#include "PValueAccumulator.h"
+#include "ScanCheckpoint.h"
+#include "ToyGenerator.h"
 #include "ToyTree.h"
 #include "Utils.h"
 
@@ -62,6 +68,7 @@ class MethodPluginScan : public MethodAbsScan
 		MethodPluginScan(MethodProbScan* s);
 		MethodPluginScan(Combiner* comb);
 		MethodPluginScan();
+		~MethodPluginScan();
 
 		inline void     setNtoysPerPoint(int n){nToys=n;};
 		void            setParevolPLH(MethodProbScan* s);
@@ -73,16 +80,34 @@ class MethodPluginScan : public MethodAbsScan
 		double          getPvalue1d(RooSlimFitResult* plhScan, double chi2minGlobal, ToyTree* t=0, int id=0);
 
 	protected:
+		void            	accumulateToys(ToyTree* t, int id, PValueAccumulator* acc);
+		bool              applyToyCuts(ToyTree* t, PValueAccumulator* acc, bool inPlotRange);
 		TH1F*           	analyseToys(ToyTree* t, int id=-1);
-		void          		computePvalue1d(RooSlimFitResult* plhScan, double chi2minGlobal, ToyTree* t, int id, Fitter *f, ProgressBar *pb);
-		RooDataSet*				generateToys(int nToys);
+		TH1F*           	analyseToys(PValueAccumulator* acc, int id=-1);
+		void          		computePvalue1d(RooSlimFitResult* plhScan, double chi2minGlobal, ToyTree* t, int id, Fitter *f, ProgressBar *pb,
+				int firstToy=0);
+		void              fitToy(ToyGenerator* toys, int j, float scanpoint, ToyTree* t, Fitter* f, FitResultCache* frCache,
+				bool pruning=false);
+		void              fitToysParallel(ToyGenerator* toys, float scanpoint, ToyTree* t, const RooArgSet* parsAtGlobalMin, ProgressBar* pb,
+				PValueAccumulator* acc=0, bool pruning=false);
+		void              countSelectedToy(ToyTree* t, PValueAccumulator* acc);
+		void              countToy(ToyTree* t, PValueAccumulator* acc);
+		void              startToyBlock(FitResultCache* frCache, const vector<double>& errorsAtStart);
+		ToyGenerator*			generateToys(int nToys, bool tailSampling=false, int point=0, int firstToy=0);
 		double          	importance(double pvalue);
+		bool            	isPruningPossible();
+		bool            	isPvalueSettled(PValueAccumulator* acc, float scanpoint);
 		RooSlimFitResult*	getParevolPoint(float scanpoint);
 
 
 		int             nToys;              ///< number of toys to be generated at each scan point
 		MethodProbScan* profileLH;          ///< external scanner holding the profile likelihood: DeltaChi2 of the scan PDF on data
 		MethodProbScan* parevolPLH;         ///< external scanner defining the parameter evolution: set to profileLH unless for the Hybrid Plugin
+		ToyGenerator*   toyGenerator;       ///< generates the toys, created by generateToys() on first use
+		ScanCheckpoint* checkpoint;         ///< checkpoints of the running scan1d(), 0 otherwise
+
+		static const int nToysPerBlock = 10; ///< toys fitted from the same start parameters, see startToyBlock()
+		static const double pruningMargin;   ///< distance to the data test statistic below which toys are pruned, see fitToy()
 };
 
 #endif
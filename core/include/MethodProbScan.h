@@ -9,7 +9,10 @@
 #define MethodProb_h
 
 #include <iostream>
+#include <stdio.h>
 #include <stdlib.h>
+#include <sys/wait.h>
+#include <unistd.h>
 
 #include "RooGlobalFunc.h"
 #include "RooWorkspace.h"
@@ -38,6 +41,8 @@
 #include "TGaxis.h"
 #include "TRandom3.h"
 #include "TLegend.h"
+#include "TFile.h"
+#include "TSystem.h"
 
 #include "MethodAbsScan.h"
 #include "PDF_Generic_Abs.h"
@@ -64,12 +69,57 @@ public:
   inline void     setScanDisableDragMode(bool f=true){scanDisableDragMode = f;};
 
 private:
+  ///
+  /// A scan point of the adaptive 1d scan, see scan1dAdaptive().
+  /// The point is at the center of the cell.
+  ///
+  struct AdaptiveCell1d
+  {
+    double lo;              ///< lower cell boundary
+    double hi;              ///< upper cell boundary
+    double chi2;            ///< chi2 of the fit at the cell center
+    RooSlimFitResult *r;    ///< fit result at the cell center
+  };
+
+  ///
+  /// A block of bins of the adaptive 2d scan, see scan2dAdaptive().
+  /// The four corner bins are fitted, bin numbers start at 0.
+  ///
+  struct AdaptiveBlock2d
+  {
+    int i0;                 ///< first bin in x
+    int i1;                 ///< last bin in x
+    int j0;                 ///< first bin in y
+    int j1;                 ///< last bin in y
+  };
+
+  bool            bracketsContour2d(const AdaptiveBlock2d &b, const vector<vector<RooSlimFitResult*> > &fitted) const;
+  double          interpolateBlock2d(const AdaptiveBlock2d &b, const vector<vector<RooSlimFitResult*> > &fitted, int i, int j) const;
+
   bool            computeInnerTurnCoords(const int iStart, const int jStart, const int i, const int j, 
                     int &iResult, int &jResult, int nTurn);
-  bool            deleteIfNotInCurveResults2d(RooSlimFitResult *r);
+  void            fitRing2d(int iStart, int jStart, const vector<int> &ringI, const vector<int> &ringJ,
+                    vector<vector<RooSlimFitResult*> > &mycurveResults2d, vector<RooSlimFitResult*> &results);
+  void            fitAdaptiveBin2d(int i, int j, int ndof, vector<vector<RooSlimFitResult*> > &fitted,
+                    double &bestMinFoundInScan);
+  void            fitAdaptiveCell1d(AdaptiveCell1d &cell);
+  RooSlimFitResult* fitScanBin2d(int i, int j);
+  RooSlimFitResult* fitScanPoint1d(double &chi2minScan);
+  RooSlimFitResult* fitScanPoint2d(int iStart, int jStart, int i, int j,
+                    vector<vector<RooSlimFitResult*> > &mycurveResults2d);
+  bool            releaseScanResult2d(int i, int j);
   void            sanityChecks();
+  void            scan1dAdaptive(bool fast, bool reverse, float startValue, double &bestMinFoundInScan);
+  void            scan1dParallel(bool fast, bool reverse, float startValue, double &bestMinFoundInScan);
+  void            scan2dAdaptive(int iStart, int jStart, int ndof, double &bestMinFoundInScan);
+  void            storeScanResult1d(RooSlimFitResult *r, double chi2minScan, float scanvalue, int i);
+  void            storeScanResult2d(RooSlimFitResult *r, int i, int j, int ndof);
 
   bool            scanDisableDragMode;
+  vector<AdaptiveCell1d> adaptiveCells1d;   ///< cells of the adaptive 1d scan, kept across calls of scan1d()
+  vector<vector<int> > curveResultIndex2d;  ///< position of each curveResults2d entry in allResults, -1 if not known
+  vector<vector<int> > scanResultIndex2d;   ///< position in allResults of the result of the current 2d scan at each point, -1 if released
+  vector<vector<bool> > interpolated2d;     ///< true for bins of hChi2min2d filled by interpolation, see scan2dAdaptive()
 	int							nScansDone;						// count the number of times a scan was done
 };
 
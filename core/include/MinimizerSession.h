@@ -0,0 +1,95 @@
+/**
+ * Gamma Combination
+ * Date: Oct 2016
+ *
+ **/
+
+#ifndef MinimizerSession_h
+#define MinimizerSession_h
+
+#include "RooAbsPdf.h"
+#include "RooAbsReal.h"
+#include "RooArgList.h"
+#include "RooArgSet.h"
+#include "RooFitResult.h"
+#include "RooFormulaVar.h"
+#include "RooMinuit.h"
+#include "RooMsgService.h"
+#include "RooRealVar.h"
+#include "TMinuit.h"
+
+using namespace std;
+using namespace RooFit;
+
+///
+/// A minimizer that is built once per PDF and reused for many fits.
+///
+/// Constructing a RooMinuit object means building the -2*log(pdf)
+/// function, collecting and snapshotting all its parameters, and
+/// setting up a new TFitter. For small combinations this takes longer
+/// than the MIGRAD call itself. A session keeps the RooMinuit object
+/// alive between fits; RooMinuit synchronizes start values, limits
+/// and constant flags from the RooRealVars at the beginning of every
+/// MIGRAD call, so nothing else needs to be done between fits.
+///
+/// After each fit the status, EDM, covariance quality and minimum
+/// chi2 are available without creating a RooFitResult. Call save()
+/// if a full fit result is needed.
+///
+/// RooMinuit keeps its TFitter in a static data member, so only one
+/// RooMinuit object can be used at a time. A session therefore
+/// rebuilds its RooMinuit object if another session has fitted in
+/// the meantime. It also rebuilds when more parameters float than
+/// at the time it was built, because the TFitter is sized for
+/// a fixed number of parameters. In the code all RooMinuit objects
+/// should be created through a session.
+///
+class MinimizerSession
+{
+public:
+	MinimizerSession(RooAbsPdf *pdf);
+	MinimizerSession(RooAbsReal *fcn);
+	~MinimizerSession();
+
+	int                         fit(bool thorough=false);
+	inline double               getChi2() const {return chi2;};
+	inline int                  getCovQual() const {return covQual;};
+	inline double               getEdm() const {return edm;};
+	inline RooAbsReal*          getFcn() const {return fcn;};
+	inline int                  getNbuilds() const {return nBuilds;};
+	inline int                  getNfloat() const {return nFloat;};
+	inline const RooArgList&    getParameters() const {return parameters;};
+	inline RooAbsPdf*           getPdf() const {return pdf;};
+	inline int                  getStatus() const {return status;};
+	RooFitResult*               save();
+	inline void                 setErrorLevel(double level){errorLevel=level;};
+	inline void                 setLogFile(TString file){logFile=file;};
+	inline void                 setPrintLevel(int level){printLevel=level;};
+	inline void                 setStrategy(int s){strategy=s;};
+
+private:
+	void                        attach();
+	int                         countFloating() const;
+	void                        init();
+
+	RooAbsPdf *pdf;             ///< PDF whose -2*log() is minimized, 0 if the session was built for a function
+	RooAbsReal *fcn;            ///< the function that is minimized
+	RooFormulaVar *llFormula;   ///< -2*log(pdf), owned by the session, used if the PDF has no native chi2
+	RooMinuit *minuit;          ///< the persistent minimizer
+	RooArgList parameters;      ///< all parameters of fcn
+	int nFloatBuilt;            ///< number of floating parameters when minuit was built
+	int nBuilds;                ///< number of times minuit was built
+	double errorLevel;          ///< error definition, 1 by default
+	int printLevel;             ///< -1 = quiet, 1 = verbose
+	int strategy;               ///< MINUIT strategy, 2 by default
+	TString logFile;            ///< if set, redirect MINUIT output into this file
+	int status;                 ///< status of the last fit
+	double chi2;                ///< function value at the minimum of the last fit
+	double edm;                 ///< estimated distance to minimum of the last fit
+	int covQual;                ///< covariance matrix quality of the last fit
+	int nFloat;                 ///< number of floating parameters in the last fit
+
+	static MinimizerSession *attached;  ///< the session whose RooMinuit currently owns the static TFitter
+};
+
+#endif
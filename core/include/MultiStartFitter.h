@@ -0,0 +1,120 @@
+/**
+ * Gamma Combination
+ * Date: Oct 2016
+ *
+ **/
+
+#ifndef MultiStartFitter_h
+#define MultiStartFitter_h
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "RooArgList.h"
+#include "RooFitResult.h"
+#include "RooRandom.h"
+#include "RooRealVar.h"
+#include "RooWorkspace.h"
+#include "TMath.h"
+#include "TRandom.h"
+
+#include "CounterRng.h"
+#include "MinimizerSession.h"
+#include "ParameterBinding.h"
+#include "Utils.h"
+
+using namespace std;
+using namespace Utils;
+
+///
+/// Finds the global minimum by refitting from many start points,
+/// the engine behind Utils::fitToMinForce().
+///
+/// A number of parameters, by default the angles and some ratios, are
+/// varied. The start points are either all corners of their ranges
+/// (2^n fits for n parameters), or a space filling set of a given size,
+/// a Latin hypercube or a Sobol sequence. The ranges are the "force"
+/// ranges, see Utils::setLimit().
+///
+/// Each start is fitted with the normal strategy. If an abandon margin
+/// is set, each start is first fitted with MINUIT strategy 0, and if that
+/// local minimum is worse than the best chi2 found so far by more than
+/// the margin, the start is abandoned. Without margin, and without
+/// parallel workers, the fits are the same as those of the original force
+/// method, and the fit result of the best start is returned as it is.
+/// Otherwise the best minimum is fitted once more to get its fit result.
+///
+/// RooMinuit can't run two fits in one process, so with more than one
+/// worker the starts are distributed over forked processes, like the
+/// toys in MethodPluginScan::fitToysParallel(). The workers share the
+/// best chi2 through an anonymous shared memory page, and send back
+/// their best parameter point through a temporary file. The start points
+/// are computed before forking, so the result doesn't depend on the
+/// number of workers, up to the order in which starts are abandoned.
+/// Workers never fork again, see Utils::isWorkerProcess.
+///
+class MultiStartFitter
+{
+public:
+	enum StartSet { kCorners, kLatinHypercube, kSobol };
+
+	MultiStartFitter(RooWorkspace *w, TString name, MinimizerSession *session=0);
+	~MultiStartFitter();
+
+	RooFitResult*           fit();
+	inline int              getNabandoned() const {return nAbandoned;};
+	inline int              getNerrors() const {return nErrors;};
+	inline void             setAbandonMargin(double m){abandonMargin=m;};
+	inline void             setForceVariables(TString v){forceVariables=v;};
+	inline void             setNstarts(int n){nStarts=n;};
+	inline void             setNworkers(int n){nWorkers=n;};
+	void                    setStartSet(TString s);
+
+private:
+	///
+	/// The best fit found by one worker.
+	///
+	struct Candidate
+	{
+		bool found;             ///< false if no start was fitted
+		bool good;              ///< the fit converged with a good covariance matrix
+		double chi2;
+		vector<double> values;  ///< parameter values, in the order of the binding
+	};
+
+	void                    fitStarts(int iFirst, int nStep, Candidate &best, volatile double *sharedBestChi2,
+	                                  RooFitResult **bestResult=0);
+	void                    makeStartsCorners();
+	void                    makeStartsLatinHypercube(int n);
+	void                    makeStartsSobol(int n);
+	bool                    isBetter(const Candidate &c, const Candidate &best) const;
+	void                    selectParameters();
+	void                    updateSharedBestChi2(volatile double *sharedBestChi2, double chi2);
+
+	RooWorkspace *w;                ///< workspace holding the PDF
+	TString name;                   ///< name of the PDF without leading "pdf_"
+	TString parsName;               ///< set name of the parameters
+	TString pdfName;                ///< name of the PDF
+	MinimizerSession *session;      ///< minimizer used for all fits
+	bool ownSession;                ///< true if the session was created here
+	ParameterBinding *binding;      ///< binding of all parameters of the PDF
+	TString forceVariables;         ///< vary only these parameters, format "var1,var2,", default: see selectParameters()
+	StartSet startSet;              ///< how the start points are chosen
+	int nStarts;                    ///< number of start points of the space filling sets, default 8 per varied parameter
+	int nWorkers;                   ///< number of parallel workers, 0 or 1 = serial
+	double abandonMargin;           ///< abandon starts whose strategy 0 minimum is worse than the best by this, no strategy 0 fits if negative
+	RooArgList varyPars;            ///< the varied parameters
+	vector<double> rangeMin;        ///< force range of each varied parameter
+	vector<double> rangeMax;
+	vector<vector<double> > starts; ///< the start points, values of the varied parameters
+	vector<double> startValues;     ///< values of all parameters before the fits, in the order of the binding
+	int nErrors;                    ///< number of starts skipped because of an unreasonable start chi2
+	int nAbandoned;                 ///< number of starts abandoned after the strategy 0 fit
+
+	static UInt_t nLatinHypercubes; ///< number of Latin hypercubes made in this process, numbers their random streams
+};
+
+#endif
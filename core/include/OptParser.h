@@ -37,10 +37,13 @@ class OptParser
 		bool isQuickhack(int id);
 
 		vector<TString>	action;
+		float           adaptive;
 		vector<int>		asimov;
 		vector<TString> asimovfile;
 		bool			cacheStartingValues;
+		float           checkpoint;
 		vector<int>		color;
+		bool			columnar;
 		vector<int>		combid;
 		vector<vector<int> >	combmodifications; // encodes requested modifications to the combiner ID through the -c 26:+12 syntax,format is [cmbid:[+pdf1,-pdf2,...]]
 		bool			controlplot;
@@ -50,6 +53,8 @@ class OptParser
 		int		        digits;
 		bool            enforcePhysRange;
 		TString         filenameaddition;
+		TString         fitpolicy;
+		TString         forcestarts;
 		vector<vector<FixPar> >     fixParameters;
 		vector<vector<RangePar> >   physRanges;
 		TString	group;
@@ -67,12 +72,14 @@ class OptParser
 		int             nBBpoints;
 		int             ndiv;
 		int             ndivy;
+		int             nforcestarts;
 		bool            nosyst;
 		int		npoints1d;
 		int		npoints2dx;
 		int		npoints2dy;
 		int             npointstoy;
 		int		nrun;
+		int             nthreads;
 		int		ntoys;
 		TString 	parsavefile;
 		bool		parevol;
@@ -97,11 +104,15 @@ class OptParser
 		bool            intprob;
 		float           pluginPlotRangeMin;
 		float           pluginPlotRangeMax;
+		float           probadaptive;
+		int             probadaptive2d;
 		bool		probforce;
 		bool		probimprove;
 		bool		printcor;
+		bool            pruning;
 		vector<int>   	qh;
     TString         queue;
+		bool            resume;
 		vector<TString> relation;
 		vector<float>   savenuisances1d;
 		vector<float>   savenuisances2dx;
@@ -111,11 +122,14 @@ class OptParser
 		float           scanrangeMax;
 		float           scanrangeyMin;
 		float           scanrangeyMax;
+		int             seed;
 		bool    smooth2d;
+		bool            tailsampling;
 		vector<TString> title;
 		bool            usage;
 		vector<TString> var;
 		bool		verbose;
+		float           walltime;
 
     CmdLine cmd;
 
@@ -40,6 +40,7 @@
 #include "TRandom3.h"
 #include "TLegend.h"
 
+#include "CounterRng.h"
 #include "Utils.h"
 #include "ParametersAbs.h"
 
@@ -0,0 +1,119 @@
+/**
+ * Gamma Combination
+ * Date: Oct 2016
+ *
+ **/
+
+#ifndef PValueAccumulator_h
+#define PValueAccumulator_h
+
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "TH1F.h"
+#include "TMath.h"
+#include "TString.h"
+#include "TSystem.h"
+
+using namespace std;
+
+///
+/// Running counts of the plugin toys, per scan point.
+///
+/// MethodPluginScan::analyseToys() only needs, for every scan point,
+/// the number of toys that have a better test statistic than the data,
+/// the number of all physical toys, the number of toys with a better
+/// goodness-of-fit, and the number of unphysical (background) toys.
+/// These counts are additive, so toys can be folded in file by file.
+/// The accumulator remembers which toy files it has already ingested,
+/// together with their size and modification time, and can be saved
+/// to and loaded from a small text file. When only a few new batch
+/// jobs have finished, only their files need to be read.
+///
+/// Toys can carry a weight, see ToyGenerator::setTailSampling().
+/// Then the sums of weights and of squared weights are kept, and the
+/// p-value is the weighted fraction of toys with a better test statistic.
+///
+/// Toys whose free fit was pruned (--pruning) can't be better, but it is
+/// not known if their free fit would have converged into the physical
+/// region. They are kept apart, and enter the number of physical toys
+/// scaled by the acceptance of the unpruned toys at the same scan point,
+/// see getAcceptance(). They don't enter the goodness-of-fit count.
+///
+class PValueAccumulator
+{
+public:
+	PValueAccumulator();
+	~PValueAccumulator();
+
+	void                addFailedFreeFit(float scanpoint);
+	void                addFile(TString file);
+	void                addPrunedToy(float scanpoint, double weight=1.);
+	void                addScanpoint(float scanpoint);
+	void                addToy(float scanpoint, bool inPhysicalRegion, bool better, bool gof, double weight=1.);
+	int                 checkFile(TString file) const;
+	void                fillHistograms(TH1F *h_better, TH1F *h_all, TH1F *h_gof, TH1F *h_background) const;
+	inline TString      getConfig() const {return config;};
+	inline int          getNfiles() const {return files.size();};
+	Long64_t            getNall(float scanpoint) const;
+	Long64_t            getNbackground() const;
+	double              getNeff(float scanpoint) const;
+	double              getPvalue(float scanpoint) const;
+	double              getPvalueError(float scanpoint) const;
+	inline int          getScanpointN() const {return points.size();};
+	float               getScanpointMax() const;
+	float               getScanpointMin() const;
+	bool                hasDifferentBinWidths() const;
+	bool                hasFilesOtherThan(const vector<TString>& fileList) const;
+	bool                read(TString fileName);
+	void                reset();
+	inline void         setConfig(TString c){config=c;};
+	void                write(TString fileName) const;
+
+	Long64_t nEntries;          ///< number of entries read
+	Long64_t nFailed;           ///< number of toys that failed the quality cuts
+	Long64_t nWrongRun;         ///< number of toys with a different global chi2min
+	Long64_t nToysId;           ///< number of toys that passed the id selection
+
+private:
+	///
+	/// Counts at one scan point.
+	///
+	struct Counts
+	{
+		Long64_t nAll;          ///< number of physical toys
+		Long64_t nBackground;   ///< number of unphysical toys
+		double wBetter;         ///< sum of weights of physical toys with a better test statistic than the data
+		double wAll;            ///< sum of weights of physical toys
+		double wGof;            ///< sum of weights of physical toys with a worse global minimum than the data
+		double w2Better;        ///< sum of squared weights of physical toys with a better test statistic
+		double w2All;           ///< sum of squared weights of physical toys
+		Long64_t nFailedFree;   ///< number of toys with a good scan fit and a failed free fit
+		double wPruned;         ///< sum of weights of toys with a pruned free fit
+		double w2Pruned;        ///< sum of their squared weights
+	};
+
+	///
+	/// An ingested toy file.
+	///
+	struct FileInfo
+	{
+		Long64_t size;
+		Long_t modTime;
+	};
+
+	double              getAcceptance(const Counts &c) const;
+	bool                getFileInfo(TString file, FileInfo &info) const;
+	double              getWall(const Counts &c) const;
+	double              getW2all(const Counts &c) const;
+
+	TString config;                     ///< describes the cuts the counts were made with
+	map<float,Counts> points;           ///< counts per scan point
+	map<TString,FileInfo> files;        ///< ingested toy files
+};
+
+#endif
@@ -0,0 +1,66 @@
+/**
+ * Gamma Combination
+ * Date: Oct 2016
+ *
+ **/
+
+#ifndef ParameterBinding_h
+#define ParameterBinding_h
+
+#include <iostream>
+#include <map>
+#include <vector>
+
+#include "RooAbsCollection.h"
+#include "RooRealVar.h"
+#include "TIterator.h"
+#include "TString.h"
+
+#include "RooSlimFitResult.h"
+
+using namespace std;
+
+///
+/// Moves parameter values between the workspace and stored
+/// parameter points without looking up names.
+///
+/// Utils::setParameters() finds every parameter by name in the
+/// destination set, which adds up when it is called several times per
+/// toy. A binding resolves the variables of a set, e.g. the parameters
+/// of a combination, once, and fixes their order. Parameter points are
+/// then stored as plain vectors in this order, and loading or storing
+/// them is a loop over pointers. For a RooSlimFitResult the position of
+/// each bound parameter in the result's schema is looked up once per
+/// schema, see RooSlimFitSchema.
+///
+class ParameterBinding
+{
+public:
+	ParameterBinding(const RooAbsCollection* set);
+	~ParameterBinding();
+
+	inline RooRealVar*          at(int i) const {return vars[i];};
+	int                         getIndex(TString name) const;
+	inline int                  getSize() const {return vars.size();};
+	void                        load(const vector<double>& values) const;
+	void                        load(const vector<float>& values) const;
+	void                        load(const RooSlimFitResult* r, bool constAndFloat=false);
+	void                        loadConstant(const vector<bool>& isConstant) const;
+	void                        loadErrors(const vector<double>& errors) const;
+	void                        loadFloating(const vector<double>& values) const;
+	void                        store(vector<double>& values) const;
+	void                        store(vector<float>& values) const;
+	void                        store(const RooAbsCollection* set, vector<double>& values) const;
+	void                        storeConstant(vector<bool>& isConstant) const;
+	void                        storeErrors(vector<double>& errors) const;
+
+private:
+	void                        checkSize(int n, TString method) const;
+	const vector<int>&          getSlots(const RooSlimFitSchema* schema);
+
+	const RooAbsCollection* source;                         ///< the bound set
+	vector<RooRealVar*> vars;                               ///< the bound variables, in the order of all stored points
+	map<const RooSlimFitSchema*, vector<int> > schemaSlots; ///< per schema, the position of each bound variable, -1 if missing
+};
+
+#endif
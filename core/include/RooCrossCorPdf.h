@@ -1,6 +1,8 @@
 #ifndef ROOCROSSCORPDF
 #define ROOCROSSCORPDF
 
+#include <vector>
+
 #include "RooAbsPdf.h"
 //#include "RooRealProxy.h"
 //#include "Rtypes.h"
@@ -11,22 +13,41 @@
 
 class RooRealVar;
 
+///
+/// Correlations between the observables of two PDFs. Only the entries
+/// of the inverse covariance matrix that connect an observable of the
+/// first PDF to one of the second are used. The non-zero ones of those
+/// are collected once into a sparse list, so that evaluating the PDF
+/// doesn't allocate memory and doesn't loop over the full matrix.
+///
 class  RooCrossCorPdf : public RooAbsPdf {
 
 
 public:
+  RooCrossCorPdf() : _nObsPdf1(0), _entriesBuilt(false) {};
   RooCrossCorPdf(const char *name, const char *title,
 	const RooArgList& th, const RooArgList& obs, const TMatrixDSym& invcov, int nObsPdf1);
   RooCrossCorPdf(const  RooCrossCorPdf& other, const char* name = 0);
   virtual TObject* clone(const char* newname) const { return new  RooCrossCorPdf(*this,newname); }
   inline virtual ~ RooCrossCorPdf() {}
 
+  Double_t        getChi2() const;
+  virtual Double_t getLogVal(const RooArgSet* set=0) const;
+
 
 protected:
   RooListProxy _th ;
   RooListProxy _obs ;
   TMatrixDSym _invcov ;
   int _nObsPdf1;
+  mutable std::vector<int> _entryI;       //! row of each non-zero cross entry of _invcov
+  mutable std::vector<int> _entryJ;       //! column of each non-zero cross entry of _invcov
+  mutable std::vector<double> _entryVal;  //! value of each non-zero cross entry of _invcov
+  mutable bool _entriesBuilt;             //! false until buildEntries() was called
+  mutable std::vector<double> _delta;     //! scratch space holding obs-th
+
+  void buildEntries() const;
+  Double_t computeExponent() const;
   Double_t evaluate() const;
 
 
@@ -0,0 +1,67 @@
+/**
+ * Gamma Combination
+ * Date: Oct 2016
+ *
+ **/
+
+#ifndef ROOGAUSCHI2VAR
+#define ROOGAUSCHI2VAR
+
+#include <vector>
+
+#include "RooAbsPdf.h"
+#include "RooAbsReal.h"
+#include "RooArgList.h"
+#include "RooListProxy.h"
+#include "RooRealProxy.h"
+#include "TMatrixDSym.h"
+
+#include "RooCrossCorPdf.h"
+
+///
+/// Native chi2 of a product of multivariate Gaussians,
+///
+///   chi2 = sum_blocks (th-obs)^T C^-1 (th-obs),
+///
+/// that is the same quantity the fitters compute as -2*log(pdf) of the
+/// combined RooMultiVarGaussian PDF, but without going through exp(), log()
+/// and the formula interpreter. Each block is one PDF of the combination,
+/// defined by its theory list, its observables, and its covariance matrix.
+/// The inverse covariance matrices are stored as contiguous arrays.
+/// Cross correlation PDFs between the Gaussians add their -2*log()
+/// through RooCrossCorPdf::getChi2().
+///
+/// The object holds a (non-value) proxy to the combined PDF it replaces,
+/// so that the fitters can find it through Utils::findGausChi2Var().
+///
+class RooGausChi2Var : public RooAbsReal
+{
+public:
+  RooGausChi2Var() {};
+  RooGausChi2Var(const char *name, const char *title, RooAbsPdf& pdf);
+  RooGausChi2Var(const RooGausChi2Var& other, const char* name=0);
+  virtual TObject* clone(const char* newname) const { return new RooGausChi2Var(*this,newname); }
+  inline virtual ~RooGausChi2Var() {}
+
+  void            addBlock(const RooArgList& th, const RooArgList& obs, const TMatrixDSym& cov);
+  void            addCrossCorPdf(RooCrossCorPdf& pdf);
+  inline int      getNblocks() const {return _blockSize.size();};
+  inline int      getNcrossCorPdfs() const {return _crossCor.getSize();};
+
+protected:
+  RooRealProxy _pdf;               ///< the combined PDF this chi2 stands in for
+  RooListProxy _th;                ///< theory relations of all blocks, concatenated
+  RooListProxy _obs;               ///< observables of all blocks, concatenated
+  RooListProxy _crossCor;          ///< cross correlation PDFs
+  std::vector<int> _blockSize;     ///< number of observables of each block
+  std::vector<double> _invCov;     ///< inverse covariance matrices of all blocks, row-major, concatenated
+  mutable std::vector<double> _delta; //! scratch space holding th-obs
+
+  void            computeDelta() const;
+  Double_t        evaluate() const;
+
+private:
+  ClassDef(RooGausChi2Var, 2) // chi2 of a product of multivariate Gaussians
+};
+
+#endif
@@ -0,0 +1,59 @@
+/**
+ * Gamma Combination
+ * Date: Oct 2016
+ *
+ **/
+
+#ifndef ROOIMPROVECHI2VAR
+#define ROOIMPROVECHI2VAR
+
+#include <vector>
+
+#include "RooAbsReal.h"
+#include "RooArgList.h"
+#include "RooFitResult.h"
+#include "RooListProxy.h"
+#include "RooRealProxy.h"
+#include "TMatrixDSym.h"
+
+///
+/// The chi2 augmented by a Gaussian bump at a known minimum,
+///
+///   chi2 + height * exp(-1/2 (x-mu)^T C^-1 (x-mu)),
+///
+/// which is the function minimized in the second step of the improve
+/// method, see ImproveFitter. The position mu and the covariance C of the
+/// bump are taken from a fit result, and can be replaced in place through
+/// setMinimum(), so that one object (and one minimizer) serves all fits
+/// of a scan. The bump is the same as the value of the Hesse PDF returned
+/// by RooFitResult::createHessePdf(). A height of zero switches it off.
+///
+class RooImproveChi2Var : public RooAbsReal
+{
+public:
+  RooImproveChi2Var() {};
+  RooImproveChi2Var(const char *name, const char *title, RooAbsReal& chi2, const RooArgList& pars);
+  RooImproveChi2Var(const RooImproveChi2Var& other, const char* name=0);
+  virtual TObject* clone(const char* newname) const { return new RooImproveChi2Var(*this,newname); }
+  inline virtual ~RooImproveChi2Var() {}
+
+  inline double   getHeight() const {return _height;};
+  void            setHeight(double height);
+  bool            setMinimum(const RooFitResult& r);
+
+protected:
+  RooRealProxy _chi2;              ///< the chi2 to be augmented
+  RooListProxy _pars;              ///< all parameters the bump may depend on
+  std::vector<int> _index;         ///< position in _pars of each parameter of the bump
+  std::vector<double> _mu;         ///< position of the bump
+  std::vector<double> _invCov;     ///< inverse covariance matrix of the bump, row-major
+  double _height;                  ///< height of the bump
+  mutable std::vector<double> _delta; //! scratch space holding x-mu
+
+  Double_t        evaluate() const;
+
+private:
+  ClassDef(RooImproveChi2Var, 1) // chi2 augmented by a Gaussian bump at a known minimum
+};
+
+#endif
@@ -17,15 +17,57 @@
 #include "RooRealVar.h"
 #include "TMath.h"
 #include "TDatime.h"
+#include "TBuffer.h"
+
+#include <map>
+#include <string>
+#include <vector>
 // #include "Utils.h" // doesn't compile when included
 
 using namespace std;
 
+///
+/// The parameters of a RooSlimFitResult: their names, and whether
+/// they are constant or angles. All fit results of a scan share the
+/// same few schemas, so the names are stored only once per schema
+/// instead of once per fit result. Schemas are interned, intern()
+/// returns the same object for the same list of parameters. They
+/// live until the end of the program.
+///
+class RooSlimFitSchema
+{
+	public:
+		static const RooSlimFitSchema* intern(const vector<string>& names, const vector<bool>& isConst, const vector<bool>& isAngle);
+
+		int                       getIndex(const TString& name) const;
+		inline int                getFloatId(int i) const {return _floatIds[i];};
+		inline const string&      getName(int i) const {return _names[i];};
+		inline int                getSize() const {return _names.size();};
+		inline bool               isAngle(int i) const {return _isAngle[i];};
+		inline bool               isConst(int i) const {return _isConst[i];};
+
+	private:
+		RooSlimFitSchema(const vector<string>& names, const vector<bool>& isConst, const vector<bool>& isAngle);
+
+		vector<string>  _names;       ///< parameter names
+		vector<bool>    _isConst;     ///< is it constant?
+		vector<bool>    _isAngle;     ///< is it an angle?
+		vector<int>     _floatIds;    ///< ID of floating parameter, corresponds to the correlation matrix position, -1 for constants
+		map<string,int> _index;       ///< position of each parameter by name
+
+		static map<string,RooSlimFitSchema*> _schemas; ///< all interned schemas, by their parameter list
+};
+
 ///
 /// Class that essentially mimics the functionality of a RooFitResult,
 /// but uses less internal memory by not storing the correlation matrix,
 /// if not specifically requested. It also contains a few extra getters.
 ///
+/// The parameter names and flags are held by a shared RooSlimFitSchema,
+/// each fit result only stores the values and errors, in the order
+/// of the schema. Parameters can be accessed by name, or, faster, by
+/// their index in the schema, see getParIndex().
+///
 class RooSlimFitResult : public TObject
 {
 	public:
@@ -42,7 +84,13 @@ class RooSlimFitResult : public TObject
     	inline Double_t	          edm() const {return _edm;};
     	RooArgList&	              floatParsFinal() const;
     	float                     getParVal(TString name) const;
+    	inline float              getParVal(int i) const {return _parsVal[i];};
     	float                     getParErr(TString name) const;
+    	inline float              getParErr(int i) const {return _parsErr[i];};
+    	inline int                getParIndex(TString name) const {return _schema ? _schema->getIndex(name) : -1;};
+    	inline const string&      getParName(int i) const {return _schema->getName(i);};
+    	inline int                getNpars() const {return _parsVal.size();};
+    	inline const RooSlimFitSchema* getSchema() const {return _schema;};
     	float                     getConstParVal(TString name) const;
     	float                     getFloatParFinalVal(TString name) const;
     	bool					  hasParameter(TString name) const;
@@ -55,14 +103,12 @@ class RooSlimFitResult : public TObject
 		// private:
 
 		template<class FitResult> void      init(const FitResult *r, bool storeCorrelation=false);
+		void                                copy(const RooSlimFitResult *r);
 		bool                                isAngle(RooRealVar* v);
 
-		vector<string>  _parsNames;   // variable names
-		vector<int>     _parsFloatId; // ID of floating parameter - this corresponds to the correlation matrix position
-		vector<float>   _parsVal;     // values of const parameters, index given by position in _variable names
+		const RooSlimFitSchema* _schema; // names and flags of the parameters, shared with other fit results
+		vector<float>   _parsVal;     // values of the parameters, index given by position in the schema
 		vector<float>   _parsErr;
-		vector<bool>    _parsAngle; // is it an angle?
-		vector<bool>    _parsConst; // is it constant?
 		Double_t	      _edm;
 		Double_t	      _minNLL;
 		Int_t           _covQual;
@@ -73,9 +119,11 @@ class RooSlimFitResult : public TObject
 		mutable RooArgList        _constParsDummy; //! <- The exlcamation mark turns off storing in a root file (marks the member transient)
 		mutable RooArgList        _floatParsFinalDummy; //! mutables can be changed in const methods
 
-		ClassDef(RooSlimFitResult, 1) // defines version number, ClassDef is a macro
+		ClassDef(RooSlimFitResult, 2) // defines version number, ClassDef is a macro. Version 2 has a custom Streamer()
 
 	private:
+		void            readVersion1(TBuffer &R__b, UInt_t R__s, UInt_t R__c);
+
 		bool            _isConfirmed;
 };
 
@@ -86,28 +134,30 @@ class RooSlimFitResult : public TObject
 template<class FitResult> void RooSlimFitResult::init(const FitResult *r, bool storeCorrelation)
 {
 	assert(r);
+	vector<string> names;
+	vector<bool> isConst;
+	vector<bool> isAngle;
 	// copy over const parameters
 	int size = r->constPars().getSize();
 	for ( int i=0; i<size; i++ ){
 		RooRealVar* p = (RooRealVar*)r->constPars().at(i);
-		_parsNames.push_back(p->GetName());
+		names.push_back(p->GetName());
 		_parsVal.push_back(p->getVal());
 		_parsErr.push_back(0.);
-		_parsAngle.push_back(isAngle(p));
-		_parsConst.push_back(true);
-		_parsFloatId.push_back(-1); // floating ID doesn't exist for constant parameters
+		isAngle.push_back(this->isAngle(p));
+		isConst.push_back(true);
 	}
-	// copy over floating parameters
+	// copy over floating parameters, their order matches the COR matrix
 	size = r->floatParsFinal().getSize();
 	for ( int i=0; i<size; i++ ){
 		RooRealVar* p = (RooRealVar*)r->floatParsFinal().at(i);
-		_parsNames.push_back(p->GetName());
+		names.push_back(p->GetName());
 		_parsVal.push_back(p->getVal());
 		_parsErr.push_back(p->getError());
-		_parsAngle.push_back(isAngle(p));
-		_parsConst.push_back(false);
-		_parsFloatId.push_back(i); // needed to store the parameter's position in the COR matrix (matches floatParsFinal())
+		isAngle.push_back(this->isAngle(p));
+		isConst.push_back(false);
 	}
+	_schema = RooSlimFitSchema::intern(names, isConst, isAngle);
 	// copy over numeric values
 	_covQual = r->covQual();
 	_edm = r->edm();
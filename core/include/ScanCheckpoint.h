@@ -0,0 +1,70 @@
+/**
+ * Gamma Combination
+ * Date: Oct 2016
+ *
+ **/
+
+#ifndef ScanCheckpoint_h
+#define ScanCheckpoint_h
+
+#include <iostream>
+#include <stdio.h>
+#include <time.h>
+
+#include "TFile.h"
+#include "TParameter.h"
+#include "TString.h"
+#include "TTree.h"
+
+#include "CounterRng.h"
+#include "OptParser.h"
+#include "ToyTree.h"
+#include "Utils.h"
+
+using namespace std;
+
+///
+/// Checkpoints of a plugin batch job.
+///
+/// A plugin scan keeps its ToyTree in memory. With --checkpoint, the tree
+/// is written to the output file every few minutes, together with a progress
+/// record: the scan point and the toy to continue with, and the master seed
+/// of the random numbers. Each file is first written under a temporary name
+/// and then renamed, so a job that is killed always leaves a complete file.
+/// The final file has no progress record. Files with a progress record can
+/// be read by the analysis like finished ones, they just hold fewer toys.
+///
+/// With --walltime, the job writes a checkpoint and stops once the budget,
+/// counted from the program start, is used up. --resume continues a job
+/// from its file. Because the toys come from CounterRng streams numbered by
+/// scan point and toy, the resumed job draws exactly the toys the original
+/// job would have drawn next.
+///
+class ScanCheckpoint
+{
+public:
+	ScanCheckpoint(OptParser *arg, TString fileName);
+	~ScanCheckpoint();
+
+	inline int          getPoint() const {return point;};
+	inline int          getToy() const {return toy;};
+	inline bool         isStopped() const {return stopped;};
+	bool                resume(ToyTree *t);
+	bool                update(ToyTree *t, int nextPoint, int nextToy);
+	void                writeFinal(ToyTree *t);
+
+private:
+	bool                isOutOfTime() const;
+	void                write(ToyTree *t, bool final);
+
+	OptParser *arg;             ///< command line options
+	TString fileName;           ///< the output file of the job
+	time_t lastWrite;           ///< time of the last checkpoint
+	int point;                  ///< scan point to continue with
+	int toy;                    ///< toy of that scan point to continue with
+	bool stopped;               ///< the wall time budget is used up
+
+	static time_t programStart; ///< start of the program, the wall time budget counts from here
+};
+
+#endif
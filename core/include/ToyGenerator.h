@@ -0,0 +1,116 @@
+/**
+ * Gamma Combination
+ * Date: Oct 2016
+ *
+ **/
+
+#ifndef ToyGenerator_h
+#define ToyGenerator_h
+
+#include "RooAbsPdf.h"
+#include "RooAbsReal.h"
+#include "RooArgSet.h"
+#include "RooDataSet.h"
+#include "RooMsgService.h"
+#include "RooMultiVarGaussian.h"
+#include "RooRandom.h"
+#include "RooRealVar.h"
+#include "RooWorkspace.h"
+#include "TDecompChol.h"
+#include "TMatrixDSym.h"
+#include "TRandom3.h"
+
+#include "Combiner.h"
+#include "CounterRng.h"
+
+using namespace std;
+using namespace RooFit;
+
+///
+/// Generates toy observables of a combination.
+///
+/// Most PDFs of a combination are multivariate Gaussians. Their toys
+/// are drawn directly as x = th + L*z, where z is a vector of standard
+/// normal numbers, th the current value of the theory relations, and L the
+/// Cholesky factor of the covariance matrix, which is computed once per
+/// PDF. Only the remaining PDFs, e.g. the histogram based ones, are
+/// generated through RooFit. If the combination contains cross correlation
+/// PDFs, the PDFs share observables and can't be generated one by one, so
+/// then the full combined PDF is generated through RooFit.
+///
+/// The toys are kept in one contiguous array, ordered by toy, then by
+/// observable. loadToy() copies one toy into the observables of the
+/// workspace.
+///
+/// For p-values far in the tail, the Gaussian toys can be drawn from a
+/// proposal distribution that is widened towards the data, see
+/// setTailSampling(). In the space of the standard normal numbers z, the
+/// data lies at a distance r along a unit vector u, u and r follow from
+/// solving L*u*r = data - th. The proposal widens z only along u, by a
+/// factor s = max(1, r/2), so that the data is at about 2 sigma. Widening
+/// only one direction keeps the weights independent of the number of
+/// observables. The proposal is a defensive mixture: a fraction a of the
+/// toys is drawn from the nominal distribution, so that the weight
+/// target/proposal = 1/(a + (1-a)/s exp((1-1/s^2)t^2/2)), t = u.z,
+/// never exceeds 1/a. Toys drawn through RooFit are not widened. The
+/// weights neglect the different effect of the observable ranges on
+/// target and proposal, which is small unless the ranges cut into the
+/// distributions. The logarithm of the weights is kept, as the weights
+/// of toys far out on the widened side are tiny.
+///
+/// The random numbers of the Gaussian toys come from one CounterRng
+/// stream per toy, numbered by the stream key set by setStreamKey() and
+/// the toy number. A toy therefore doesn't depend on how many toys are
+/// generated at a time, and any single toy can be regenerated by
+/// generate(1, j). The RooFit generated PDFs can only be seeded per call
+/// of generate(), from the stream of its first toy.
+///
+class ToyGenerator
+{
+public:
+	ToyGenerator(Combiner *c);
+	~ToyGenerator();
+
+	void                generate(int nToys, int firstToy=0);
+	inline int          getFirstToy() const {return firstToy;};
+	inline int          getNtoys() const {return nToys;};
+	inline double       getLogWeight(int j) const {return logWeights[j];};
+	double              getProposalPvalue(double dchi2) const;
+	inline double       getProposalScale() const {return proposalScale;};
+	void                loadToy(int j);
+	void                print(int j) const;
+	void                setTailSampling(const RooArgSet *data);
+	double              updateProposal();
+	inline void         setStreamKey(int point){streamPoint=point;};
+
+private:
+	void                addRooFitPdf(RooAbsPdf *pdf, const RooArgSet *obs);
+	void                generateRooFit(int iPdf);
+	void                generateTailToy(CounterRng &rng, const vector<double> &th, double *toy, double &logWeight);
+
+	RooWorkspace *w;                        ///< the workspace holding the combination
+	vector<RooRealVar*> observables;        ///< all observables of the combination, in the order of the toy array
+	int nToys;                              ///< number of toys currently held
+	int firstToy;                           ///< stream number of the first toy held
+	int streamPoint;                        ///< scan point number of the streams, see setStreamKey()
+	vector<double> toys;                    ///< the toys, nToys*observables.size() values
+	vector<double> logWeights;              ///< the log of the weight of each toy
+	bool tailSampling;                      ///< draw the Gaussian toys from the widened proposal, see setTailSampling()
+	vector<double> tailData;                ///< data values of the Gaussian observables, in the order of gausObsIndex
+	vector<double> tailDirection;           ///< the unit vector u, concatenated over the Gaussian PDFs
+	double proposalScale;                   ///< width s of the proposal along u, 1 = no widening
+
+	static const double defensiveFraction;  ///< fraction a of the toys drawn from the nominal distribution
+
+	// multivariate Gaussian PDFs
+	vector<int> gausBlockSize;              ///< number of observables of each Gaussian PDF
+	vector<RooAbsReal*> gausTheory;         ///< theory relations of all Gaussian PDFs, concatenated
+	vector<int> gausObsIndex;               ///< position of the corresponding observables in the toy array
+	vector<double> gausCholesky;            ///< lower triangular Cholesky factors, row-major, concatenated
+
+	// PDFs generated through RooFit
+	vector<RooAbsPdf*> rooFitPdfs;          ///< PDFs that are generated by RooFit
+	vector<const RooArgSet*> rooFitObs;     ///< their observables
+};
+
+#endif
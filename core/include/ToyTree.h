@@ -47,6 +47,7 @@ class ToyTree
 		Long64_t                GetEntries();
 		void                    GetEntry(Long64_t i);
 		inline TString          getName(){return name;};
+		void                    getProxyValues(vector<double>& values);
 		float                   getScanpointMin();
 		float                   getScanpointMax();
 		int                     getScanpointN();
@@ -54,9 +55,11 @@ class ToyTree
 		float                   getScanpointyMax();
 		int                     getScanpointyN();
 		TTree*                  getTree(){return t;};
+		inline double           getWeight() const {return exp(logWeight);};
 		bool					isWsVarAngle(TString var);
 		void                    open();
 		void                    setCombiner(Combiner* c);
+		void                    setProxyValues(const vector<double>& values);
 		void                    storeParsPll();
 		void                    storeParsFree();
 		void                    storeParsScan();
@@ -92,10 +95,13 @@ class ToyTree
 		float statusScanPDF;
 		float chi2minToyPDF;
 		float chi2minGlobalToyPDF;
+		double logWeight;       ///< log of the weight of the toy, 0 unless it was drawn from a widened distribution (--tailsampling)
+		float pruned;           ///< 1 if the free fit was skipped (--pruning), chi2minGlobalToy then holds its lower bound 0
 		TTree *t;               ///< the tree
 
 	private:
 
+		void         bookBranches(TString arrayName, TString suffix, const vector<TString>& names, vector<float>& values);
 		void         computeMinMaxN();
 		void         initMembers(TChain* t=0);
 		Combiner *comb;         ///< combination bringing in the arg, workspace, and names
@@ -107,11 +113,17 @@ class ToyTree
 		TString parsName;       ///< set name of physics parameters, derived from name
 		TString thName;         ///< set name of theory parameters, derived from name
 
-		map<string,float>  parametersScan;   ///< fit result of the scan fit
-		map<string,float>  parametersFree;   ///< fit result of the free fit
-		map<string,float>  parametersPll;    ///< parameters of the profile likelihood curve of the data
-		map<string,float>  observables;      ///< values of the observables
-		map<string,float>  theory;           ///< theory parameters (=observables at profile likelihood points)
+		// The variables below are resolved once by init(). The store*()
+		// functions then copy their values into the contiguous arrays,
+		// which the branches point to.
+		vector<RooRealVar*> parsVars;        ///< the parameters, same order as parametersScan, parametersFree, parametersPll
+		vector<RooRealVar*> obsVars;         ///< the observables, same order as observables
+		vector<RooAbsReal*> thVars;          ///< the theory parameters, same order as theory
+		vector<float>  parametersScan;       ///< fit result of the scan fit
+		vector<float>  parametersFree;       ///< fit result of the free fit
+		vector<float>  parametersPll;        ///< parameters of the profile likelihood curve of the data
+		vector<float>  observables;          ///< values of the observables
+		vector<float>  theory;               ///< theory parameters (=observables at profile likelihood points)
 		map<TString,float> constraintMeans;  ///< stores gaussian constraint means for the B2MuMu combination
 
 		float scanpointMin;     ///< minimum of the scanpoint, computed by computeMinMaxN().
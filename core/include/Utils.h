@@ -20,6 +20,8 @@
 #include "RooRealVar.h"
 #include "RooFitResult.h"
 #include "RooSlimFitResult.h"
+#include "RooGausChi2Var.h"
+#include "MinimizerSession.h"
 #include "RooDataSet.h"
 #include "RooMinuit.h"
 #include "TTree.h"
@@ -32,10 +34,13 @@
 using namespace std;
 using namespace RooFit;
 
+class OptParser;
+
 namespace Utils
 {
 	extern int countFitBringBackAngle;      ///< counts how many times an angle needed to be brought back
 	extern int countAllFitBringBackAngle;   ///< counts how many times fitBringBackAngle() was called
+	extern bool isWorkerProcess;            ///< true in forked worker processes, which must not fork again
 
 	// used to fix parameters in the combination, see e.g. Combiner::combine()
 	struct FixPar
@@ -65,9 +70,11 @@ namespace Utils
 	bool          isPosDef(TMatrixDSym* c);
 	bool          isAngle(RooRealVar* v);
 
-	RooFitResult*   fitToMin(RooAbsPdf *pdf, bool thorough, int printLevel);
-	RooFitResult*   fitToMinBringBackAngles(RooAbsPdf *pdf, bool thorough, int printLevel);
-	RooFitResult*   fitToMinForce(RooWorkspace *w, TString name, TString forceVariables="");
+	RooAbsReal*     findGausChi2Var(RooAbsPdf *pdf);
+	RooFitResult*   fitToMin(RooAbsPdf *pdf, bool thorough, int printLevel, MinimizerSession *session=0);
+	RooFitResult*   fitToMinBringBackAngles(RooAbsPdf *pdf, bool thorough, int printLevel, MinimizerSession *session=0);
+	void            fitToMinBringBackAngles(MinimizerSession *session, bool thorough, int printLevel);
+	RooFitResult*   fitToMinForce(RooWorkspace *w, TString name, TString forceVariables="", MinimizerSession *session=0, OptParser *arg=0);
 	RooFitResult*   fitToMinImprove(RooWorkspace *w, TString name);
 	double          getChi2(RooAbsPdf *pdf);
 	TH1F*           histHardCopy(const TH1F* h, bool copyContent=true, bool uniqueName=true);
@@ -76,6 +83,7 @@ namespace Utils
 	TTree*  convertRooDatasetToTTree(RooDataSet *d);
 
 	void mergeNamedSets(RooWorkspace *w, TString mergedSet, TString set1, TString set2);
+	void mergeNamedSets(RooWorkspace *w, TString mergedSet, const vector<TString>& sets);
 	void randomizeParameters(RooWorkspace* w, TString setname);
 	void setParameters(const RooAbsCollection* setMe, const RooAbsCollection* values);
 	void setParameters(RooWorkspace* w, TString parname, const RooAbsCollection* set);
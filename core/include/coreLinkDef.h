@@ -7,6 +7,7 @@
 #pragma link C++ nestedtypedef;
 
 #pragma link C++ class RooCrossCorPdf+;
+#pragma link C++ class RooGausChi2Var+;
 #pragma link C++ class SharedArrayImp<char>+;
 #pragma link C++ class SharedArrayImp<short>+;
 #pragma link C++ class SharedArrayImp<int>+;
@@ -35,7 +36,8 @@
 #pragma link C++ class RooBinned2DBicubicBase<RooAbsPdf>+;
 #pragma link C++ class RooHistPdfAngleVar+;
 #pragma link C++ class RooHistPdfVar+;
-#pragma link C++ class RooSlimFitResult+;
+#pragma link C++ class RooImproveChi2Var+;
+#pragma link C++ class RooSlimFitResult-;
 #pragma link C++ class RooPoly3Var+;
 #pragma link C++ class RooPoly4Var+;
 
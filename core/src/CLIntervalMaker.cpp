@@ -23,15 +23,16 @@ void CLIntervalMaker::provideMorePreciseMaximum(float value, TString method)
 {
 	// cout << "CLIntervalMaker::provideMorePreciseMaximum() : " << value << endl;
 	float level = 1.; // accept this many bin sizes deviation
+	float binWidth = _pvalues.GetBinWidth(valueToBin(value)); // bins may be non-uniform, see MethodProbScan::scan1dAdaptive()
 	for ( int i=0; i<_clintervals1sigma.size(); i++ ){
-		if ( fabs(_clintervals1sigma[i].central - value) < level*_pvalues.GetBinWidth(1) ){
+		if ( fabs(_clintervals1sigma[i].central - value) < level*binWidth ){
 			_clintervals1sigma[i].central = value;
 			_clintervals1sigma[i].centralmethod = method;
 			_clintervals1sigma[i].pvalueAtCentral = _pvalues.GetBinContent(valueToBin(value));
 		}
 	}
 	for ( int i=0; i<_clintervals2sigma.size(); i++ ){
-		if ( fabs(_clintervals2sigma[i].central - value) < level*_pvalues.GetBinWidth(1) ){
+		if ( fabs(_clintervals2sigma[i].central - value) < level*binWidth ){
 			_clintervals2sigma[i].central = value;
 			_clintervals2sigma[i].centralmethod = method;
 			_clintervals2sigma[i].pvalueAtCentral = _pvalues.GetBinContent(valueToBin(value));
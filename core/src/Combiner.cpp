@@ -201,29 +201,75 @@ void Combiner::combine()
 	// sort pdfs alphabetically
 	sort( pdfNames.begin(), pdfNames.end() );
 
-	// combine
+	// combine: multiply all pdfs in one flat product, and merge their
+	// sets once. The name is the same as that of the former chain of
+	// pairwise products, ToyTree and FileNameBuilder rely on it.
 	pdfName = pdfNames[0];
-	for (int i=1; i<pdfNames.size(); i++ )
-	{
-		// build name of combined pdf
-		TString newName = pdfName+"_"+pdfNames[i];
-		if ( w->pdf("pdf_"+newName) ) continue;
-
-		// combine pdfs by multiplying them one by one:
-		w->factory("PROD::pdf_"+newName+"(pdf_"+pdfName+", pdf_"+pdfNames[i]+")");
-
-		// define sets of combined parameters
-		parsName = "par_"+newName;
-		obsName = "obs_"+newName;
-		mergeNamedSets(w, parsName, "par_"+pdfName, "par_"+pdfNames[i]);
-		mergeNamedSets(w, obsName,  "obs_"+pdfName, "obs_"+pdfNames[i]);
-		mergeNamedSets(w, "th_"+newName, "th_" +pdfName, "th_" +pdfNames[i]);
-		pdfName = newName;
+	TString factoryArgs = "pdf_"+pdfNames[0];
+	vector<TString> parSets(1, "par_"+pdfNames[0]);
+	vector<TString> obsSets(1, "obs_"+pdfNames[0]);
+	vector<TString> thSets(1, "th_"+pdfNames[0]);
+	for (int i=1; i<pdfNames.size(); i++ ){
+		pdfName += "_"+pdfNames[i];
+		factoryArgs += ", pdf_"+pdfNames[i];
+		parSets.push_back("par_"+pdfNames[i]);
+		obsSets.push_back("obs_"+pdfNames[i]);
+		thSets.push_back("th_"+pdfNames[i]);
+	}
+	parsName = "par_"+pdfName;
+	obsName = "obs_"+pdfName;
+	if ( pdfNames.size()>1 && !w->pdf("pdf_"+pdfName) ){
+		w->factory("PROD::pdf_"+pdfName+"("+factoryArgs+")");
+		mergeNamedSets(w, parsName, parSets);
+		mergeNamedSets(w, obsName, obsSets);
+		mergeNamedSets(w, "th_"+pdfName, thSets);
 	}
 	setParametersConstant();
+	buildGausChi2Var();
 	_isCombined = true;
 }
 
+///
+/// Helper function for combine(). If all PDFs of the combination are
+/// multivariate Gaussians, build a RooGausChi2Var that computes
+/// -2*log() of the combined PDF natively, and add it to the workspace
+/// as "chi2_"+pdfName. The fitters pick it up automatically, see
+/// Utils::findGausChi2Var(). Cross correlation PDFs between the
+/// Gaussians are included. Combinations containing other PDFs, e.g.
+/// histogram based ones, keep using the combined PDF directly.
+///
+void Combiner::buildGausChi2Var()
+{
+	if ( w->function("chi2_"+pdfName) ) return;
+	for ( int i=0; i<pdfs.size(); i++ ){
+		RooAbsPdf *pdf = w->pdf(pdfs[i]->getPdf()->GetName());
+		if ( !pdf ) return;
+		if ( pdfs[i]->isCrossCorPdf() ){
+			if ( !pdf->InheritsFrom("RooCrossCorPdf") ) return;
+		}
+		else if ( !pdf->InheritsFrom("RooMultiVarGaussian") ) return;
+	}
+	RooGausChi2Var chi2("chi2_"+pdfName, "chi2 of "+pdfName, *w->pdf("pdf_"+pdfName));
+	for ( int i=0; i<pdfs.size(); i++ ){
+		if ( pdfs[i]->isCrossCorPdf() ){
+			chi2.addCrossCorPdf(*(RooCrossCorPdf*)w->pdf(pdfs[i]->getPdf()->GetName()));
+			continue;
+		}
+		RooMultiVarGaussian *pdf = (RooMultiVarGaussian*)w->pdf(pdfs[i]->getPdf()->GetName());
+		RooArgList th;
+		RooArgList obs;
+		for ( int j=0; j<pdfs[i]->getObservables()->getSize(); j++ ){
+			th.add(*w->function(pdfs[i]->getTheory()->at(j)->GetName()));
+			obs.add(*w->var(pdfs[i]->getObservables()->at(j)->GetName()));
+		}
+		chi2.addBlock(th, obs, pdf->covarianceMatrix());
+	}
+	RooMsgService::instance().setGlobalKillBelow(WARNING);
+	w->import(chi2, RecycleConflictNodes());
+	RooMsgService::instance().setGlobalKillBelow(INFO);
+	if ( arg->debug ) cout << "Combiner::buildGausChi2Var() : using native chi2 for " << pdfName << endl;
+}
+
 ///
 /// Helper function for combine(), that actually sets those parameters,
 /// that we want to fix, constant in the workspace. They just get added
@@ -478,7 +524,7 @@ void Combiner::setObservablesToToyValues()
 		cout << "Combiner::setObservablesToToyValues() : setting observables to toy values generated from:" << endl;
 		getParameters()->Print("v");
 	}
-	RooRandom::randomGenerator()->SetSeed(0);
+	CounterRng::seedRooRandom();
 	RooMsgService::instance().setStreamStatus(0,kFALSE);
 	RooMsgService::instance().setStreamStatus(1,kFALSE);
 	RooDataSet* dataset = w->pdf("pdf_"+pdfName)->generate(*w->set("obs_"+pdfName), 1, AutoBinned(false));
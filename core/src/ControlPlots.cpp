@@ -10,6 +10,8 @@ ControlPlots::ControlPlots(ToyTree *tt)
 	ctrlPlotCuts = "statusFree==0 && statusScan==0";
 	// if ( arg->id!=-1 ) ctrlPlotCuts = ctrlPlotCuts && Form("BergerBoos_id==%i", arg->id);
 	if ( arg->id!=-1 ) ctrlPlotCuts = ctrlPlotCuts && Form("id==%i", arg->id);
+	ctrlPlotCutsFree = ctrlPlotCuts;
+	if ( t->GetListOfBranches()->FindObject("pruned") ) ctrlPlotCutsFree = ctrlPlotCuts && "pruned==0";
 }
 
 
@@ -120,7 +122,7 @@ void ControlPlots::ctrlPlotChi2()
 	// plot 1: 2D plot of chi scan vs. chi2 global
 	pad = (TPad*)c2->cd(ip++);
 	t->Draw(Form("chi2minToy:chi2minGlobalToy>>htemp1(75,0,%f,75,0,%f)",
-				maxPlottedChi2,maxPlottedChi2), ctrlPlotCuts, "colz");
+				maxPlottedChi2,maxPlottedChi2), ctrlPlotCutsFree, "colz");
 	((TH2F*)(gPad->GetPrimitive("htemp1")))->GetYaxis()->SetTitle("#chi^{2} scan");
 	((TH2F*)(gPad->GetPrimitive("htemp1")))->GetXaxis()->SetTitle("#chi^{2} free");
 	makePlotsNice("htemp1");
@@ -140,7 +142,7 @@ void ControlPlots::ctrlPlotChi2()
 
 	// plot 4: chi2 distribution of the FREE fit
 	pad = (TPad*)c2->cd(ip++);
-	t->Draw("chi2minGlobalToy>>hChi2free", ctrlPlotCuts
+	t->Draw("chi2minGlobalToy>>hChi2free", ctrlPlotCutsFree
 			&& Form("chi2minToy-chi2minGlobalToy>0 && chi2minGlobalToy<%f",maxPlottedChi2));
 	TH1F* hChi2free = (TH1F*)(gPad->GetPrimitive("hChi2free"));
 	// better toys
@@ -148,7 +150,7 @@ void ControlPlots::ctrlPlotChi2()
 				tt->getScanpointN(), tt->getScanpointMin(), tt->getScanpointMax()), ctrlPlotCuts, "colz");
 	TH1D* hBetter = ((TH2F*)(gPad->GetPrimitive("htemp")))->ProjectionX("hBetter",1,1);
 	// add the chi2 distribtion at the best fit value
-	t->Draw("chi2minGlobalToy>>hChi2BestFit", ctrlPlotCuts
+	t->Draw("chi2minGlobalToy>>hChi2BestFit", ctrlPlotCutsFree
 			&& Form("chi2minToy-chi2minGlobalToy>0 && chi2minGlobalToy<%f",maxPlottedChi2)
 			&& Form("%f<scanpoint && scanpoint<%f",
 				hBetter->GetBinCenter(hBetter->GetMaximumBin()-1),
@@ -187,11 +189,11 @@ void ControlPlots::ctrlPlotChi2()
 	pad = (TPad*)c2->cd(ip++);
 	// good toys
 	t->Draw("chi2minToy-chi2minGlobalToy",
-			ctrlPlotCuts && Form("chi2minToy-chi2minGlobalToy>=0 && chi2minToy<%f && chi2minGlobalToy<%f", maxPlottedChi2, maxPlottedChi2));
+			ctrlPlotCutsFree && Form("chi2minToy-chi2minGlobalToy>=0 && chi2minToy<%f && chi2minGlobalToy<%f", maxPlottedChi2, maxPlottedChi2));
 	TH1F* h4sig = (TH1F*)(gPad->GetPrimitive("htemp"))->Clone("h4sig");
 	// possibly background
 	int nBkg = t->Draw("-(chi2minToy-chi2minGlobalToy)",
-			ctrlPlotCuts && Form("chi2minToy-chi2minGlobalToy<0 && chi2minToy<%f && chi2minGlobalToy<%f", maxPlottedChi2, maxPlottedChi2));
+			ctrlPlotCutsFree && Form("chi2minToy-chi2minGlobalToy<0 && chi2minToy<%f && chi2minGlobalToy<%f", maxPlottedChi2, maxPlottedChi2));
 	TH1F* h4bkg = (TH1F*)(gPad->GetPrimitive("htemp"))->Clone("h4bkg");
 	if ( nBkg==0 ) h4bkg->Scale(0); // if no bkg events the htemp from the signal Draw gets cloned again!
 	h4sig->Draw();
@@ -219,7 +221,7 @@ void ControlPlots::ctrlPlotChi2()
 	// good toys
 	int ndof = arg->var.size();
 	t->Draw(Form("TMath::Prob(chi2minToy-chi2minGlobalToy,%i)", ndof),
-			ctrlPlotCuts && Form("chi2minToy-chi2minGlobalToy>=0 && chi2minToy<%f && chi2minGlobalToy<%f", maxPlottedChi2, maxPlottedChi2));
+			ctrlPlotCutsFree && Form("chi2minToy-chi2minGlobalToy>=0 && chi2minToy<%f && chi2minGlobalToy<%f", maxPlottedChi2, maxPlottedChi2));
 	TH1F* h5sig = (TH1F*)(gPad->GetPrimitive("htemp"))->Clone("h5sig");
 	h5sig->SetMaximum(h5sig->GetMaximum()*1.3);
 	h5sig->Draw();
@@ -254,9 +256,16 @@ void ControlPlots::ctrlPlotNuisances()
 	int nBinsX = 50;
 	int nBinsY = tt->getScanpointN()/2;
 
-	for ( int j=0; j<t->GetListOfBranches()->GetEntries(); j++)
+	// files written with --columnar have aliases instead of per-variable branches
+	vector<TString> bNames;
+	for ( int j=0; j<t->GetListOfBranches()->GetEntries(); j++) bNames.push_back(((TBranch*)t->GetListOfBranches()[0][j])->GetName());
+	if ( t->GetListOfAliases() ){
+		for ( int j=0; j<t->GetListOfAliases()->GetEntries(); j++) bNames.push_back(t->GetListOfAliases()->At(j)->GetName());
+	}
+
+	for ( int j=0; j<bNames.size(); j++)
 	{
-		TString bName = ((TBranch*)t->GetListOfBranches()[0][j])->GetName();
+		TString bName = bNames[j];
 		if ( ! (bName.EndsWith("_start")||bName.EndsWith("_scan")||bName.EndsWith("_free")) ) continue;
 
 		TString bBaseName = bName;
@@ -315,16 +324,16 @@ void ControlPlots::ctrlPlotNuisances()
 		{
 			selectNewPad();
 			if (arg->debug) cout << "ControlPlots::ctrlPlotNuisances() : plotting " << varFree << endl;
-			t->Draw("scanpoint:"+varFree, ctrlPlotCuts, "colz");  // first test plot to get the automatic x axis range
+			t->Draw("scanpoint:"+varFree, ctrlPlotCutsFree, "colz");  // first test plot to get the automatic x axis range
 			float xmin = customRangeLo==customRangeHi ? ((TH1F*)(gPad->GetPrimitive("htemp")))->GetXaxis()->GetXmin() : customRangeLo;
 			float xmax = customRangeLo==customRangeHi ? ((TH1F*)(gPad->GetPrimitive("htemp")))->GetXaxis()->GetXmax() : customRangeHi;
 			t->Draw("scanpoint:"+varFree+">>"
 					+Form("hFree%i(%i,%f,%f,%i,%f,%f)",j,nBinsX,xmin,xmax,nBinsY,spmin,spmax),
-					ctrlPlotCuts, "colz");
+					ctrlPlotCutsFree, "colz");
 			TH2F *hFree = ((TH2F*)(gPad->GetPrimitive(Form("hFree%i",j))));
 			t->Draw("scanpoint:"+varStart+">>"
 					+Form("hStart2%i(%i,%f,%f,%i,%f,%f)",j,nBinsX,xmin,xmax,nBinsY,spmin,spmax),
-					ctrlPlotCuts, "box");
+					ctrlPlotCutsFree, "box");
 			TH2F *hStart = ((TH2F*)(gPad->GetPrimitive(Form("hStart2%i",j))));
 			gStyle->SetOptTitle(0);
 			hFree->Draw("colz");
@@ -402,7 +411,7 @@ void ControlPlots::ctrlPlotChi2Distribution()
 		float binMin = scanpointMin+(float)i*(scanpointMax-scanpointMin)/(float)nBins;
 		float binMax = binMin+(scanpointMax-scanpointMin)/(float)nBins;
 		TCut bincut = Form("%f<scanpoint && scanpoint<%f", binMin*0.999, binMax*1.001); // factors to allow for the case of binMin=binMax
-		float normEvents = t->Draw("chi2minToy-chi2minGlobalToy", ctrlPlotCuts && bincut && "chi2minToy-chi2minGlobalToy>0 && chi2minToy-chi2minGlobalToy<50");
+		float normEvents = t->Draw("chi2minToy-chi2minGlobalToy", ctrlPlotCutsFree && bincut && "chi2minToy-chi2minGlobalToy>0 && chi2minToy-chi2minGlobalToy<50");
 		if ( !gPad->GetPrimitive("htemp") ) continue;
 		TPaveText* txt = new TPaveText(0.3,0.8,0.9,0.9,"BRNDC");
 		txt->AddText(Form("%.3f < %s < %.3f", binMin, arg->var[0].Data(), binMax));
@@ -455,7 +464,7 @@ void ControlPlots::ctrlPlotChi2Parabola()
 		float binMin = scanpointMin+(float)i*(scanpointMax-scanpointMin)/(float)nBins;
 		float binMax = binMin+(scanpointMax-scanpointMin)/(float)nBins;
 		TCut bincut = Form("%f<scanpoint && scanpoint<=%f", binMin*0.999, binMax*1.001);  // factors to allow for the case of binMin=binMax
-		t->Draw(plotExpression, ctrlPlotCuts && bincut && "chi2minToy-chi2minGlobalToy>0 && chi2minToy-chi2minGlobalToy<9", "colz");
+		t->Draw(plotExpression, ctrlPlotCutsFree && bincut && "chi2minToy-chi2minGlobalToy>0 && chi2minToy-chi2minGlobalToy<9", "colz");
 		if ( !gPad->GetPrimitive("htemp") ) continue;
 		TPaveText* txt = new TPaveText(0.3,0.8,0.9,0.9,"BRNDC");
 		txt->AddText(Form("%.3f<var<%.3f", binMin, binMax));
@@ -0,0 +1,163 @@
+#include "CounterRng.h"
+
+ULong64_t CounterRng::masterSeed = 0;
+UInt_t CounterRng::nrun = 0;
+UInt_t CounterRng::nLegacySeeds = 0;
+bool CounterRng::configured = false;
+
+///
+/// Default constructor, the stream (0,0,0) of key 0.
+///
+CounterRng::CounterRng()
+{
+	key[0] = key[1] = 0;
+	ctr[0] = ctr[1] = ctr[2] = ctr[3] = 0;
+	iOut = 4;
+	hasSpareGaus = false;
+	spareGaus = 0.;
+}
+
+///
+/// Start a stream.
+///
+/// \param key - the key, usually the master seed
+/// \param c0,c1,c2 - the first three counter words
+/// \param subStream - sub-stream, 0...255
+///
+CounterRng::CounterRng(ULong64_t key, UInt_t c0, UInt_t c1, UInt_t c2, UInt_t subStream)
+{
+	if ( subStream>255 ){
+		cout << "CounterRng::CounterRng() : ERROR : sub-stream " << subStream << " out of range. Exit." << endl;
+		exit(1);
+	}
+	this->key[0] = (UInt_t)(key & 0xffffffffULL);
+	this->key[1] = (UInt_t)(key >> 32);
+	ctr[0] = c0;
+	ctr[1] = c1;
+	ctr[2] = c2;
+	ctr[3] = subStream << 24;
+	iOut = 4;
+	hasSpareGaus = false;
+	spareGaus = 0.;
+}
+
+///
+/// Set the master seed and the run number for all streams of this
+/// program. A master seed of 0 is replaced by one derived from the time
+/// and the process id, which is printed, so that the run can be repeated.
+/// If this is never called, the first stream configures a random seed.
+///
+void CounterRng::configure(ULong64_t masterSeed, int nrun)
+{
+	if ( masterSeed==0 ){
+		masterSeed = ((ULong64_t)time(0) ^ ((ULong64_t)getpid() << 16)) & 0x7fffffff;
+		if ( masterSeed==0 ) masterSeed = 1;
+		cout << "CounterRng::configure() : using random seed " << masterSeed << ", repeat with --seed " << masterSeed << endl;
+	}
+	CounterRng::masterSeed = masterSeed;
+	CounterRng::nrun = nrun;
+	nLegacySeeds = 0;
+	configured = true;
+	seedRooRandom();
+}
+
+///
+/// Get the stream of a toy, keyed by the master seed and the run number.
+///
+/// \param point - number of the scan point
+/// \param toy - number of the toy at this scan point
+/// \param subStream - sub-stream, e.g. kSubStreamGaus
+///
+CounterRng CounterRng::stream(int point, int toy, UInt_t subStream)
+{
+	if ( !configured ) configure(0, 0);
+	return CounterRng(masterSeed, nrun, point, toy, subStream);
+}
+
+///
+/// Seed RooRandom::randomGenerator() for code that draws from it
+/// directly. Each call uses the next legacy stream of this process. Forked
+/// workers inherit the call count, so they must not call this after
+/// forking, or they draw the same numbers.
+///
+void CounterRng::seedRooRandom()
+{
+	if ( !configured ) configure(0, 0);
+	CounterRng rng(masterSeed, nrun, 0, nLegacySeeds++, kSubStreamLegacy);
+	RooRandom::randomGenerator()->SetSeed(rng.seed());
+}
+
+///
+/// One Philox4x32-10 evaluation: encrypt the counter with the key, then
+/// advance the counter.
+///
+void CounterRng::refill()
+{
+	const UInt_t M0 = 0xD2511F53;
+	const UInt_t M1 = 0xCD9E8D57;
+	const UInt_t W0 = 0x9E3779B9;
+	const UInt_t W1 = 0xBB67AE85;
+	UInt_t c[4] = {ctr[0], ctr[1], ctr[2], ctr[3]};
+	UInt_t k0 = key[0];
+	UInt_t k1 = key[1];
+	for ( int r=0; r<10; r++ ){
+		ULong64_t p0 = (ULong64_t)M0*c[0];
+		ULong64_t p1 = (ULong64_t)M1*c[2];
+		UInt_t hi0 = (UInt_t)(p0 >> 32);
+		UInt_t lo0 = (UInt_t)p0;
+		UInt_t hi1 = (UInt_t)(p1 >> 32);
+		UInt_t lo1 = (UInt_t)p1;
+		c[0] = hi1^c[1]^k0;
+		c[1] = lo1;
+		c[2] = hi0^c[3]^k1;
+		c[3] = lo0;
+		k0 += W0;
+		k1 += W1;
+	}
+	for ( int i=0; i<4; i++ ) out[i] = c[i];
+	iOut = 0;
+	ctr[3]++;
+}
+
+UInt_t CounterRng::next()
+{
+	if ( iOut==4 ) refill();
+	return out[iOut++];
+}
+
+///
+/// Uniform random number in (0,1), with 53 bits.
+///
+double CounterRng::uniform()
+{
+	UInt_t a = next() >> 5;
+	UInt_t b = next() >> 6;
+	return (a*67108864.+b+0.5)/9007199254740992.;
+}
+
+///
+/// Standard normal random number, Box-Muller.
+///
+double CounterRng::gaus()
+{
+	if ( hasSpareGaus ){
+		hasSpareGaus = false;
+		return spareGaus;
+	}
+	double r = sqrt(-2.*log(uniform()));
+	double phi = TMath::TwoPi()*uniform();
+	spareGaus = r*sin(phi);
+	hasSpareGaus = true;
+	return r*cos(phi);
+}
+
+///
+/// A non-zero 32 bit seed, e.g. for TRandom3::SetSeed(), where 0
+/// would mean a seed from the clock.
+///
+UInt_t CounterRng::seed()
+{
+	UInt_t s = next();
+	while ( s==0 ) s = next();
+	return s;
+}
@@ -1,6 +1,6 @@
 #include "FitResultCache.h"
 
-FitResultCache::FitResultCache(OptParser *arg, int roundrobinsize)
+FitResultCache::FitResultCache(OptParser *arg, int roundrobinsize, ParameterBinding *binding)
 {
   assert(arg);
   _arg = arg;
@@ -9,6 +9,8 @@ FitResultCache::FitResultCache(OptParser *arg, int roundrobinsize)
 	_parsAtGlobalMin = 0;
 	_roundrobinid = 0;
 	for ( int i=0; i<_roundrobinsize; i++ ) _parsRoundRobin.push_back(0);
+	_binding = binding;
+	if ( _binding ) _valuesRoundRobin.resize(_roundrobinsize);
 }
 
 
@@ -37,6 +39,7 @@ void FitResultCache::storeParsAtFunctionCall(const RooArgSet* set)
 	assert(set);
 	_parsAtFunctionCall = new RooDataSet("parsAtFunctionCall", "parsAtFunctionCall", *set);
 	_parsAtFunctionCall->add(*set);
+	if ( _binding ) _binding->store(set, _valuesAtFunctionCall);
 }
 
 ///
@@ -51,6 +54,7 @@ void FitResultCache::storeParsAtGlobalMin(const RooArgSet* set)
 	if ( _parsAtGlobalMin ) delete _parsAtGlobalMin;
 	_parsAtGlobalMin = new RooDataSet("parsAtGlobalMin", "parsAtGlobalMin", *set);
 	_parsAtGlobalMin->add(*set);
+	if ( _binding ) _binding->store(set, _valuesAtGlobalMin);
 }
 
 ///
@@ -63,6 +67,10 @@ void FitResultCache::storeParsRoundRobin(const RooArgSet* set)
 	assert(set);
 	_roundrobinid++;
 	if ( _roundrobinid>=_roundrobinsize ) _roundrobinid = 0;
+	if ( _binding ){
+		_binding->store(set, _valuesRoundRobin[_roundrobinid]);
+		return;
+	}
 	if ( _parsRoundRobin[_roundrobinid] ) delete _parsRoundRobin[_roundrobinid];
 	_parsRoundRobin[_roundrobinid] = new RooDataSet("parsAtFunctionCall", "parsAtFunctionCall", *set);
 	_parsRoundRobin[_roundrobinid]->add(*set);
@@ -89,12 +97,66 @@ void FitResultCache::initRoundRobinDB(const RooArgSet* set)
 ///
 const RooArgSet* FitResultCache::getRoundRobinNminus(int n)
 {
-	int id = _roundrobinid-n;
-	if ( id<0 ) id += _parsRoundRobin.size();
-	if ( id < 0 || id >=_parsRoundRobin.size() || _parsRoundRobin[id]==0 ){
+	int id = getRoundRobinId(n);
+	if ( _parsRoundRobin[id]==0 ){
 		cout << "FitResultCache::getRoundRobinNminus() : ERROR : "
 			"Trying to access a round robin point that doesn't exist: id=" << id << ". Exit." << endl;
 		exit(1);
 	}
 	return _parsRoundRobin[id]->get(0);
 }
+
+///
+/// Get an entry from the round robin database as value vector
+/// in the order of the binding. Ownership stays with FitResultCache.
+///
+/// \param n - the point we want to get, 0 is the most recent one
+///
+const vector<double>* FitResultCache::getValuesRoundRobinNminus(int n)
+{
+	assert(_binding);
+	int id = getRoundRobinId(n);
+	if ( _valuesRoundRobin[id].empty() ){
+		cout << "FitResultCache::getValuesRoundRobinNminus() : ERROR : "
+			"Trying to access a round robin point that doesn't exist: id=" << id << ". Exit." << endl;
+		exit(1);
+	}
+	return &_valuesRoundRobin[id];
+}
+
+///
+/// Helper function to find the round robin slot of the n-th last point.
+///
+int FitResultCache::getRoundRobinId(int n)
+{
+	int id = _roundrobinid-n;
+	if ( id<0 ) id += _roundrobinsize;
+	if ( id < 0 || id >=_roundrobinsize ){
+		cout << "FitResultCache::getRoundRobinId() : ERROR : "
+			"Trying to access a round robin point that doesn't exist: id=" << id << ". Exit." << endl;
+		exit(1);
+	}
+	return id;
+}
+
+///
+/// Set the bound parameters back to their values at function call.
+/// Requires a binding.
+///
+void FitResultCache::restoreParsAtFunctionCall()
+{
+	assert(_binding);
+	assert(_parsAtFunctionCall);
+	_binding->load(_valuesAtFunctionCall);
+}
+
+///
+/// Set the bound parameters to their values at the global minimum.
+/// Requires a binding.
+///
+void FitResultCache::restoreParsAtGlobalMin()
+{
+	assert(_binding);
+	assert(_parsAtGlobalMin);
+	_binding->load(_valuesAtGlobalMin);
+}
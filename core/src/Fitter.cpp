@@ -1,6 +1,16 @@
 #include "Fitter.h"
 
-Fitter::Fitter(OptParser *arg, RooWorkspace *w, TString name)
+///
+/// \param arg     - command line arguments
+/// \param w       - workspace holding the combination
+/// \param name    - name of the combination
+/// \param binding - binding of the parameters that the start parameter
+///                  vectors are stored with, see setStartparsFirstFit().
+///                  Pass the one of the scanner, whose FitResultCache
+///                  provides them. If 0, a binding of the parameter set
+///                  is created.
+///
+Fitter::Fitter(OptParser *arg, RooWorkspace *w, TString name, ParameterBinding *binding)
 {
   this->w = w;
   this->name = name;
@@ -8,16 +18,112 @@ Fitter::Fitter(OptParser *arg, RooWorkspace *w, TString name)
   
   startparsFirstFit = 0;
   startparsSecondFit = 0;
+  startvaluesFirstFit = 0;
+  startvaluesSecondFit = 0;
   nFit1Best = 0;
   nFit2Best = 0;
   pdfName  = "pdf_"+name;
   obsName  = "obs_"+name;
   parsName = "par_"+name;
-  theResult = 0;
+  session = new MinimizerSession(w->pdf(pdfName));
+  this->binding = binding;
+  ownsBinding = binding==0;
+  if ( ownsBinding ) this->binding = new ParameterBinding(w->set(parsName));
+  fitDone = false;
+  theChi2 = 0.;
+  theEdm = 0.;
+  theStatus = -1;
+  theCovQual = -1;
+  theNfloat = 0;
 }
 
 Fitter::~Fitter()
-{}
+{
+  delete session;
+  if ( ownsBinding ) delete binding;
+}
+
+///
+/// Set the start parameters through a ParameterBinding of the
+/// workspace parameters, as stored by FitResultCache. These take
+/// precedence over the RooArgSet start parameters.
+///
+void Fitter::setStartparsFirstFit(const vector<double>* values)
+{
+  startvaluesFirstFit = values;
+}
+
+void Fitter::setStartparsSecondFit(const vector<double>* values)
+{
+  startvaluesSecondFit = values;
+}
+
+///
+/// Helper function to set the floating parameters to the
+/// start parameters of the first or second fit.
+///
+void Fitter::loadStartpars(const RooArgSet* pars, const vector<double>* values)
+{
+  if ( values ) binding->loadFloating(*values);
+  else setParametersFloating(w, parsName, pars);
+}
+
+///
+/// Keep the numbers of the final result that are needed
+/// by getChi2() and getStatus().
+///
+void Fitter::storeResult(MinimizerSession *s)
+{
+  theChi2 = s->getChi2();
+  theEdm = s->getEdm();
+  theStatus = s->getStatus();
+  theCovQual = s->getCovQual();
+  theNfloat = s->getNfloat();
+}
+
+void Fitter::storeResult(RooFitResult *r)
+{
+  theChi2 = r->minNll();
+  theEdm = r->edm();
+  theStatus = r->status();
+  theCovQual = r->covQual();
+  theNfloat = r->floatParsFinal().getSize();
+}
+
+///
+/// Check if a fit converged cleanly: a good covariance matrix,
+/// MINUIT status 0, and an EDM well below the limit of getStatus().
+///
+bool Fitter::isClean(float edm, int status, int covQual) const
+{
+  return edm<0.01 && status==0 && covQual==3;
+}
+
+///
+/// Decide if the second fit of fitTwice() is needed (--fitpolicy adaptive).
+/// It is skipped only if all of these hold:
+/// - the first fit converged cleanly, see isClean(),
+/// - at least 20 calls of this kind ran both fits, and every 10th call
+///   still does, so that the statistics stay up to date,
+/// - after a clean first fit, the second one found a smaller minimum in
+///   less than 2% of the cases,
+/// - the chi2 is not more than 2 standard deviations above the mean of the
+///   clean fits, as a fit stuck in a secondary minimum has a larger chi2.
+///
+/// \param s     - statistics of this kind of fit
+/// \param chi2  - chi2 of the first fit
+/// \param clean - the first fit converged cleanly
+///
+bool Fitter::isSecondFitNeeded(const PolicyStats& s, float chi2, bool clean) const
+{
+  if ( arg->fitpolicy!="adaptive" ) return true;
+  if ( !clean ) return true;
+  if ( s.nTwice<20 || s.nCalls%10==0 ) return true;
+  if ( s.nChanged>=0.02*s.nClean ) return true;
+  double mean = s.sumChi2/s.nClean;
+  double rms = sqrt(TMath::Max(0., s.sumChi2sq/s.nClean - mean*mean));
+  return chi2 > mean+2.*rms;
+}
 
 ///
 /// Perform two fits, each time using different start parameters,
@@ -26,49 +132,110 @@ Fitter::~Fitter()
 /// second fit, which then uses the start parameters of the first.
 /// This will show up in the RooFitResult.
 ///
+/// With --fitpolicy adaptive, the start parameters that won more often
+/// so far are fitted first, and the second fit is skipped if it isn't
+/// needed, see isSecondFitNeeded(). The statistics are reported by print().
+///
 void Fitter::fitTwice()
 {
+  const RooArgList& pars = session->getParameters();
+  int nFloat = 0;
+  for ( int i=0; i<pars.getSize(); i++ ){
+    if ( !((RooRealVar*)pars.at(i))->isConstant() ) nFloat++;
+  }
+  if ( policyStats.find(nFloat)==policyStats.end() ){
+    PolicyStats empty = {0, 0, 0, 0, 0, 0, 0, 0., 0.};
+    policyStats[nFloat] = empty;
+  }
+  PolicyStats& stats = policyStats[nFloat];
+  stats.nCalls++;
+
+  // run the start parameters that won more often first
+  bool swap = arg->fitpolicy=="adaptive" && stats.nFit2Best>stats.nFit1Best;
+  const RooArgSet* startparsA = swap ? startparsSecondFit : startparsFirstFit;
+  const vector<double>* startvaluesA = swap ? startvaluesSecondFit : startvaluesFirstFit;
+  const RooArgSet* startparsB = swap ? startparsFirstFit : startparsSecondFit;
+  const vector<double>* startvaluesB = swap ? startvaluesFirstFit : startvaluesSecondFit;
+
   // first fit
-	setParametersFloating(w, parsName, startparsFirstFit);
-  RooFitResult *r1 = fitToMinBringBackAngles(w->pdf(pdfName), false, -1);
-  bool f1failed = !(r1->edm()<1 && r1->covQual()==3);
-  
+  loadStartpars(startparsA, startvaluesA);
+  fitToMinBringBackAngles(session, false, -1);
+  bool f1failed = !(session->getEdm()<1 && session->getCovQual()==3);
+  float chi2Fit1 = session->getChi2();
+  float edmFit1 = session->getEdm();
+  int statusFit1 = session->getStatus();
+  int covQualFit1 = session->getCovQual();
+  int nFloatFit1 = session->getNfloat();
+  bool clean1 = isClean(edmFit1, statusFit1, covQualFit1);
+  if ( !isSecondFitNeeded(stats, chi2Fit1, clean1) ){
+    stats.nSkipped++;
+    storeResult(session);
+    return;
+  }
+  vector<double> parsFit1(pars.getSize());
+  for ( int i=0; i<pars.getSize(); i++ ) parsFit1[i] = ((RooRealVar*)pars.at(i))->getVal();
+
   // second fit
-  setParametersFloating(w, parsName, startparsSecondFit);
-  RooFitResult *r2 = fitToMinBringBackAngles(w->pdf(pdfName), false, -1);
-  bool f2failed = !(r2->edm()<1 && r2->covQual()==3);
-  
+  loadStartpars(startparsB, startvaluesB);
+  fitToMinBringBackAngles(session, false, -1);
+  bool f2failed = !(session->getEdm()<1 && session->getCovQual()==3);
+
+  bool useFit1;
   if ( f1failed && f2failed )
   {
-    theResult = r1;
-    delete r2;
-  }  
+    useFit1 = true;
+  }
   else if ( f1failed )
   {
-    nFit2Best++;
-    theResult = r2;
-    delete r1;
+    useFit1 = false;
   }
   else if ( f2failed )
   {
-    nFit1Best++;
-    theResult = r1;
-    delete r2;
+    useFit1 = true;
   }
-  else if ( r1->minNll() < r2->minNll() )
+  else if ( chi2Fit1 < session->getChi2() )
   {
-    nFit1Best++;
-    theResult = r1;
-    delete r2;
+    useFit1 = true;
   }
   else
   {
-    nFit2Best++;
-    theResult = r2;
-    delete r1;
+    useFit1 = false;
   }
-  
-  setParametersFloating(w, parsName, theResult);
+
+  // book the outcome, in terms of the start parameters
+  stats.nTwice++;
+  if ( !(f1failed && f2failed) ){
+    if ( useFit1!=swap ){
+      nFit1Best++;
+      stats.nFit1Best++;
+    }
+    else {
+      nFit2Best++;
+      stats.nFit2Best++;
+    }
+  }
+  if ( clean1 ){
+    stats.nClean++;
+    stats.sumChi2 += chi2Fit1;
+    stats.sumChi2sq += chi2Fit1*chi2Fit1;
+    if ( !f2failed && session->getChi2()<chi2Fit1-0.01 ) stats.nChanged++;
+  }
+
+  // the parameters are at the minimum of the second fit,
+  // move them back if the first fit is retained
+  if ( useFit1 )
+  {
+    for ( int i=0; i<pars.getSize(); i++ ){
+      RooRealVar *p = (RooRealVar*)pars.at(i);
+      if ( !p->isConstant() ) p->setVal(parsFit1[i]);
+    }
+    theChi2 = chi2Fit1;
+    theEdm = edmFit1;
+    theStatus = statusFit1;
+    theCovQual = covQualFit1;
+    theNfloat = nFloatFit1;
+  }
+  else storeResult(session);
 }
 
 ///
@@ -77,9 +244,11 @@ void Fitter::fitTwice()
 ///
 void Fitter::fitForce()
 {
-  setParametersFloating(w, parsName, startparsFirstFit);
-  theResult = fitToMinForce(w, name);
-  setParametersFloating(w, parsName, theResult);
+  loadStartpars(startparsFirstFit, startvaluesFirstFit);
+  RooFitResult *r = fitToMinForce(w, name, "", session, arg);
+  setParametersFloating(w, parsName, r);
+  storeResult(r);
+  delete r;
 }
 
 ///
@@ -88,9 +257,9 @@ void Fitter::fitForce()
 ///
 float Fitter::getChi2()
 {
-  if (!theResult) assert(0);
-  if (theResult->minNll()<-10) return -10;  ///< else we have many entries at -1e27 in the ToyTree
-  return theResult->minNll();
+  if (!fitDone) assert(0);
+  if (theChi2<-10) return -10;  ///< else we have many entries at -1e27 in the ToyTree
+  return theChi2;
 }
 
 ///
@@ -100,10 +269,9 @@ float Fitter::getChi2()
 ///
 int Fitter::getStatus()
 {
-  if ( !theResult ) return -1;
-  if ( theResult->floatParsFinal().getSize()==0 ) return 0;
-  if ( theResult->edm()<1 && theResult->status()==0 && theResult->covQual()==3 ) return 0;
-  // theResult->Print("v");
+  if ( !fitDone ) return -1;
+  if ( theNfloat==0 ) return 0;
+  if ( theEdm<1 && theStatus==0 && theCovQual==3 ) return 0;
   return 1;
 }
 
@@ -112,12 +280,61 @@ int Fitter::getStatus()
 ///
 void Fitter::fit()
 {
-  if ( theResult ) delete theResult;
   if ( arg->scanforce ) fitForce();
   else fitTwice();
+  fitDone = true;
 }
 
+///
+/// Print which start parameters won in fitTwice(), and, per number of
+/// floating parameters, how often the second fit was skipped, and how
+/// often it changed the minimum after a clean first fit.
+///
 void Fitter::print()
 {
   cout << "Fitter: nFit1Best=" << nFit1Best << " nFit2Best=" << nFit2Best << endl;
+  map<int,PolicyStats> totals = policyTotals;
+  addPolicyStats(totals, policyStats);
+  for ( map<int,PolicyStats>::iterator it=totals.begin(); it!=totals.end(); it++ ){
+    const PolicyStats& s = it->second;
+    cout << "Fitter: " << it->first << " floating parameters: " << s.nCalls << " fits, second fit skipped "
+      << s.nSkipped << " times, run " << s.nTwice << " times (start 1 won " << s.nFit1Best << ", start 2 won "
+      << s.nFit2Best << "), changed the minimum after " << s.nChanged << " of " << s.nClean << " clean first fits" << endl;
+  }
+}
+
+///
+/// Start the statistics of fitTwice() over, to be called at each new
+/// scan point: the chi2 of the fits, which decides if the second fit
+/// is needed, depends on the scan point, see isSecondFitNeeded().
+/// The statistics so far are kept for print().
+///
+void Fitter::resetPolicyStats()
+{
+  addPolicyStats(policyTotals, policyStats);
+  policyStats.clear();
+}
+
+///
+/// Helper function to sum up statistics of fitTwice().
+///
+void Fitter::addPolicyStats(map<int,PolicyStats>& to, const map<int,PolicyStats>& from)
+{
+  for ( map<int,PolicyStats>::const_iterator it=from.begin(); it!=from.end(); it++ ){
+    if ( to.find(it->first)==to.end() ){
+      PolicyStats empty = {0, 0, 0, 0, 0, 0, 0, 0., 0.};
+      to[it->first] = empty;
+    }
+    PolicyStats& t = to[it->first];
+    const PolicyStats& s = it->second;
+    t.nCalls += s.nCalls;
+    t.nSkipped += s.nSkipped;
+    t.nTwice += s.nTwice;
+    t.nFit1Best += s.nFit1Best;
+    t.nFit2Best += s.nFit2Best;
+    t.nClean += s.nClean;
+    t.nChanged += s.nChanged;
+    t.sumChi2 += s.sumChi2;
+    t.sumChi2sq += s.sumChi2sq;
+  }
 }
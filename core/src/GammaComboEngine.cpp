@@ -13,6 +13,9 @@ GammaComboEngine::GammaComboEngine(TString name, int argc, char* argv[])
 	arg->bookAllOptions();
 	arg->parseArguments(argc, argv);
 
+	// key the random number streams of the toys, see CounterRng
+	CounterRng::configure(arg->seed, arg->nrun);
+
 	// configure names
 	execname = argv[0];
 	if (arg->filenameaddition!="") name += "_"+arg->filenameaddition;
@@ -335,6 +338,12 @@ void GammaComboEngine::loadStartParameters(MethodProbScan *s, ParameterCache *pC
 		startparfile = startparfile3;
 		filefound = FileExists(startparfile);
 	}
+	// warm start from the minima found by a previous scan of this
+	// combiner, e.g. one made before a measurement was updated
+	if ( ! filefound ){
+		startparfile = m_fnamebuilder->getFileNamePar(s);
+		filefound = FileExists(startparfile);
+	}
 	// still not found
 	if ( ! filefound ){
 		cout << "  No start parameter file was found, will use the default values" << endl;
@@ -345,6 +354,7 @@ void GammaComboEngine::loadStartParameters(MethodProbScan *s, ParameterCache *pC
 		if ( arg->isAsimovCombiner(cId) ){
 			cout << "  3. for Asimov combiners: corresponding non-Asimov start parameter file: " << startparfile3 << endl;
 		}
+		cout << "  " << (arg->isAsimovCombiner(cId)?4:3) << ". parameters of a previous scan: " << m_fnamebuilder->getFileNamePar(s) << endl;
 	}
 	else {
 		cout << "  Loading start parameters from file: " << startparfile << endl;
@@ -801,6 +811,8 @@ void GammaComboEngine::make1dProbScan(MethodProbScan *scanner, int cId)
 	cout <<   "========\n" << endl;
 	scanner->printLocalMinima();
 	scanner->calcCLintervals();
+	// also save in batch jobs, so that further jobs can reuse the scan
+	if ( !arg->isAction("plugin") ) scanner->saveScanner(m_fnamebuilder->getFileNameScanner(scanner));
 	if (!arg->isAction("pluginbatch") && !arg->plotpluginonly){
 		if ( arg->plotpulls ) scanner->plotPulls();
 		if ( arg->parevol ){
@@ -812,7 +824,6 @@ void GammaComboEngine::make1dProbScan(MethodProbScan *scanner, int cId)
 			plotter.plotObsScanCheck();
 		}
 		if (!arg->isAction("plugin")){
-			scanner->saveScanner(m_fnamebuilder->getFileNameScanner(scanner));
 			pCache->cacheParameters(scanner,m_fnamebuilder->getFileNamePar(scanner));
 		}
 	}
@@ -1116,6 +1127,33 @@ bool GammaComboEngine::isScanVarObservable(Combiner *c, TString scanVar)
 	return false;
 }
 
+///
+/// Check if a Prob scan saved by an earlier run can be reused instead
+/// of repeating the scan. This is the case if the scanner file was made
+/// with the same configuration hash, i.e. none of the PDFs, observables,
+/// uncertainties, parameters, ranges, or scan settings have changed,
+/// see MethodAbsScan::computeConfigHash(). Delete the scanner file to
+/// force a new scan. Scans are always repeated if pull or parameter
+/// evolution plots are requested, as these are made during the scan.
+///
+/// \param scanner - the Prob scanner, not yet scanned
+/// \return true if the scanner file can be loaded
+///
+bool GammaComboEngine::reuseProbScan(MethodProbScan *scanner)
+{
+	TString fName = m_fnamebuilder->getFileNameScanner(scanner);
+	if ( arg->plotpulls || arg->parevol ) return false;
+	if ( scanner->isScannerUpToDate(fName) ){
+		cout << "\n" << scanner->getName() << ": configuration unchanged, reusing the Prob scan from " << fName << endl;
+		cout << "Delete this file to force a new scan.\n" << endl;
+		return true;
+	}
+	if ( FileExists(fName) ){
+		cout << "\n" << scanner->getName() << ": configuration changed since the last Prob scan, rescanning.\n" << endl;
+	}
+	return false;
+}
+
 ///
 /// Helper function to set up a scan for an observable, tightens
 /// the chi2 constraint.
@@ -1221,10 +1259,12 @@ void GammaComboEngine::scan()
 			// 1D SCANS
 			if ( arg->var.size()==1 )
 			{
-				if ( arg->isAction("plot") ){
-					scannerProb->loadScanner(m_fnamebuilder->getFileNameScanner(scannerProb));
+				// rescan if a reused file can't be read, see MethodAbsScan::loadScanner()
+				bool loaded = false;
+				if ( arg->isAction("plot") || reuseProbScan(scannerProb) ){
+					loaded = scannerProb->loadScanner(m_fnamebuilder->getFileNameScanner(scannerProb));
 				}
-				else{
+				if ( !loaded ){
 					make1dProbScan(scannerProb, i);
 				}
 				make1dProbPlot(scannerProb, i);
@@ -1232,10 +1272,12 @@ void GammaComboEngine::scan()
 			// 2D SCANS
 			else if ( arg->var.size()==2 )
 			{
-				if ( arg->isAction("plot") ){
-					scannerProb->loadScanner(m_fnamebuilder->getFileNameScanner(scannerProb));
+				// rescan if a reused file can't be read, see MethodAbsScan::loadScanner()
+				bool loaded = false;
+				if ( arg->isAction("plot") || reuseProbScan(scannerProb) ){
+					loaded = scannerProb->loadScanner(m_fnamebuilder->getFileNameScanner(scannerProb));
 				}
-				else{
+				if ( !loaded ){
 					make2dProbScan(scannerProb, i);
 				}
 				make2dProbPlot(scannerProb, i);
@@ -1254,8 +1296,14 @@ void GammaComboEngine::scan()
 			if ( arg->var.size()==1 )
 			{
 				if ( arg->isAction("pluginbatch") ){
+					// load the profile likelihood if it was computed before, e.g. by an earlier job
 					MethodProbScan *scannerProb = new MethodProbScan(c);
-					make1dProbScan(scannerProb, i);
+					if ( reuseProbScan(scannerProb) ){
+						scannerProb->loadScanner(m_fnamebuilder->getFileNameScanner(scannerProb));
+					}
+					else {
+						make1dProbScan(scannerProb, i);
+					}
 					MethodPluginScan *scannerPlugin = new MethodPluginScan(scannerProb);
 					make1dPluginScan(scannerPlugin, i);
 				}
@@ -1278,14 +1326,12 @@ void GammaComboEngine::scan()
 					MethodProbScan *scannerProb = new MethodProbScan(c);
 					if (    !arg->plotpluginonly
 						|| ( arg->plotpluginonly && !arg->isAction("plot") ) ){
-						if ( FileExists(m_fnamebuilder->getFileNameScanner(scannerProb)) ){
-							scannerProb->loadScanner(m_fnamebuilder->getFileNameScanner(scannerProb));
-						}
-						else {
+						if ( !FileExists(m_fnamebuilder->getFileNameScanner(scannerProb))
+							|| !scannerProb->loadScanner(m_fnamebuilder->getFileNameScanner(scannerProb)) ){
 							cout << "\nWARNING : Couldn't load the Prob scanner, will rerun the Prob" << endl;
 							cout <<   "          scan now. You should have run the Prob scan locally" << endl;
 							cout <<   "          before running the Plugin scan." << endl;
-							cout <<   "          missing file: " << m_fnamebuilder->getFileNameScanner(scannerProb) << endl;
+							cout <<   "          missing or outdated file: " << m_fnamebuilder->getFileNameScanner(scannerProb) << endl;
 							cout << endl;
 							make1dProbScan(scannerProb, i);
 						}
@@ -1318,7 +1364,12 @@ void GammaComboEngine::scan()
 			else if ( arg->var.size()==2 ) {
 				if ( arg->isAction("pluginbatch") ){
 					MethodProbScan *scannerProb = new MethodProbScan(c);
-					make2dProbScan(scannerProb, i);
+					if ( reuseProbScan(scannerProb) ){
+						scannerProb->loadScanner(m_fnamebuilder->getFileNameScanner(scannerProb));
+					}
+					else {
+						make2dProbScan(scannerProb, i);
+					}
 					MethodPluginScan *scannerPlugin = new MethodPluginScan(scannerProb);
 					make2dPluginScan(scannerPlugin, i);
 				}
@@ -1326,7 +1377,9 @@ void GammaComboEngine::scan()
 					MethodProbScan *scannerProb = new MethodProbScan(c);
 					if ( ! ( arg->isAction("plot") && arg->plotpluginonly ) ){
 						// we don't need the prob scanner if we just want to replot the plugin only
-						scannerProb->loadScanner(m_fnamebuilder->getFileNameScanner(scannerProb));
+						if ( !scannerProb->loadScanner(m_fnamebuilder->getFileNameScanner(scannerProb)) ){
+							make2dProbScan(scannerProb, i);
+						}
 					}
 					MethodPluginScan *scannerPlugin = new MethodPluginScan(scannerProb);
 					if ( arg->isAction("plot") ){
@@ -0,0 +1,84 @@
+#include "ImproveFitter.h"
+
+///
+/// \param w - workspace holding the PDF
+/// \param name - name of the PDF without leading "pdf_"
+///
+ImproveFitter::ImproveFitter(RooWorkspace *w, TString name)
+{
+	this->w = w;
+	parsName = "par_"+name;
+	RooAbsPdf *pdf = w->pdf("pdf_"+name);
+	if ( !pdf || !w->set(parsName) ){
+		cout << "ImproveFitter::ImproveFitter() : ERROR : PDF or parameters not found: " << name << ". Exit." << endl;
+		exit(1);
+	}
+	llFormula = 0;
+	RooAbsReal *chi2 = findGausChi2Var(pdf);
+	if ( !chi2 ){
+		llFormula = new RooFormulaVar("ll", "ll", "-2*log(@0)", RooArgSet(*pdf));
+		chi2 = llFormula;
+	}
+	fcn = new RooImproveChi2Var("llImprove", "llImprove", *chi2, RooArgList(*w->set(parsName)));
+	session = new MinimizerSession(fcn);
+	session->setPrintLevel(-1);
+}
+
+ImproveFitter::~ImproveFitter()
+{
+	delete session;
+	delete fcn;
+	if ( llFormula ) delete llFormula;
+}
+
+///
+/// Run the three fits of the improve method, see Utils::fitToMinImprove().
+/// The parameters are left at the better minimum.
+///
+/// \return the fit result of the better minimum, the caller takes ownership
+///
+RooFitResult* ImproveFitter::fit()
+{
+	RooMsgService::instance().setGlobalKillBelow(ERROR);
+
+	// step 1: find a minimum to start with
+	fcn->setHeight(0.);
+	session->setErrorLevel(4.0); ///< define 2 sigma errors. This will make the hesse PDF 2 sigma wide!
+	session->setStrategy(1);
+	session->fit();
+	RooFitResult *r1 = session->save();
+
+	// step 2: move the bump onto that minimum and fit the improved fcn
+	if ( !fcn->setMinimum(*r1) ){
+		RooMsgService::instance().setGlobalKillBelow(INFO);
+		return r1;
+	}
+	fcn->setHeight(16.);
+	session->setErrorLevel(1.0);
+	session->fit();
+
+	// step 3: use the result of the improved fit, at which the
+	// parameters now are, as start parameters for the nominal fcn
+	fcn->setHeight(0.);
+	session->fit();
+	RooFitResult *r3 = session->save();
+
+	// step 4: chose better minimum
+	RooFitResult* r = 0;
+	if ( r1->minNll()<r3->minNll() )
+	{
+		delete r3;
+		r = r1;
+	}
+	else
+	{
+		delete r1;
+		r = r3;
+	}
+
+	RooMsgService::instance().setGlobalKillBelow(INFO);
+
+	// set to best parameters
+	setParameters(w, parsName, r);
+	return r;
+}
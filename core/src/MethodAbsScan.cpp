@@ -18,6 +18,9 @@
 	exit(1);
 	methodName = "Abs";
 	drawFilled = true;
+	minimizer = 0;
+	improver = 0;
+	parBinding = 0;
 };
 
 	MethodAbsScan::MethodAbsScan(Combiner *c)
@@ -58,12 +61,17 @@
 	m_xrangeset = false;
 	m_yrangeset = false;
 	m_initialized = false;
+	minimizer = 0;
+	improver = 0;
+	parBinding = 0;
 
 	// check workspace content
 	if ( !w->pdf(pdfName) ) { cout << "MethodAbsScan::MethodAbsScan() : ERROR : not found in workspace : " << pdfName  << endl; exit(1); }
 	if ( !w->set(obsName) ) { cout << "MethodAbsScan::MethodAbsScan() : ERROR : not found in workspace : " << obsName << endl; exit(1); }
 	if ( !w->set(parsName) ){ cout << "MethodAbsScan::MethodAbsScan() : ERROR : not found in workspace : " << parsName << endl; exit(1); }
 	if ( !w->set(thName) )  { cout << "MethodAbsScan::MethodAbsScan() : ERROR : not found in workspace : " << thName << endl; exit(1); }
+
+	configHash = computeConfigHash();
 }
 
 MethodAbsScan::~MethodAbsScan()
@@ -78,6 +86,42 @@ MethodAbsScan::~MethodAbsScan()
 	if ( obsDataset ) delete obsDataset;
 	if ( startPars ) delete startPars;
 	if ( globalMin ) delete globalMin;
+	if ( minimizer ) delete minimizer;
+	if ( improver ) delete improver;
+	if ( parBinding ) delete parBinding;
+}
+
+///
+/// Get the minimizer session shared by all fits of the combined PDF.
+/// It is created on first use, and keeps its RooMinuit object alive
+/// between fits.
+///
+MinimizerSession* MethodAbsScan::getMinimizerSession()
+{
+	if ( !minimizer ) minimizer = new MinimizerSession(w->pdf(pdfName));
+	return minimizer;
+}
+
+///
+/// Get the improve method fitter of the combined PDF. It is created
+/// on first use, and keeps its augmented chi2 and minimizer alive
+/// between fits.
+///
+ImproveFitter* MethodAbsScan::getImproveFitter()
+{
+	if ( !improver ) improver = new ImproveFitter(w, combiner->getPdfName());
+	return improver;
+}
+
+///
+/// Get the binding of the parameters of the combined PDF, used to
+/// move parameter points in and out of the workspace without lookups
+/// by name. It is created on first use.
+///
+ParameterBinding* MethodAbsScan::getParameterBinding()
+{
+	if ( !parBinding ) parBinding = new ParameterBinding(w->set(parsName));
+	return parBinding;
 }
 
 ///
@@ -112,6 +156,7 @@ void MethodAbsScan::doInitialFit(bool force)
 	if ( startPars ) delete startPars;
 	startPars = new RooDataSet("startPars", "startPars", *w->set(parsName));
 	startPars->add(*w->set(parsName));
+	getParameterBinding()->store(startParsValues);
 
 	// load parameter range
 	combiner->loadParameterLimits();
@@ -150,7 +195,7 @@ void MethodAbsScan::doInitialFit(bool force)
 	}
 
 	int quiet = arg->debug ? 1 : -1;
-	RooFitResult* r = fitToMinBringBackAngles(w->pdf(pdfName), true, quiet);
+	RooFitResult* r = fitToMinBringBackAngles(w->pdf(pdfName), true, quiet, getMinimizerSession());
 	// RooFitResult* r = fitToMin(w->pdf(pdfName), true, quiet);
 	if ( arg->debug ) r->Print("v");
 	// globalMin = new RooSlimFitResult(r);
@@ -159,7 +204,7 @@ void MethodAbsScan::doInitialFit(bool force)
 	chi2minGlobalFound = true;
 
 	// reset parameters to their values at function call
-	setParameters(w, parsName, startPars->get(0));
+	getParameterBinding()->load(startParsValues);
 
 	if ( arg->debug ) cout << "============================================================\n" << endl;
 	RooMsgService::instance().setGlobalKillBelow(INFO);
@@ -268,7 +313,12 @@ void MethodAbsScan::initScan()
 
 ///
 /// Save this scanner to a root file placed into plots/scanner.
-/// It contains the 1-CL histograms and the solutions.
+/// It contains the 1-CL histograms, the solutions, the global minimum,
+/// and the fit results along the 1-CL curve. The file is tagged with
+/// a format version and the config hash, see computeConfigHash(), so
+/// that later runs can reuse it, see isScannerUpToDate(). It is written
+/// to a temporary file first and then moved, so that concurrent batch
+/// jobs never read a partially written file.
 ///
 void MethodAbsScan::saveScanner(TString fName)
 {
@@ -277,7 +327,11 @@ void MethodAbsScan::saveScanner(TString fName)
 		fName = fb.getFileNameScanner(this);
 	}
 	if ( arg->debug ) cout << "MethodAbsScan::saveScanner() : saving scanner: " << fName << endl;
-	TFile f(fName, "recreate");
+	TString tmpName = fName+Form(".%i.tmp", gSystem->GetPid());
+	TFile f(tmpName, "recreate");
+	TNamed("version", Form("%i", scannerFileVersion)).Write();
+	TNamed("configHash", configHash).Write();
+	TParameter<double>("chi2minGlobal", chi2minGlobal).Write();
 	// save 1-CL histograms
 	if ( scanVar2!="" ) hCL2d->Write("hCL");
 	else hCL->Write("hCL");
@@ -288,12 +342,112 @@ void MethodAbsScan::saveScanner(TString fName)
 	for ( int i=0; i<solutions.size(); i++ ){
 		f.WriteObject(solutions[i], Form("sol%i",i));
 	}
+	// save the fit results along the curve
+	if ( scanVar2!="" ){
+		for ( int i=0; i<curveResults2d.size(); i++ )
+			for ( int j=0; j<curveResults2d[i].size(); j++ ){
+				if ( curveResults2d[i][j] ) f.WriteObject(curveResults2d[i][j], Form("curve%i_%i",i,j));
+			}
+	}
+	else{
+		for ( int i=0; i<curveResults.size(); i++ ){
+			if ( curveResults[i] ) f.WriteObject(curveResults[i], Form("curve%i",i));
+		}
+	}
+	f.Close();
+	if ( gSystem->Rename(tmpName, fName)!=0 ){
+		cout << "MethodAbsScan::saveScanner() : ERROR : couldn't move " << tmpName << " to " << fName << endl;
+	}
+}
+
+///
+/// Check if a scanner file was written by saveScanner() for the
+/// current configuration, so that it can be loaded instead of
+/// repeating the scan.
+///
+/// \param fName - the file name
+/// \return true if the file exists, has the current format version
+///         and was made with the same config hash
+///
+bool MethodAbsScan::isScannerUpToDate(TString fName)
+{
+	if ( !FileExists(fName) ) return false;
+	TFile f(fName, "ro");
+	TNamed *version = (TNamed*)f.Get("version");
+	TNamed *hash = (TNamed*)f.Get("configHash");
+	bool upToDate = version && hash
+		&& TString(version->GetTitle())==Form("%i", scannerFileVersion)
+		&& TString(hash->GetTitle())==configHash;
+	f.Close();
+	return upToDate;
+}
+
+///
+/// Compute a hash of everything that defines the result of a scan:
+/// the combination, its PDFs with the sources of their observables,
+/// uncertainties and correlations and their covariances, the theory
+/// expressions of the observables, the observables with their values and
+/// ranges, the parameters with their values, ranges, named ranges and
+/// constant flags, and the scan settings including the quick hacks.
+/// Computed in the constructor, before any fit changes the parameters.
+///
+TString MethodAbsScan::computeConfigHash()
+{
+	TString config = Form("scanner version %i\n", scannerFileVersion);
+	config += "combiner "+combiner->getName()+" "+pdfName+"\n";
+	config += "scan "+scanVar1+" "+scanVar2+Form(" %i %i %i %.9g %.9g %.9g %.9g %i %i %i %.9g %i %i\n",
+			nPoints1d, nPoints2dx, nPoints2dy, arg->scanrangeMin, arg->scanrangeMax, arg->scanrangeyMin, arg->scanrangeyMax,
+			arg->probforce, arg->probimprove, arg->scanforce, arg->probadaptive,
+			arg->probadaptive2d, arg->enforcePhysRange);
+	config += "qh";
+	for ( int i=0; i<arg->qh.size(); i++ ) config += Form(" %i", arg->qh[i]);
+	config += "\n";
+	vector<PDF_Abs*>& pdfs = combiner->getPdfs();
+	for ( int i=0; i<pdfs.size(); i++ ){
+		config += "pdf "+pdfs[i]->getName()+" "+pdfs[i]->getObservableSourceString()
+			+" "+pdfs[i]->getErrorSourceString()+" "+pdfs[i]->getCorrelationSourceString();
+		for ( int k=0; k<pdfs[i]->covMatrix.GetNrows(); k++ )
+			for ( int l=0; l<pdfs[i]->covMatrix.GetNcols(); l++ ) config += Form(" %.10g", pdfs[i]->covMatrix[k][l]);
+		config += "\n";
+	}
+	TIterator* it = w->set(obsName)->createIterator();
+	while ( RooRealVar* p = (RooRealVar*)it->Next() ){
+		config += Form("obs %s %.10g %.10g %.10g\n", p->GetName(), p->getVal(), p->getMin(), p->getMax());
+	}
+	delete it;
+	// the theory expressions, printed with their class, servers, and formula
+	it = w->set(thName)->createIterator();
+	while ( RooAbsArg* p = (RooAbsArg*)it->Next() ){
+		ostringstream th;
+		p->printStream(th, RooPrintable::kClassName|RooPrintable::kName|RooPrintable::kArgs, RooPrintable::kSingleLine);
+		config += "th "+TString(th.str())+"\n";
+	}
+	delete it;
+	it = w->set(parsName)->createIterator();
+	while ( RooRealVar* p = (RooRealVar*)it->Next() ){
+		config += Form("par %s %.10g %.10g %.10g %i", p->GetName(), p->getVal(), p->getMin(), p->getMax(), p->isConstant());
+		// the named ranges the fits switch to, see setLimit()
+		const char* ranges[4] = {"scan", "phys", "free", "force"};
+		for ( int i=0; i<4; i++ ){
+			if ( p->hasRange(ranges[i]) ) config += Form(" %s %.10g %.10g", ranges[i], p->getMin(ranges[i]), p->getMax(ranges[i]));
+		}
+		config += "\n";
+	}
+	delete it;
+	TMD5 md5;
+	md5.Update((UChar_t*)config.Data(), config.Length());
+	md5.Final();
+	return md5.AsString();
 }
 
 ///
 /// Save a scanner from plots/scanner.
 /// It contains the 1-CL histograms and the solutions.
 ///
+/// \return false if the file holds fit results written by an older
+///         version, which can't be decoded, see RooSlimFitResult::readVersion1().
+///         The scan has to be repeated then. With '-a plot' this is an error.
+///
 bool MethodAbsScan::loadScanner(TString fName)
 {
 	if ( fName=="" ){
@@ -348,6 +502,44 @@ bool MethodAbsScan::loadScanner(TString fName)
 	if ( f->Get(Form("sol%i",nSol)) ){
 		cout << "MethodAbsScan::loadScanner() : WARNING : Only the first 100 solutions read from: " << fName << endl;
 	}
+	// load the global minimum and the fit results along the curve,
+	// not present in files written by older versions
+	TParameter<double> *chi2min = (TParameter<double>*)f->Get("chi2minGlobal");
+	if ( chi2min ){
+		chi2minGlobal = chi2min->GetVal();
+		chi2minGlobalFound = true;
+	}
+	if ( scanVar2!="" ){
+		curveResults2d.clear();
+		for ( int i=0; i<hCL2d->GetNbinsX(); i++ ){
+			vector<RooSlimFitResult*> tmp;
+			for ( int j=0; j<hCL2d->GetNbinsY(); j++ ) tmp.push_back((RooSlimFitResult*)f->Get(Form("curve%i_%i",i,j)));
+			curveResults2d.push_back(tmp);
+		}
+	}
+	else {
+		curveResults.clear();
+		for ( int i=0; i<hCL->GetNbinsX(); i++ ) curveResults.push_back((RooSlimFitResult*)f->Get(Form("curve%i",i)));
+	}
+	// fit results of an older version are read without schema
+	bool outdated = false;
+	for ( int i=0; i<solutions.size(); i++ ) if ( !solutions[i]->getSchema() ) outdated = true;
+	for ( int i=0; i<curveResults.size(); i++ ) if ( curveResults[i] && !curveResults[i]->getSchema() ) outdated = true;
+	for ( int i=0; i<curveResults2d.size(); i++ )
+		for ( int j=0; j<curveResults2d[i].size(); j++ ) if ( curveResults2d[i][j] && !curveResults2d[i][j]->getSchema() ) outdated = true;
+	if ( outdated && arg->isAction("plot") ){
+		cout << "MethodAbsScan::loadScanner() : ERROR : " << fName << " holds fit results written by an older version," << endl;
+		cout << "                               they can't be read. Run first without the '-a plot' option to redo the scan. Exit." << endl;
+		exit(1);
+	}
+	if ( outdated ){
+		cout << "MethodAbsScan::loadScanner() : WARNING : " << fName << " holds fit results written by an older version," << endl;
+		cout << "                               they can't be read." << endl;
+		solutions.clear();
+		curveResults.clear();
+		curveResults2d.clear();
+		return false;
+	}
 	return true;
 }
 
@@ -889,11 +1081,7 @@ bool MethodAbsScan::loadSolution(int i)
 		cout << "MethodAbsScan::loadSolution() : ERROR : solution ID out of range." << endl;
 		return false;
 	}
-	RooArgSet *tmp = new RooArgSet();
-	tmp->add(solutions[i]->floatParsFinal());
-	tmp->add(solutions[i]->constPars());
-	setParameters(w, parsName, tmp);
-	delete tmp;
+	loadParameters(solutions[i]);
 	return true;
 }
 
@@ -903,11 +1091,9 @@ bool MethodAbsScan::loadSolution(int i)
 void MethodAbsScan::loadParameters(RooSlimFitResult *r)
 {
 	if ( arg->debug ) cout << "MethodAbsScan::loadParameters() : loading a RooSlimFitResult " << endl;
-	RooArgSet *tmp = new RooArgSet();
-	tmp->add(r->floatParsFinal());
-	tmp->add(r->constPars());
-	setParameters(w, parsName, tmp);
-	delete tmp;
+	// don't go through the RooArgLists of floatParsFinal() and constPars(),
+	// they would keep a clone of every parameter alive in each fit result
+	getParameterBinding()->load(r, true);
 }
 
 ///
@@ -1042,7 +1228,7 @@ void MethodAbsScan::confirmSolutions()
 
 		// refit the solution
 		// true uses thorough fit with HESSE, -1 silences output
-		RooFitResult *r = fitToMinBringBackAngles(w->pdf(pdfName), true, -1);
+		RooFitResult *r = fitToMinBringBackAngles(w->pdf(pdfName), true, -1, getMinimizerSession());
 
 		// Check scan parameter shift.
 		// We'll allow for a shift equivalent to 3 step sizes.
@@ -341,7 +341,7 @@ int MethodBergerBoosScan::scan1d(int nRun)
 	TFile *f2 = new TFile(fName, "recreate");
 
 	Fitter *myFit = new Fitter(arg, w, combiner->getPdfName());
-	RooRandom::randomGenerator()->SetSeed(0);
+	CounterRng::seedRooRandom();
 
 	// Set limit to all parameters.
 	combiner->loadParameterLimits();
@@ -606,7 +606,7 @@ void MethodGenericPluginScan::readScan1dTrees(int runMin, int runMax, TString fi
 int MethodGenericPluginScan::scan1d(int nRun)
 {
   // Necessary for parallelization
-  RooRandom::randomGenerator()->SetSeed(0);
+  CounterRng::seedRooRandom();
   // Set limit to all parameters.
   this->loadParameterLimits(); /// Default is "free", if not changed by cmd-line parameter
   if(arg->debug) cout << "DEBUG in MethodGenericPluginScan::scan1d() - limits set" << endl;
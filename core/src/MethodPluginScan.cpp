@@ -7,6 +7,8 @@
 
 #include "MethodPluginScan.h"
 
+const double MethodPluginScan::pruningMargin = 0.2;
+
 ///
 /// Initialize from a previous Prob scan, setting the profile
 /// likelihood. This should be the default.
@@ -28,6 +30,8 @@
 	nPoints1d  = arg->npointstoy;
 	nPoints2dx = arg->npointstoy;
 	nPoints2dy = arg->npointstoy;
+	toyGenerator = 0;
+	checkpoint = 0;
 }
 
 ///
@@ -36,6 +40,8 @@
 ///
 MethodPluginScan::MethodPluginScan(){
 	methodName = "Plugin";
+	toyGenerator = 0;
+	checkpoint = 0;
 };
 
 ///
@@ -58,6 +64,8 @@ MethodPluginScan::MethodPluginScan(){
 	nPoints1d  = arg->npointstoy;
 	nPoints2dx = arg->npointstoy;
 	nPoints2dy = arg->npointstoy;
+	toyGenerator = 0;
+	checkpoint = 0;
 }
 
 ///
@@ -116,19 +124,31 @@ RooSlimFitResult* MethodPluginScan::getParevolPoint(float scanpoint)
 	return parevolPLH->curveResults[iCurveRes];
 }
 
+MethodPluginScan::~MethodPluginScan()
+{
+	if ( toyGenerator ) delete toyGenerator;
+}
+
 ///
-/// Generate toys.
+/// Generate toys at the current parameter values. Toys of the
+/// Gaussian PDFs are drawn directly, only the other PDFs go through
+/// RooFit, see ToyGenerator.
 ///
 /// \param nToys - generate this many toys
+/// \param tailSampling - draw the Gaussian observables from a distribution that
+///         is widened towards the data, and weight the toys, see ToyGenerator::setTailSampling()
+/// \param point - number of the scan point, selects the random number streams
+/// \param firstToy - number of the first toy at this scan point, see CounterRng
+/// \return the generator holding the toys, use ToyGenerator::loadToy()
+///         to set the observables. It is owned by this object and reused
+///         by the next call.
 ///
-RooDataSet* MethodPluginScan::generateToys(int nToys)
+ToyGenerator* MethodPluginScan::generateToys(int nToys, bool tailSampling, int point, int firstToy)
 {
-	RooRandom::randomGenerator()->SetSeed(0);
-	RooMsgService::instance().setStreamStatus(0,kFALSE);
-	RooMsgService::instance().setStreamStatus(1,kFALSE);
-	RooDataSet* dataset = w->pdf(pdfName)->generate(*w->set(obsName), nToys, AutoBinned(false));
-	RooMsgService::instance().setStreamStatus(0,kTRUE);
-	RooMsgService::instance().setStreamStatus(1,kTRUE);
+	if ( !toyGenerator ) toyGenerator = new ToyGenerator(combiner);
+	toyGenerator->setTailSampling(tailSampling ? obsDataset->get(0) : 0);
+	toyGenerator->setStreamKey(point);
+	toyGenerator->generate(nToys, firstToy);
 
 	// Test toy generation - print out the first 10 toys to stdout.
 	// Triggered by --qh 5
@@ -136,67 +156,11 @@ RooDataSet* MethodPluginScan::generateToys(int nToys)
 		if ( w->var("kD_k3pi") ) cout << "kD_k3pi=" << w->var("kD_k3pi")->getVal() << endl;
 		if ( w->var("dD_k3pi") ) cout << "dD_k3pi=" << w->var("dD_k3pi")->getVal() << endl;
 		for ( int j = 0; j<10 && j<nToys; j++ ){
-			const RooArgSet* toyData = dataset->get(j);
-			toyData->Print("v");
-		}
-	}
-
-	// The following code is an embarrasment. Something goes wrong
-	// in RooFit's toy generation when a Th2F PDF is used. We try to
-	// work around it.
-	// Sometimes there is an error from TFoam (the TH2F clearly isn't zero):
-	// Error in <TFoam::MakeActiveList>: Integrand function is zero
-	// Then it proceeds "generating" observables that are, in every toy, set to their boundaries.
-	// This happens only for kD_k3pi_obs.
-	// Workaround: If it happens, flucutate the parameters of the histogram
-	// ever so slightly and regenerate.
-
-	// read the generated values for one variable from the
-	// first two toys
-	bool hasK3pi = false;
-	float generatedValues[2];
-	for ( int i=0; i<2; i++ ){
-		const RooArgSet* toyData = dataset->get(i);
-		TIterator* it = toyData->createIterator();
-		while(RooRealVar* var = (RooRealVar*)it->Next()){
-			if ( TString(var->GetName()).Contains("kD_k3pi_obs") ){
-				hasK3pi = true;
-				generatedValues[i] = var->getVal();
-				continue;
-			}
+			toyGenerator->print(j);
 		}
-		delete it;
 	}
 
-	// check if they are the same, if so, fluctuate and regenerate
-	if ( hasK3pi && generatedValues[0]==generatedValues[1] ){
-		delete dataset;
-		cout << "kD_k3pi_obs GENERATION ERROR AT kD_k3pi=" << w->var("kD_k3pi")->getVal()
-			<< " dD_k3pi=" << w->var("dD_k3pi")->getVal() << endl;
-		TRandom3 r;
-		w->var("kD_k3pi")->setVal(r.Gaus(w->var("kD_k3pi")->getVal(),0.05));
-		w->var("dD_k3pi")->setVal(r.Gaus(w->var("dD_k3pi")->getVal(),0.05));
-		cout << "kD_k3pi_obs SECOND GENERATION AT kD_k3pi=" << w->var("kD_k3pi")->getVal()
-			<< " dD_k3pi=" << w->var("dD_k3pi")->getVal() << endl;
-		RooMsgService::instance().setStreamStatus(0,kFALSE);
-		RooMsgService::instance().setStreamStatus(1,kFALSE);
-		dataset = w->pdf(pdfName)->generate(*w->set(obsName), nToys, AutoBinned(false));
-		RooMsgService::instance().setStreamStatus(0,kTRUE);
-		RooMsgService::instance().setStreamStatus(1,kTRUE);		for ( int i=0; i<2; i++ ){
-			const RooArgSet* toyData = dataset->get(i);
-			TIterator* it = toyData->createIterator();
-			while(RooRealVar* var = (RooRealVar*)it->Next()){
-				if ( TString(var->GetName()).Contains("kD_k3pi_obs") ){
-					generatedValues[i] = var->getVal();
-					continue;
-				}
-			}
-			delete it;
-		}
-		cout << "kD_k3pi_obs NEW VALUES : toy 0: " << generatedValues[0] << " toy 1: " << generatedValues[1] << endl;
-	}
-
-	return dataset;
+	return toyGenerator;
 }
 
 ///
@@ -221,16 +185,20 @@ RooDataSet* MethodPluginScan::generateToys(int nToys)
 ///                 getPvalue1d(). E.g. in the coverage tests, we need to
 ///                 run many times for different toy data sets that replace
 ///                 the nominal "data". The ToyTree also contains a 'run' branch
-///                 that holds the run number (=batch job).
+///                 that holds the run number (=batch job). The id and the
+///                 run number also select the random number streams of
+///                 the toys, see CounterRng.
 /// \param f        A fitter object. If not given, a new one will be created.
 ///                 It may be useful to use an external fitter so that the
 ///                 fitter object can compute some fit statistics for an entire
 ///                 1-CL scan.
 /// \param pb       A progress bar object used to print nice progress output.
+/// \param firstToy Number of toys of this point that are already in the tree,
+///                 the last entries. Used to continue a resumed job.
 /// \return         the p-value.
 ///
 void MethodPluginScan::computePvalue1d(RooSlimFitResult* plhScan, double chi2minGlobal, ToyTree* t, int id,
-		Fitter* f, ProgressBar *pb)
+		Fitter* f, ProgressBar *pb, int firstToy)
 {
 	// Check inputs.
 	assert(plhScan);
@@ -245,13 +213,13 @@ void MethodPluginScan::computePvalue1d(RooSlimFitResult* plhScan, double chi2min
 	// Save parameter values that were active at function
 	// call. We'll reset them at the end to be transparent
 	// to the outside.
-	FitResultCache frCache(arg);
+	FitResultCache frCache(arg, 4, getParameterBinding());
 	frCache.storeParsAtFunctionCall(w->set(parsName));
 	frCache.initRoundRobinDB(w->set(parsName));
 
 	// Set nuisances. This is the point in parameter space where
 	// the toys need to be generated.
-	setParameters(w, parsName, plhScan, true);
+	getParameterBinding()->load(plhScan, true);
 
 	// save nuisances for start parameters
 	frCache.storeParsAtGlobalMin(w->set(parsName));
@@ -269,71 +237,370 @@ void MethodPluginScan::computePvalue1d(RooSlimFitResult* plhScan, double chi2min
 	t->chi2min = plhScan->minNll();
 	t->chi2minGlobal = chi2minGlobal;
 
-	// Importance sampling
+	// Tail sampling: far in the tail hardly any toy has a better test
+	// statistic than the data. Draw the toys from a distribution that is
+	// widened towards the data, and weight them, see ToyGenerator.
+	bool tailSampling = arg->tailsampling;
+
+	// Importance sampling. With tail sampling, the toys are
+	// as often better as for a p-value of the proposal distribution.
 	int nActualToys = nToys;
 	if ( arg->importance ){
 		float plhPvalue = TMath::Prob(t->chi2min - t->chi2minGlobal,1);
+		if ( tailSampling ){
+			if ( !toyGenerator ) toyGenerator = new ToyGenerator(combiner);
+			toyGenerator->setTailSampling(obsDataset->get(0));
+			toyGenerator->updateProposal();
+			plhPvalue = toyGenerator->getProposalPvalue(t->chi2min - t->chi2minGlobal);
+		}
 		nActualToys = nToys*importance(plhPvalue);
 		pb->skipSteps(nToys-nActualToys);
 	}
 
-	// Draw all toy datasets in advance. This is much faster.
-	RooDataSet *toyDataSet = generateToys(nActualToys);
+	// Free fit pruning (--pruning)
+	bool pruning = arg->pruning && isPruningPossible();
 
-	for ( int j = 0; j<nActualToys; j++ )
+	// the second fit policy learns anew at each scan point (--fitpolicy)
+	f->resetPolicyStats();
+
+	// Draw all toy datasets in advance. This is much faster.
+	// In adaptive mode (--adaptive), draw and fit them in rounds,
+	// and stop as soon as the p-value is known well enough. When
+	// checkpointing, use rounds too, so that the job can stop
+	// between them. With tail sampling, use rounds to be able to fall
+	// back to plain toys.
+	int nRoundToys = nActualToys;
+	if ( arg->adaptive>0 || checkpoint || tailSampling ) nRoundToys = TMath::Max(10, nToys/10);
+	PValueAccumulator acc;
+	int nDone = firstToy;
+	pb->skipSteps(firstToy);
+	if ( firstToy>0 && arg->adaptive>0 ){
+		Long64_t nEntries = t->getTree()->GetEntries();
+		for ( Long64_t k=nEntries-firstToy; k<nEntries; k++ ){
+			t->getTree()->GetEntry(k);
+			countToy(t, &acc);
+		}
+	}
+	bool stopped = false;
+	while ( nDone<nActualToys )
 	{
-		// status bar
-		pb->progress();
-
-		//
-		// 1. Generate toys
-		//    (or select the right one)
-		//
-		const RooArgSet* toyData = toyDataSet->get(j);
-		setParameters(w, obsName, toyData);
-		t->storeObservables();
-
-		//
-		// 2. scan fit
-		//
-		par->setVal(scanpoint);
-		par->setConstant(true);
-		f->setStartparsFirstFit(frCache.getRoundRobinNminus(0));
-		f->setStartparsSecondFit(frCache.getParsAtGlobalMin());
-		f->fit();
-		if ( f->getStatus()==1 ){
-			f->setStartparsFirstFit(frCache.getRoundRobinNminus(1));
-			f->setStartparsSecondFit(frCache.getRoundRobinNminus(2));
-			f->fit();
+		int nRound = TMath::Min(nRoundToys, nActualToys-nDone);
+		frCache.restoreParsAtGlobalMin();
+		ToyGenerator *toys = generateToys(nRound, tailSampling, id, nDone);
+
+		if ( arg->nthreads>0 ){
+			fitToysParallel(toys, scanpoint, t, frCache.getParsAtGlobalMin(), pb, &acc, pruning);
 		}
-		t->chi2minToy = f->getChi2();
-		t->statusScan = f->getStatus();
-		t->storeParsScan();
-
-		//
-		// 3. free fit
-		//
-		par->setConstant(false);
-		f->fit();
-		if ( f->getStatus()==1 ){
-			f->fit();
+		else {
+			// the same blocks as the parallel workers, so that the
+			// result doesn't depend on --nthreads
+			vector<double> errorsAtStart;
+			getParameterBinding()->storeErrors(errorsAtStart);
+			for ( int j = 0; j<nRound; j++ )
+			{
+				// status bar
+				pb->progress();
+				if ( j%nToysPerBlock==0 ) startToyBlock(&frCache, errorsAtStart);
+				fitToy(toys, j, scanpoint, t, f, &frCache, pruning);
+				t->fill();
+				countToy(t, &acc);
+			}
 		}
-		t->chi2minGlobalToy = f->getChi2();
-		t->statusFree = f->getStatus();
-		t->scanbest = ((RooRealVar*)w->set(parsName)->find(scanVar1))->getVal();
+		nDone += nRound;
+		// the weights of the tail sampling leave too few effective toys,
+		// e.g. because the data isn't where the proposal expects it
+		if ( tailSampling && acc.getNall(scanpoint)>=10 && acc.getNeff(scanpoint)<0.1*acc.getNall(scanpoint) ){
+			cout << "MethodPluginScan::computePvalue1d() : WARNING : scan point " << scanpoint
+				<< ": only " << acc.getNeff(scanpoint) << " effective toys, switching tail sampling off." << endl;
+			tailSampling = false;
+		}
+		if ( arg->adaptive>0 && isPvalueSettled(&acc, scanpoint) ) break;
+		if ( checkpoint && nDone<nActualToys && checkpoint->update(t, id, nDone) ){
+			stopped = true;
+			break;
+		}
+	}
+	if ( !stopped ) pb->skipSteps(nActualToys-nDone);
+	if ( arg->adaptive>0 && arg->verbose ){
+		cout << "MethodPluginScan::computePvalue1d() : scan point " << scanpoint
+			<< ": fitted " << nDone << " of " << nActualToys << " toys" << endl;
+	}
+
+	// clean up
+	frCache.restoreParsAtFunctionCall();
+	setParameters(w, obsName, obsDataset->get(0));
+}
+
+///
+/// Helper function for computePvalue1d(). Fits one toy: loads the
+/// toy observables, performs the scan fit and the free fit, and
+/// stores all results into the proxy variables of the ToyTree. The
+/// ToyTree is not filled.
+///
+/// \param toys      the pregenerated toys
+/// \param j         number of the toy to be fitted
+/// \param scanpoint value of the scan parameter
+/// \param t         ToyTree receiving the results
+/// \param f         fitter to be used
+/// \param frCache   provides the start parameters; successful free
+///                  fits are added to its round robin database. Must
+///                  be bound to getParameterBinding().
+/// \param pruning   skip the free fit if the toy can't be better than
+///                  the data, see isPruningPossible()
+///
+void MethodPluginScan::fitToy(ToyGenerator* toys, int j, float scanpoint, ToyTree* t, Fitter* f, FitResultCache* frCache,
+		bool pruning)
+{
+	RooRealVar *par = w->var(scanVar1);
+
+	//
+	// 1. Generate toys
+	//    (or select the right one)
+	//
+	toys->loadToy(j);
+	t->logWeight = toys->getLogWeight(j);
+	t->storeObservables();
+
+	//
+	// 2. scan fit
+	//
+	par->setVal(scanpoint);
+	par->setConstant(true);
+	f->setStartparsFirstFit(frCache->getValuesRoundRobinNminus(0));
+	f->setStartparsSecondFit(frCache->getValuesAtGlobalMin());
+	f->fit();
+	if ( f->getStatus()==1 ){
+		f->setStartparsFirstFit(frCache->getValuesRoundRobinNminus(1));
+		f->setStartparsSecondFit(frCache->getValuesRoundRobinNminus(2));
+		f->fit();
+	}
+	t->chi2minToy = f->getChi2();
+	t->statusScan = f->getStatus();
+	t->storeParsScan();
+
+	//
+	// 3. free fit
+	//
+	// The free fit chi2 is at least 0, so the test statistic of the toy is
+	// at most its scan fit chi2. If that is clearly below the test statistic
+	// of the data, the toy can't be better: skip the free fit, and store the
+	// bound. The margin covers a global minimum that moves a little when the
+	// toys are analysed, see accumulateToys(). Whether the free fit would have
+	// been physical is not known, so pruned toys are counted apart, see
+	// PValueAccumulator::addPrunedToy().
+	t->pruned = 0.;
+	if ( pruning && t->statusScan==0 && t->chi2minToy<=t->chi2min-t->chi2minGlobal-pruningMargin ){
+		t->pruned = 1.;
+		t->chi2minGlobalToy = 0.;
+		t->statusFree = 0.;
+		t->scanbest = scanpoint;
 		t->storeParsFree();
+		return;
+	}
+	par->setConstant(false);
+	f->fit();
+	if ( f->getStatus()==1 ){
+		f->fit();
+	}
+	t->chi2minGlobalToy = f->getChi2();
+	t->statusFree = f->getStatus();
+	t->scanbest = par->getVal();
+	t->storeParsFree();
+
+	//
+	// 4. store
+	//
+	if ( t->statusFree==0 ) frCache->storeParsRoundRobin(w->set(parsName));
+}
+
+///
+/// Helper function for computePvalue1d(). Fits all toys of one scan
+/// point using --nthreads parallel workers, then fills the results
+/// into the ToyTree in the order of the toys.
+///
+/// RooMinuit keeps its fitter in a static data member, so two fits can't
+/// run in the same process at the same time. The workers therefore are
+/// forked processes. Each one gets a private copy of the workspace, and
+/// creates its own Fitter and FitResultCache. The results are passed back
+/// to the parent through temporary files.
+///
+/// The toys are processed in blocks of a fixed size, see startToyBlock(),
+/// which are handed out to the workers. This way each toy sees the same
+/// start parameters independent of the number of workers, and the
+/// resulting ToyTree is identical for any value of --nthreads, including
+/// the serial fits of computePvalue1d(). The workers report each finished
+/// block through a pipe, so that the progress bar keeps moving.
+///
+/// \param toys            the pregenerated toys
+/// \param scanpoint       value of the scan parameter
+/// \param t               ToyTree receiving the results
+/// \param parsAtGlobalMin start parameters of each block
+/// \param pb              progress bar
+/// \param acc             if given, the toys are also counted into it
+/// \param pruning         skip free fits, see fitToy()
+///
+void MethodPluginScan::fitToysParallel(ToyGenerator* toys, float scanpoint, ToyTree* t,
+		const RooArgSet* parsAtGlobalMin, ProgressBar* pb, PValueAccumulator* acc, bool pruning)
+{
+	int nActualToys = toys->getNtoys();
+	int nBlocks = (nActualToys+nToysPerBlock-1)/nToysPerBlock;
+	int nWorkers = TMath::Min(arg->nthreads, nBlocks);
+
+	// the size of one tree entry
+	vector<double> values;
+	t->getProxyValues(values);
+	int nValues = values.size();
+
+	// the parameter errors at the start of each block
+	vector<double> errorsAtStart;
+	getParameterBinding()->storeErrors(errorsAtStart);
+
+	// the workers write the number of toys of each finished block
+	int progressPipe[2];
+	if ( pipe(progressPipe)!=0 ){
+		cout << "MethodPluginScan::fitToysParallel() : ERROR : couldn't create pipe. Exit." << endl;
+		exit(1);
+	}
+
+	// start the workers
+	vector<FILE*> buffers;
+	vector<pid_t> pids;
+	cout.flush();
+	fflush(stdout);
+	for ( int iWorker=0; iWorker<nWorkers; iWorker++ )
+	{
+		FILE *buffer = tmpfile();
+		if ( !buffer ){
+			cout << "MethodPluginScan::fitToysParallel() : ERROR : couldn't create temporary file. Exit." << endl;
+			exit(1);
+		}
+		pid_t pid = fork();
+		if ( pid<0 ){
+			cout << "MethodPluginScan::fitToysParallel() : ERROR : couldn't start worker " << iWorker << ". Exit." << endl;
+			exit(1);
+		}
+		if ( pid==0 ){
+			// worker process
+			isWorkerProcess = true;
+			close(progressPipe[0]);
+			Fitter *f = new Fitter(arg, w, combiner->getPdfName(), getParameterBinding());
+			for ( int iBlock=iWorker; iBlock<nBlocks; iBlock+=nWorkers ){
+				FitResultCache frCache(arg, 4, getParameterBinding());
+				frCache.storeParsAtGlobalMin(parsAtGlobalMin);
+				startToyBlock(&frCache, errorsAtStart);
+				int nBlockToys = 0;
+				for ( int j=iBlock*nToysPerBlock; j<(iBlock+1)*nToysPerBlock && j<nActualToys; j++ ){
+					fitToy(toys, j, scanpoint, t, f, &frCache, pruning);
+					t->getProxyValues(values);
+					fwrite(&j, sizeof(int), 1, buffer);
+					fwrite(&values[0], sizeof(double), nValues, buffer);
+					nBlockToys++;
+				}
+				if ( write(progressPipe[1], &nBlockToys, sizeof(int))!=sizeof(int) ){
+					cout << "MethodPluginScan::fitToysParallel() : WARNING : worker " << iWorker << " couldn't report progress." << endl;
+				}
+			}
+			close(progressPipe[1]);
+			fclose(buffer);
+			cout.flush();
+			fflush(stdout);
+			_exit(0); // don't run any ROOT cleanup in the worker
+		}
+		buffers.push_back(buffer);
+		pids.push_back(pid);
+	}
+
+	// follow the progress until all workers have closed the pipe
+	close(progressPipe[1]);
+	int nBlockToys;
+	while ( read(progressPipe[0], &nBlockToys, sizeof(int))==sizeof(int) ){
+		for ( int k=0; k<nBlockToys; k++ ) pb->progress();
+	}
+	close(progressPipe[0]);
+
+	// collect the results
+	vector<vector<double> > results(nActualToys);
+	for ( int iWorker=0; iWorker<nWorkers; iWorker++ )
+	{
+		int status;
+		waitpid(pids[iWorker], &status, 0);
+		if ( !WIFEXITED(status) || WEXITSTATUS(status)!=0 ){
+			cout << "MethodPluginScan::fitToysParallel() : ERROR : worker " << iWorker << " failed. Exit." << endl;
+			exit(1);
+		}
+		rewind(buffers[iWorker]);
+		int j;
+		while ( fread(&j, sizeof(int), 1, buffers[iWorker])==1 ){
+			results[j].resize(nValues);
+			if ( fread(&results[j][0], sizeof(double), nValues, buffers[iWorker])!=nValues ){
+				cout << "MethodPluginScan::fitToysParallel() : ERROR : incomplete result of worker " << iWorker << ". Exit." << endl;
+				exit(1);
+			}
+		}
+		fclose(buffers[iWorker]);
+	}
 
-		//
-		// 4. store
-		//
-		if ( t->statusFree==0 ) frCache.storeParsRoundRobin(w->set(parsName));
+	// fill the tree in toy order
+	for ( int j=0; j<nActualToys; j++ )
+	{
+		if ( results[j].size()!=nValues ){
+			cout << "MethodPluginScan::fitToysParallel() : ERROR : result of toy " << j << " is missing. Exit." << endl;
+			exit(1);
+		}
+		t->setProxyValues(results[j]);
 		t->fill();
+		if ( acc ) countToy(t, acc);
 	}
+}
 
-	// clean up
-	setParameters(w, parsName, frCache.getParsAtFunctionCall());
-	setParameters(w, obsName, obsDataset->get(0));
-	delete toyDataSet;
+///
+/// Helper function for computePvalue1d() and fitToysParallel(). Starts
+/// a block of toys: the round robin database of start parameters starts
+/// from the global minimum, and the parameter errors, which set the
+/// initial step sizes of Minuit, from their values before the first block.
+///
+/// \param frCache       holds the parameters at the global minimum
+/// \param errorsAtStart the parameter errors before the first block
+///
+void MethodPluginScan::startToyBlock(FitResultCache* frCache, const vector<double>& errorsAtStart)
+{
+	frCache->initRoundRobinDB(frCache->getParsAtGlobalMin());
+	frCache->restoreParsAtGlobalMin();
+	getParameterBinding()->loadErrors(errorsAtStart);
+}
+
+///
+/// Helper function for computePvalue1d(). Checks if the free fits
+/// of the toys can be pruned (--pruning). This needs a lower bound of
+/// the free fit chi2: the native chi2 of a combination of Gaussian
+/// PDFs is a sum of squares, so it can't be negative. Cross correlation
+/// terms on their own can be negative. With --intprob, the data test
+/// statistic is taken from elsewhere when analysing the toys, so the
+/// decision taken here could be wrong. Warns only once.
+///
+bool MethodPluginScan::isPruningPossible()
+{
+	static bool warned = false;
+	TString reason = "";
+	RooGausChi2Var *chi2 = (RooGausChi2Var*)findGausChi2Var(w->pdf(pdfName));
+	if ( arg->intprob ) reason = "can't be used with --intprob";
+	else if ( !chi2 || chi2->getNcrossCorPdfs()>0 ) reason = "needs a combination of Gaussian PDFs without cross correlations";
+	if ( reason=="" ) return true;
+	if ( !warned ) cout << "MethodPluginScan::isPruningPossible() : WARNING : --pruning " << reason << ", ignoring it." << endl;
+	warned = true;
+	return false;
+}
+
+///
+/// Helper function for computePvalue1d(). Counts the toy currently
+/// held by the ToyTree into a p-value accumulator, applying the same
+/// quality cuts as accumulateToys().
+///
+void MethodPluginScan::countToy(ToyTree* t, PValueAccumulator* acc)
+{
+	acc->nEntries++;
+	if ( !applyToyCuts(t, acc, true) ) return;
+	countSelectedToy(t, acc);
 }
 
 double MethodPluginScan::getPvalue1d(RooSlimFitResult* plhScan, double chi2minGlobal, ToyTree* t, int id)
@@ -351,7 +618,7 @@ double MethodPluginScan::getPvalue1d(RooSlimFitResult* plhScan, double chi2minGl
 	}
 
 	// Create a fitter
-	Fitter *myFit = new Fitter(arg, w, combiner->getPdfName());
+	Fitter *myFit = new Fitter(arg, w, combiner->getPdfName(), getParameterBinding());
 
 	// Create a progress bar
 	ProgressBar *myPb = new ProgressBar(arg, nToys);
@@ -385,13 +652,13 @@ double MethodPluginScan::getPvalue1d(RooSlimFitResult* plhScan, double chi2minGl
 /// If option --lightfiles is given, the tree will only contain the essentials (min Chi2).
 /// If a combined PDF for the toy generation is given by setParevolPLH(), this
 /// will be used to generate the toys.
+/// The tree is checkpointed and the scan can be resumed, see ScanCheckpoint.
 ///
 /// \param nRun Part of the root tree file name to facilitate parallel production.
 ///
 int MethodPluginScan::scan1d(int nRun)
 {
-	Fitter *myFit = new Fitter(arg, w, combiner->getPdfName());
-	RooRandom::randomGenerator()->SetSeed(0);
+	Fitter *myFit = new Fitter(arg, w, combiner->getPdfName(), getParameterBinding());
 
 	// Set limit to all parameters.
 	combiner->loadParameterLimits();
@@ -422,17 +689,31 @@ int MethodPluginScan::scan1d(int nRun)
 	// Save parameter values that were active at function
 	// call. We'll reset them at the end to be transparent
 	// to the outside.
-	FitResultCache frCache(arg);
+	FitResultCache frCache(arg, 4, getParameterBinding());
 	frCache.storeParsAtFunctionCall(w->set(parsName));
 
 	// for the progress bar: if more than 100 steps, show 50 status messages.
 	int allSteps = nPoints1d*nToys;
 	ProgressBar *pb = new ProgressBar(arg, allSteps);
 
+	// continue a previous job (--resume)
+	TString dirname = "root/scan1dPlugin_"+name+"_"+scanVar1;
+	system("mkdir -p "+dirname);
+	ScanCheckpoint cp(arg, Form(dirname+"/scan1dPlugin_"+name+"_"+scanVar1+"_run%i.root", nRun));
+	if ( arg->resume && !cp.resume(&t) ){
+		delete myFit;
+		delete pb;
+		return 0;
+	}
+	int iFirst = cp.getPoint();
+	int iFirstToy = cp.getToy();
+	pb->skipSteps(iFirst*nToys);
+	if ( arg->checkpoint>0 || arg->walltime>0 ) checkpoint = &cp;
+
 	// start scan
 	if ( arg->debug ) cout << "MethodPluginScan::scan1d() : ";
 	cout << "PLUGIN scan starting ..." << endl;
-	for ( int i=0; i<nPoints1d; i++ )
+	for ( int i=iFirst; i<nPoints1d; i++ )
 	{
 		float scanpoint = min + (max-min)*(double)i/(double)nPoints1d + hCL->GetBinWidth(1)/2.;
 		t.scanpoint = scanpoint;
@@ -445,17 +726,19 @@ int MethodPluginScan::scan1d(int nRun)
 		RooSlimFitResult* plhScan = getParevolPoint(scanpoint);
 
 		// do the work
-		computePvalue1d(plhScan, profileLH->getChi2minGlobal(), &t, i, myFit, pb);
+		computePvalue1d(plhScan, profileLH->getChi2minGlobal(), &t, i, myFit, pb, i==iFirst ? iFirstToy : 0);
 
 		// reset
-		setParameters(w, parsName, frCache.getParsAtFunctionCall());
+		frCache.restoreParsAtFunctionCall();
 		setParameters(w, obsName, obsDataset->get(0));
+
+		// checkpoint, and stop if out of time
+		if ( cp.isStopped() || cp.update(&t, i+1, 0) ) break;
 	}
+	checkpoint = 0;
 
-	if ( arg->debug ) myFit->print();
-	TString dirname = "root/scan1dPlugin_"+name+"_"+scanVar1;
-	system("mkdir -p "+dirname);
-	t.writeToFile(Form(dirname+"/scan1dPlugin_"+name+"_"+scanVar1+"_run%i.root", nRun));
+	if ( arg->debug || arg->fitpolicy=="adaptive" ) myFit->print();
+	if ( !cp.isStopped() ) cp.writeFinal(&t);
 	delete myFit;
 	delete pb;
 	return 0;
@@ -464,12 +747,11 @@ int MethodPluginScan::scan1d(int nRun)
 ///
 /// Perform the 2d Plugin scan.
 /// Saves chi2 values in a root tree, together with the full fit result for each toy.
+/// The tree is checkpointed and the scan can be resumed, see ScanCheckpoint.
 /// \param nRun Part of the root tree file name to facilitate parallel production.
 ///
 void MethodPluginScan::scan2d(int nRun)
 {
-	RooRandom::randomGenerator()->SetSeed(0);
-
 	// Set limit to all parameters.
 	combiner->loadParameterLimits();
 
@@ -504,13 +786,26 @@ void MethodPluginScan::scan2d(int nRun)
 	// Save parameter values that were active at function
 	// call. We'll reset them at the end to be transparent
 	// to the outside.
-	FitResultCache frCache(arg);
+	FitResultCache frCache(arg, 4, getParameterBinding());
 	frCache.storeParsAtFunctionCall(w->set(parsName));
 
 	// for the status bar
 	int allSteps = nPoints2dx*nPoints2dy*nToys;
 	ProgressBar *pb = new ProgressBar(arg, allSteps);
 
+	// continue a previous job (--resume). The scan points are
+	// numbered i1*nPoints2dy+i2.
+	TString dirname = "root/scan2dPlugin_"+name+"_"+scanVar1+"_"+scanVar2;
+	system("mkdir -p "+dirname);
+	ScanCheckpoint cp(arg, Form(dirname+"/scan2dPlugin_"+name+"_"+scanVar1+"_"+scanVar2+"_run%i.root", nRun));
+	if ( arg->resume && !cp.resume(&t) ){
+		delete pb;
+		return;
+	}
+	int iFirst = cp.getPoint();
+	int iFirstToy = cp.getToy();
+	pb->skipSteps(iFirst*nToys+iFirstToy);
+
 	// limit number of warnings
 	int nWarnExtPointDiffer = 0;
 	int nWarnExtPointDifferMax = 10;
@@ -521,9 +816,12 @@ void MethodPluginScan::scan2d(int nRun)
 
 	// start scan
 	cout << "MethodPluginScan::scan2d() : starting ..." << endl;
-	for ( int i1=0; i1<nPoints2dx; i1++ ) {
-		for ( int i2=0; i2<nPoints2dy; i2++ )
+	for ( int i1=0; i1<nPoints2dx && !cp.isStopped(); i1++ ) {
+		for ( int i2=0; i2<nPoints2dy && !cp.isStopped(); i2++ )
 		{
+			int id = i1*nPoints2dy+i2;
+			if ( id<iFirst ) continue;
+			int firstToy = id==iFirst ? iFirstToy : 0;
 			float scanpoint1 = min1 + (max1-min1)*(double)i1/(double)nPoints2dx + hCL2d->GetXaxis()->GetBinWidth(1)/2.;
 			float scanpoint2 = min2 + (max2-min2)*(double)i2/(double)nPoints2dy + hCL2d->GetYaxis()->GetBinWidth(1)/2.;
 			t.scanpoint = scanpoint1;
@@ -538,7 +836,6 @@ void MethodPluginScan::scan2d(int nRun)
 
 			// Get nuisances. This is the point in parameter space where
 			// the toys need to be generated.
-			RooArgList *extCurveResult = 0;
 			{
 				int iCurveRes1 = profileLH->getHCL2d()->GetXaxis()->FindBin(scanpoint1)-1;
 				int iCurveRes2 = profileLH->getHCL2d()->GetYaxis()->FindBin(scanpoint2)-1;
@@ -551,26 +848,24 @@ void MethodPluginScan::scan2d(int nRun)
 						printf("MethodPluginScan::scan2d() : loading start parameters from external 1-CL curve: "
 								"id=[%i,%i], val=[%f,%f]\n", iCurveRes1, iCurveRes2, scanpoint1, scanpoint2);
 					}
-					extCurveResult = new RooArgList(profileLH->curveResults2d[iCurveRes1][iCurveRes2]->floatParsFinal());
-					setParameters(w, parsName, extCurveResult);
-					t.chi2min = profileLH->curveResults2d[iCurveRes1][iCurveRes2]->minNll();
+					RooSlimFitResult *extCurveResult = profileLH->curveResults2d[iCurveRes1][iCurveRes2];
+					getParameterBinding()->load(extCurveResult);
+					t.chi2min = extCurveResult->minNll();
 
 					// check if the scan variable here differs from that of
 					// the external curve
-					RooArgList list = profileLH->curveResults2d[iCurveRes1][iCurveRes2]->floatParsFinal();
-					list.add(profileLH->curveResults2d[iCurveRes1][iCurveRes2]->constPars());
-					RooRealVar* var1 = (RooRealVar*)list.find(scanVar1);
-					RooRealVar* var2 = (RooRealVar*)list.find(scanVar2);
-					if ( var1 && var2 ) {
+					if ( extCurveResult->hasParameter(scanVar1) && extCurveResult->hasParameter(scanVar2) ) {
+						float var1 = extCurveResult->getParVal(scanVar1);
+						float var2 = extCurveResult->getParVal(scanVar2);
 						// print warnings
-						if ( fabs((scanpoint1-var1->getVal())/scanpoint1) > 0.01 || fabs((scanpoint2-var2->getVal())/scanpoint2) > 0.01 ) {
+						if ( fabs((scanpoint1-var1)/scanpoint1) > 0.01 || fabs((scanpoint2-var2)/scanpoint2) > 0.01 ) {
 								if ( nWarnExtPointDiffer<nWarnExtPointDifferMax || arg->debug ) {
-										if ( fabs((scanpoint1-var1->getVal())/scanpoint1) > 0.01 )
+										if ( fabs((scanpoint1-var1)/scanpoint1) > 0.01 )
 												cout << "MethodPluginScan::scan2d() : WARNING : scanpoint1 and external point differ by more than 1%: "
-																					  << "scanpoint1=" << scanpoint1 << " var1=" << var1->getVal() << endl;
-										if ( fabs((scanpoint2-var2->getVal())/scanpoint2) > 0.01 )
+																					  << "scanpoint1=" << scanpoint1 << " var1=" << var1 << endl;
+										if ( fabs((scanpoint2-var2)/scanpoint2) > 0.01 )
 												cout << "MethodPluginScan::scan2d() : WARNING : scanpoint2 and external point differ by more than 1%: "
-																					  << "scanpoint2=" << scanpoint2 << " var2=" << var2->getVal() << endl;
+																					  << "scanpoint2=" << scanpoint2 << " var2=" << var2 << endl;
 								}
 								if ( nWarnExtPointDiffer==0 ) {
 										cout << endl;
@@ -588,7 +883,7 @@ void MethodPluginScan::scan2d(int nRun)
 						cout << "MethodPluginScan::scan2d() : WARNING : variable 1 or 2 not found"
 										      ", var1=" << scanVar1 << ", var2=" << scanVar1 << endl;
 						cout << "MethodPluginScan::scan2d() : Printout follows:" << endl;
-						profileLH->curveResults2d[iCurveRes1][iCurveRes2]->Print();
+						extCurveResult->Print();
 						exit(1);
 					}
 				}
@@ -605,9 +900,9 @@ void MethodPluginScan::scan2d(int nRun)
 			t.storeTheory();
 
 			// Draw toy datasets in advance. This is much faster.
-			RooDataSet *toyDataSet = generateToys(nToys);
+			ToyGenerator *toys = generateToys(nToys-firstToy, false, id, firstToy);
 
-			for ( int j=0; j<nToys; j++ )
+			for ( int j=0; j<nToys-firstToy; j++ )
 			{
 				// status bar
 				pb->progress();
@@ -615,8 +910,7 @@ void MethodPluginScan::scan2d(int nRun)
 				//
 				// 1. Load toy dataset
 				//
-				const RooArgSet* toyData = toyDataSet->get(j);
-				setParameters(w, obsName, toyData);
+				toys->loadToy(j);
 				t.storeObservables();
 
 				//
@@ -627,8 +921,8 @@ void MethodPluginScan::scan2d(int nRun)
 				par1->setConstant(true);
 				par2->setConstant(true);
 				RooFitResult *r;
-				if ( !arg->scanforce ) r = fitToMinBringBackAngles(w->pdf(pdfName), false, -1);
-				else                   r = fitToMinForce(w, name);
+				if ( !arg->scanforce ) r = fitToMinBringBackAngles(w->pdf(pdfName), false, -1, getMinimizerSession());
+				else                   r = fitToMinForce(w, name, "", getMinimizerSession(), arg);
 				t.chi2minToy = r->minNll();
 				t.statusScan = 0;
 				t.storeParsScan();
@@ -641,12 +935,12 @@ void MethodPluginScan::scan2d(int nRun)
 				par2->setVal(scanpoint2);
 				par1->setConstant(false);
 				par2->setConstant(false);
-				if ( !arg->scanforce ) r = fitToMinBringBackAngles(w->pdf(pdfName), false, -1);
-				else                   r = fitToMinForce(w, name);
+				if ( !arg->scanforce ) r = fitToMinBringBackAngles(w->pdf(pdfName), false, -1, getMinimizerSession());
+				else                   r = fitToMinForce(w, name, "", getMinimizerSession(), arg);
 				t.chi2minGlobalToy = r->minNll();
 				t.statusFree = 0;
-				t.scanbest = ((RooRealVar*)w->set(parsName)->find(scanVar1))->getVal();
-				t.scanbesty = ((RooRealVar*)w->set(parsName)->find(scanVar2))->getVal();
+				t.scanbest = par1->getVal();
+				t.scanbesty = par2->getVal();
 				t.storeParsFree();
 				delete r;
 
@@ -654,19 +948,20 @@ void MethodPluginScan::scan2d(int nRun)
 				// 4. store
 				//
 				t.fill();
+
+				// checkpoint, and stop if out of time
+				if ( firstToy+j+1<nToys && cp.update(&t, id, firstToy+j+1) ) break;
 			}
 
 			// reset
-			setParameters(w, parsName, frCache.getParsAtFunctionCall());
+			frCache.restoreParsAtFunctionCall();
 			setParameters(w, obsName, obsDataset->get(0));
-			delete toyDataSet;
+			if ( !cp.isStopped() ) cp.update(&t, id+1, 0);
 		}
 	}
 
 	// save tree
-	TString dirname = "root/scan2dPlugin_"+name+"_"+scanVar1+"_"+scanVar2;
-	system("mkdir -p "+dirname);
-	t.writeToFile(Form(dirname+"/scan2dPlugin_"+name+"_"+scanVar1+"_"+scanVar2+"_run%i.root", nRun));
+	if ( !cp.isStopped() ) cp.writeFinal(&t);
 	delete pb;
 }
 
@@ -685,88 +980,156 @@ void MethodPluginScan::scan2d(int nRun)
 ///
 TH1F* MethodPluginScan::analyseToys(ToyTree* t, int id)
 {
-	/// \todo replace this such that there's always one bin per scan point, but still the range is the scan range.
-	/// \todo Also, if we use the min/max from the tree, we have the problem that they are not exactly
-	/// the scan range, so that the axis won't show the lowest and highest number.
-	/// \todo If the scan range was changed after the toys were generate, we absolutely have
-	/// to derive the range from the root files - else we'll have bining effects.
-
-	float halfBinWidth = (t->getScanpointMax()-t->getScanpointMin())/(float)t->getScanpointN()/2;
-	if ( t->getScanpointN()==1 ) halfBinWidth = 1.;
-	TH1F *hCL          = new TH1F(getUniqueRootName(), "hCL", t->getScanpointN(), t->getScanpointMin()-halfBinWidth, t->getScanpointMax()+halfBinWidth);
-	TH1F *h_better     = (TH1F*)hCL->Clone("h_better");
-	TH1F *h_all        = (TH1F*)hCL->Clone("h_all");
-	TH1F *h_background = (TH1F*)hCL->Clone("h_background");
-	TH1F *h_gof        = (TH1F*)hCL->Clone("h_gof");
-
-	Long64_t nentries  = t->GetEntries();
-	Long64_t nfailed   = 0;
-	Long64_t nwrongrun = 0;
-	Long64_t ntoysid   = 0; // if id is not -1, this will count the number of toys with that id
+	PValueAccumulator acc;
+	accumulateToys(t, id, &acc);
+	return analyseToys(&acc, id);
+}
 
+///
+/// Apply the toy selection of analyseToys() to the entries of a
+/// ToyTree, and add them to the counts of a p-value accumulator.
+///
+/// \param t    A ToyTree set up for reading (open() was called).
+/// \param id   Only consider entries that have the id branch set to this value.
+///             Default is -1 which uses all entries regardless of their id.
+/// \param acc  The accumulator to add the toys to.
+///
+void MethodPluginScan::accumulateToys(ToyTree* t, int id, PValueAccumulator* acc)
+{
+	Long64_t nentries = t->GetEntries();
 	t->activateCoreBranchesOnly(); // speeds up the event loop
 	ProgressBar pb(arg, nentries);
-	if ( arg->debug ) cout << "MethodPluginScan::analyseToys() : ";
-	cout << "building p-value histogram ..." << endl;
+	if ( arg->debug ) cout << "MethodPluginScan::accumulateToys() : ";
+	cout << "reading toys ..." << endl;
 
 	for (Long64_t i = 0; i < nentries; i++)
 	{
 		pb.progress();
 		t->GetEntry(i);
+		acc->nEntries++;
+
+		// Cut away toys outside a certain range. This is needed to remove
+		// low statistics spikes to get publication quality log plots.
+		// Also check ToyTree::computeMinMaxN().
+		bool inPlotRange = arg->pluginPlotRangeMin==arg->pluginPlotRangeMax
+			|| (arg->pluginPlotRangeMin<t->scanpoint && t->scanpoint<arg->pluginPlotRangeMax);
+
+		// every scan point gets a bin, even if all its toys fail
+		if ( inPlotRange ) acc->addScanpoint(t->scanpoint);
+
 		if ( id!=-1 && fabs(t->id-id)>0.001 ) continue; ///< only select entries with given id (unless id==-1)
-		ntoysid++;
+		acc->nToysId++;
 
 		// apply cuts
-		if ( ! (fabs(t->chi2minToy)<500 && fabs(t->chi2minGlobalToy)<500
-					&& t->statusFree==0. && t->statusScan==0. )
-		   ){
-			nfailed++;
-			continue;
-		}
+		if ( !applyToyCuts(t, acc, inPlotRange) ) continue;
 
 		// toys from a wrong run
 		if ( id!=-1 && ! (fabs(t->chi2minGlobal-chi2minGlobal)<0.2) ){
-			nwrongrun++;
+			acc->nWrongRun++;
 		}
 
-		// Cut away toys outside a certain range. This is needed to remove
-		// low statistics spikes to get publication quality log plots.
-		// Also check line 272 in ToyTree.cpp.
-		if ( arg->pluginPlotRangeMin!=arg->pluginPlotRangeMax
-				&& !(arg->pluginPlotRangeMin<t->scanpoint
-					&& t->scanpoint<arg->pluginPlotRangeMax) ) continue;
+		if ( !inPlotRange ) continue;
 
 		// use profile likelihood from internal scan, not the one found in the root files
 		if ( arg->intprob ){
 			t->chi2min = profileLH->getChi2min(t->scanpoint);
 		}
 
-		// Check if toys are in physical region.
-		// Don't enforce t.chi2min-t.chi2minGlobal>0, else it can be hard because due
-		// to little fluctuaions the best fit point can be missing from the plugin plot...
-		bool inPhysicalRegion = t->chi2minToy-t->chi2minGlobalToy>0; //&& t.chi2min-t.chi2minGlobal>0
+		countSelectedToy(t, acc);
+	}
+	t->activateAllBranches();
+}
 
-		// build test statistic
-		if ( inPhysicalRegion && t->chi2minToy-t->chi2minGlobalToy > t->chi2min-t->chi2minGlobal ){
-			h_better->Fill(t->scanpoint);
-		}
+///
+/// Helper function for accumulateToys() and countToy(). Applies the
+/// quality cuts on the fits of the toy currently held by the ToyTree.
+/// Toys that fail are counted as failed, and if only their free fit
+/// failed, also per scan point.
+///
+/// \param t           the ToyTree
+/// \param acc         the p-value accumulator
+/// \param inPlotRange count failed free fits per scan point
+/// \return true if the toy passes the cuts
+///
+bool MethodPluginScan::applyToyCuts(ToyTree* t, PValueAccumulator* acc, bool inPlotRange)
+{
+	if ( fabs(t->chi2minToy)<500 && fabs(t->chi2minGlobalToy)<500
+			&& t->statusFree==0. && t->statusScan==0. ) return true;
+	acc->nFailed++;
+	if ( inPlotRange && fabs(t->chi2minToy)<500 && t->statusScan==0. ) acc->addFailedFreeFit(t->scanpoint);
+	return false;
+}
 
-		// goodness-of-fit
-		if ( inPhysicalRegion && t->chi2minGlobalToy > t->chi2minGlobal ){
-			h_gof->Fill(t->scanpoint);
-		}
+///
+/// Helper function for accumulateToys() and countToy(). Counts the toy
+/// currently held by the ToyTree, which passed applyToyCuts(), into a
+/// p-value accumulator.
+///
+void MethodPluginScan::countSelectedToy(ToyTree* t, PValueAccumulator* acc)
+{
+	// Pruned toys (--pruning) can't be better, but it is not known
+	// if they are physical, see PValueAccumulator::getAcceptance().
+	// If the test statistic of the data has moved below their bound,
+	// they are undecided and counted as failed free fits.
+	if ( t->pruned ){
+		if ( t->chi2minToy>t->chi2min-t->chi2minGlobal ) acc->addFailedFreeFit(t->scanpoint);
+		else acc->addPrunedToy(t->scanpoint, t->getWeight());
+		return;
+	}
 
-		// all toys
-		if ( inPhysicalRegion ){
-			h_all->Fill(t->scanpoint);
-		}
+	// Check if toys are in physical region.
+	// Don't enforce t.chi2min-t.chi2minGlobal>0, else it can be hard because due
+	// to little fluctuaions the best fit point can be missing from the plugin plot...
+	bool inPhysicalRegion = t->chi2minToy-t->chi2minGlobalToy>0; //&& t.chi2min-t.chi2minGlobal>0
 
-		// use the unphysical events to estimate background (be careful with this,
-		// at least inspect the control plots to judge if this can be at all reasonable)
-		if ( !inPhysicalRegion ){
-			h_background->Fill(t->scanpoint);
-		}
+	// build test statistic
+	bool better = t->chi2minToy-t->chi2minGlobalToy > t->chi2min-t->chi2minGlobal;
+
+	// goodness-of-fit
+	bool gof = t->chi2minGlobalToy > t->chi2minGlobal;
+
+	// the unphysical events are counted as background (be careful with this,
+	// at least inspect the control plots to judge if this can be at all reasonable)
+	acc->addToy(t->scanpoint, inPhysicalRegion, better, gof, t->getWeight());
+}
+
+///
+/// Create a histogram of p-values vs scanpoints from the counts of
+/// a p-value accumulator, with one bin per scan point.
+///
+/// \param acc  The accumulator, filled by accumulateToys().
+/// \param id   The id the toys were selected with, -1 for all toys.
+/// \return     A new histogram that contains the p-values vs the scanpoint.
+///
+TH1F* MethodPluginScan::analyseToys(PValueAccumulator* acc, int id)
+{
+	/// \todo replace this such that there's always one bin per scan point, but still the range is the scan range.
+	/// \todo Also, if we use the min/max from the tree, we have the problem that they are not exactly
+	/// the scan range, so that the axis won't show the lowest and highest number.
+	/// \todo If the scan range was changed after the toys were generate, we absolutely have
+	/// to derive the range from the root files - else we'll have bining effects.
+
+	if ( acc->getScanpointN()==0 ){
+		cout << "MethodPluginScan::analyseToys() : ERROR : no toys found. Exit." << endl;
+		exit(1);
+	}
+	if ( acc->hasDifferentBinWidths() ){
+		cout << "\nMethodPluginScan::analyseToys() : WARNING : Different bin widths found in the toys!" << endl;
+		cout <<   "                                           The p-value histogram will have binning problems.\n" << endl;
 	}
+	float halfBinWidth = (acc->getScanpointMax()-acc->getScanpointMin())/(float)acc->getScanpointN()/2;
+	if ( acc->getScanpointN()==1 ) halfBinWidth = 1.;
+	TH1F *hCL          = new TH1F(getUniqueRootName(), "hCL", acc->getScanpointN(), acc->getScanpointMin()-halfBinWidth, acc->getScanpointMax()+halfBinWidth);
+	TH1F *h_better     = (TH1F*)hCL->Clone("h_better");
+	TH1F *h_all        = (TH1F*)hCL->Clone("h_all");
+	TH1F *h_background = (TH1F*)hCL->Clone("h_background");
+	TH1F *h_gof        = (TH1F*)hCL->Clone("h_gof");
+	acc->fillHistograms(h_better, h_all, h_gof, h_background);
+
+	Long64_t nentries  = acc->nEntries;
+	Long64_t nfailed   = acc->nFailed;
+	Long64_t nwrongrun = acc->nWrongRun;
+	Long64_t ntoysid   = acc->nToysId; // if id is not -1, this will count the number of toys with that id
 
 	if ( arg->debug ) cout << "MethodPluginScan::analyseToys() : ";
 	if ( id==-1 ){
@@ -780,7 +1143,7 @@ TH1F* MethodPluginScan::analyseToys(ToyTree* t, int id)
 	if ( arg->debug ) cout << "MethodPluginScan::analyseToys() : ";
 	cout << "fraction of failed toys: " << (double)nfailed/(double)nentries*100. << "%." << endl;
 	if ( arg->debug ) cout << "MethodPluginScan::analyseToys() : ";
-	cout << "fraction of background toys: " << h_background->GetEntries()/(double)nentries*100. << "%." << endl;
+	cout << "fraction of background toys: " << (double)acc->getNbackground()/(double)nentries*100. << "%." << endl;
 	if ( id==-1 && nwrongrun>0 ){
 		cout << "\nMethodPluginScan::analyseToys() : WARNING : Read toys that differ in global chi2min (wrong run) : "
 			<< (double)nwrongrun/(double)(nentries-nfailed)*100. << "%.\n" << endl;
@@ -791,6 +1154,8 @@ TH1F* MethodPluginScan::analyseToys(ToyTree* t, int id)
 		float nbetter = h_better->GetBinContent(i);
 		float nall = h_all->GetBinContent(i);
 		float nbackground = h_background->GetBinContent(i);
+		double nbetter2 = pow(h_better->GetBinError(i),2); // sum of squared weights
+		double nall2 = pow(h_all->GetBinError(i),2);
 		if ( nall == 0. ) continue;
 
 		// subtract background
@@ -806,6 +1171,10 @@ TH1F* MethodPluginScan::analyseToys(ToyTree* t, int id)
 		}
 		hCL->SetBinContent(i, p);
 		hCL->SetBinError(i, sqrt(p * (1.-p)/nall));
+		// weighted toys (--tailsampling): error of the weighted fraction
+		if ( fabs(nall2-nall)>1e-3*nall ){
+			hCL->SetBinError(i, sqrt((1.-p)*(1.-p)*nbetter2 + p*p*(nall2-nbetter2))/nall);
+		}
 	}
 
 	// goodness-of-fit
@@ -821,10 +1190,10 @@ TH1F* MethodPluginScan::analyseToys(ToyTree* t, int id)
 			<< Form("(%.1f+/-%.1f)%%", fitprobabilityVal*100., fitprobabilityErr*100.) << endl;
 	}
 
-	t->activateAllBranches();
 	delete h_better;
 	delete h_all;
 	delete h_background;
+	delete h_gof;
 	return hCL;
 }
 
@@ -832,12 +1201,21 @@ TH1F* MethodPluginScan::analyseToys(ToyTree* t, int id)
 /// Read in the TTrees that were produced by scan1d().
 /// Fills the 1-CL histogram.
 ///
+/// The toy counts are kept in a p-value accumulator that is saved
+/// next to the toy files. Only toy files that were not read before,
+/// e.g. those of batch jobs that finished since the last call, are
+/// read. If a file changed, or the set of files or the plot range
+/// is different, all files are read again. When --intprob is
+/// used, the test statistic depends on the current profile likelihood,
+/// so then all files are always read.
+///
 /// \param runMin Number of first root file to read.
 /// \param runMax Number of lase root file to read.
 ///
 void MethodPluginScan::readScan1dTrees(int runMin, int runMax)
 {
 	TChain *c = new TChain("plugin");
+	vector<TString> files;
 	int nFilesMissing = 0;
 	int nFilesRead = 0;
 	TString dirname = "root/scan1dPlugin_"+name+"_"+scanVar1;
@@ -853,6 +1231,7 @@ void MethodPluginScan::readScan1dTrees(int runMin, int runMax)
 		}
 		if ( arg->verbose ) cout << "reading " + file + " ..." << endl;
 		c->Add(file);
+		files.push_back(file);
 		nFilesRead += 1;
 	}
 	if ( arg->debug ) cout << "MethodPluginScan::readScan1dTrees() : ";
@@ -864,10 +1243,9 @@ void MethodPluginScan::readScan1dTrees(int runMin, int runMax)
 		exit(1);
 	}
 
-	ToyTree t(combiner, c);
-	t.open();
-
 	if ( arg->controlplot ) {
+		ToyTree t(combiner, c);
+		t.open();
 		ControlPlots cp(&t);
 		if ( arg->plotid==0 || arg->plotid==1 ) cp.ctrlPlotMore(profileLH);
 		if ( arg->plotid==0 || arg->plotid==2 ) cp.ctrlPlotChi2();
@@ -879,8 +1257,44 @@ void MethodPluginScan::readScan1dTrees(int runMin, int runMax)
 		cp.saveCtrlPlots();
 	}
 
+	// load the counts of the files read before
+	PValueAccumulator acc;
+	TString accFile = dirname+"/pvalues_"+name+"_"+scanVar1+".dat";
+	TString config = Form("pluginPlotRange %.9g %.9g", arg->pluginPlotRangeMin, arg->pluginPlotRangeMax);
+	bool persistent = !arg->intprob;
+	if ( persistent && acc.read(accFile) ){
+		bool upToDate = acc.getConfig()==config && !acc.hasFilesOtherThan(files);
+		for ( int i=0; i<files.size() && upToDate; i++ ){
+			if ( acc.checkFile(files[i])==2 ) upToDate = false;
+		}
+		if ( !upToDate ){
+			if ( arg->debug ) cout << "MethodPluginScan::readScan1dTrees() : ";
+			cout << "toy files or plot range changed, reading all toys again." << endl;
+			acc.reset();
+		}
+	}
+	acc.setConfig(config);
+
+	// add the new files
+	int nFilesNew = 0;
+	for ( int i=0; i<files.size(); i++ ){
+		if ( acc.checkFile(files[i])==1 ) continue;
+		if ( arg->verbose ) cout << "MethodPluginScan::readScan1dTrees() : adding " << files[i] << endl;
+		TChain *cNew = new TChain("plugin");
+		cNew->Add(files[i]);
+		ToyTree tNew(combiner, cNew);
+		tNew.open();
+		accumulateToys(&tNew, -1, &acc);
+		acc.addFile(files[i]);
+		delete cNew;
+		nFilesNew += 1;
+	}
+	if ( arg->debug ) cout << "MethodPluginScan::readScan1dTrees() : ";
+	cout << "new toy files: " << nFilesNew << ", already counted: " << nFilesRead-nFilesNew << endl;
+	if ( persistent && nFilesNew>0 ) acc.write(accFile);
+
 	if ( hCL ) delete hCL;
-	hCL = analyseToys(&t, -1);
+	hCL = analyseToys(&acc, -1);
 }
 
 ///
@@ -1046,3 +1460,32 @@ double MethodPluginScan::importance(double pvalue)
 	return f;
 }
 
+///
+/// Decide if enough toys were fitted at a scan point in adaptive
+/// mode (--adaptive). The p-value only matters where it is
+/// close to one of the 1, 2, 3 sigma levels, which define the
+/// confidence intervals. A point is done if, for each of these
+/// levels, the p-value is either more than two binomial errors
+/// away from it, or known to the requested relative precision.
+///
+/// \param acc       counts of the toys fitted so far
+/// \param scanpoint the scan point
+/// \return true if no more toys are needed
+///
+bool MethodPluginScan::isPvalueSettled(PValueAccumulator* acc, float scanpoint)
+{
+	if ( acc->getNall(scanpoint)<10 ) return false;
+	double p = acc->getPvalue(scanpoint);
+	double err = acc->getPvalueError(scanpoint);
+	// at p=0 or p=1 the error vanishes, use the error of one toy instead
+	double nEff = acc->getNeff(scanpoint);
+	if ( p<1./nEff || p>1.-1./nEff ) err = sqrt(1./nEff*(1.-1./nEff)/nEff);
+	double levels[3] = {0.3173, 0.0455, 0.0027};
+	for ( int i=0; i<3; i++ ){
+		if ( fabs(p-levels[i])>2.*err ) continue;
+		if ( err<arg->adaptive*levels[i] ) continue;
+		return false;
+	}
+	return true;
+}
+
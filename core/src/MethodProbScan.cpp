@@ -66,6 +66,8 @@ MethodProbScan::~MethodProbScan()
 /// - Start at a scan value that is in the middle of the allowed
 ///   range, preferably a solution, and scan up and down from there.
 /// - use the "probforce" command line flag to enable force minimum finding
+/// - use the "probadaptive" command line flag to refine the scan only where
+///   it matters, see scan1dAdaptive()
 ///
 /// \param fast This will scan each scanpoint only once.
 /// \param reverse This will scan in reverse direction.
@@ -85,6 +87,7 @@ int MethodProbScan::scan1d(bool fast, bool reverse)
 	if ( startPars ) delete startPars;
 	startPars = new RooDataSet("startPars", "startPars", *w->set(parsName));
 	startPars->add(*w->set(parsName));
+	getParameterBinding()->store(startParsValues);
 
 	// // start scan from global minimum (not always a good idea as we need to set from other places as well)
 	// setParameters(w, parsName, globalMin);
@@ -135,129 +138,96 @@ int MethodProbScan::scan1d(bool fast, bool reverse)
 	double bestMinOld = chi2minGlobal;
 	double bestMinFoundInScan = 100.;
 
-	for ( int jj=0; jj<4; jj++ )
-	{
-		int j = jj;
-		if ( reverse ) switch(jj)
-		{
-			case 0: j = 2; break;
-			case 1: j = 3; break;
-			case 2: j = 0; break;
-			case 3: j = 1; break;
-		}
-
-		float scanStart, scanStop;
-		switch(j)
-		{
-			case 0:
-				// UP
-				setParameters(w, parsName, startPars->get(0));
-				scanStart = startValue;
-				scanStop  = par->getMax();
-				scanUp = true;
-				break;
-			case 1:
-				// DOWN
-				scanStart = par->getMax();
-				scanStop  = startValue;
-				scanUp = false;
-				break;
-			case 2:
-				// DOWN
-				setParameters(w, parsName, startPars->get(0));
-				scanStart = startValue;
-				scanStop  = par->getMin();
-				scanUp = false;
-				break;
-			case 3:
-				// UP
-				scanStart = par->getMin();
-				scanStop  = startValue;
-				scanUp = true;
-				break;
-		}
-
-		if ( fast && ( j==1 || j==3 ) ) continue;
-
-		for ( int i=0; i<nPoints1d; i++ )
+	if ( arg->probadaptive>0 ){
+		scan1dAdaptive(fast, reverse, startValue, bestMinFoundInScan);
+	}
+	else if ( arg->nthreads>1 ){
+		scan1dParallel(fast, reverse, startValue, bestMinFoundInScan);
+	}
+	else {
+		for ( int jj=0; jj<4; jj++ )
 		{
-			float scanvalue;
-			if ( scanUp )
+			int j = jj;
+			if ( reverse ) switch(jj)
 			{
-				scanvalue = min + (max-min)*(double)i/(double)nPoints1d + hCL->GetBinWidth(1)/2.;
-				if ( scanvalue < scanStart ) continue;
-				if ( scanvalue > scanStop ) break;
+				case 0: j = 2; break;
+				case 1: j = 3; break;
+				case 2: j = 0; break;
+				case 3: j = 1; break;
 			}
-			else
+
+			float scanStart, scanStop;
+			switch(j)
 			{
-				scanvalue = max - (max-min)*(double)(i+1)/(double)nPoints1d + hCL->GetBinWidth(1)/2.;
-				if ( scanvalue > scanStart ) continue;
-				if ( scanvalue < scanStop ) break;
+				case 0:
+					// UP
+					getParameterBinding()->load(startParsValues);
+					scanStart = startValue;
+					scanStop  = par->getMax();
+					scanUp = true;
+					break;
+				case 1:
+					// DOWN
+					scanStart = par->getMax();
+					scanStop  = startValue;
+					scanUp = false;
+					break;
+				case 2:
+					// DOWN
+					getParameterBinding()->load(startParsValues);
+					scanStart = startValue;
+					scanStop  = par->getMin();
+					scanUp = false;
+					break;
+				case 3:
+					// UP
+					scanStart = par->getMin();
+					scanStop  = startValue;
+					scanUp = true;
+					break;
 			}
 
-			// disable drag mode
-			// (the improve method doesn't work with drag mode as parameter run
-			// at their limits)
-			if ( scanDisableDragMode ) setParameters(w, parsName, startPars->get(0));
+			if ( fast && ( j==1 || j==3 ) ) continue;
 
-			// set the parameter of interest to the scan point
-			par->setVal(scanvalue);
+			for ( int i=0; i<nPoints1d; i++ )
+			{
+				float scanvalue;
+				if ( scanUp )
+				{
+					scanvalue = min + (max-min)*(double)i/(double)nPoints1d + hCL->GetBinWidth(1)/2.;
+					if ( scanvalue < scanStart ) continue;
+					if ( scanvalue > scanStop ) break;
+				}
+				else
+				{
+					scanvalue = max - (max-min)*(double)(i+1)/(double)nPoints1d + hCL->GetBinWidth(1)/2.;
+					if ( scanvalue > scanStart ) continue;
+					if ( scanvalue < scanStop ) break;
+				}
 
-			// don't scan in unphysical region
-			if ( scanvalue < par->getMin() || scanvalue > par->getMax() ) continue;
+				// disable drag mode
+				// (the improve method doesn't work with drag mode as parameter run
+				// at their limits)
+				if ( scanDisableDragMode ) getParameterBinding()->load(startParsValues);
 
-			// status bar
-			if ( (((int)nStep % (int)(nTotalSteps/printFreq)) == 0))
-				cout << "MethodProbScan::scan1d() : scanning " << (float)nStep/(float)nTotalSteps*100. << "%   \r" << flush;
-
-			// fit!
-			RooFitResult *fr = 0;
-			if ( arg->probforce )         fr = fitToMinForce(w, combiner->getPdfName());
-			else if ( arg->probimprove )  fr = fitToMinImprove(w, combiner->getPdfName());
-			else                          fr = fitToMinBringBackAngles(w->pdf(pdfName), false, -1);
-			double chi2minScan = fr->minNll();
-			if ( std::isinf(chi2minScan) ) chi2minScan=1e4; // else the toys in PDF_testConstraint don't work
-			RooSlimFitResult *r = new RooSlimFitResult(fr); // try to save memory by using the slim fit result
-			delete fr;
-			allResults.push_back(r);
-			bestMinFoundInScan = TMath::Min((double)chi2minScan, (double)bestMinFoundInScan);
+				// set the parameter of interest to the scan point
+				par->setVal(scanvalue);
 
-			TString warningChi2Neg;
-			if ( chi2minScan < 0 ){
-				float newChi2minScan = chi2minGlobal + 25.; // 5sigma more than best point
-				warningChi2Neg = "MethodProbScan::scan1d() : WARNING : " + title;
-				warningChi2Neg += TString(Form(" chi2 negative for scan point %i: %f",i,chi2minScan));
-				warningChi2Neg += " setting to: " + TString(Form("%f",newChi2minScan));
-				//cout << warningChi2Neg << "\r" << flush;
-				cout << warningChi2Neg << endl;
-				chi2minScan = newChi2minScan;
-			}
+				// don't scan in unphysical region
+				if ( scanvalue < par->getMin() || scanvalue > par->getMax() ) continue;
 
-			// If we find a minimum smaller than the old "global" minimum, this means that all
-			// previous 1-CL values are too high.
-			if ( chi2minScan<chi2minGlobal ){
-				if ( arg->verbose ) cout << "MethodProbScan::scan1d() : WARNING : '" << title << "' new global minimum found! "
-																		<< " chi2minScan=" << chi2minScan << endl;
-				chi2minGlobal = chi2minScan;
-				// recompute previous 1-CL values
-				for ( int k=1; k<=hCL->GetNbinsX(); k++ ){
-					hCL->SetBinContent(k, TMath::Prob(hChi2min->GetBinContent(k)-chi2minGlobal, 1));
-				}
-			}
+				// status bar
+				if ( (((int)nStep % (int)(nTotalSteps/printFreq)) == 0))
+					cout << "MethodProbScan::scan1d() : scanning " << (float)nStep/(float)nTotalSteps*100. << "%   \r" << flush;
 
-			double deltaChi2 = chi2minScan - chi2minGlobal;
-			double oneMinusCL = TMath::Prob(deltaChi2, 1);
+				// fit!
+				double chi2minScan;
+				RooSlimFitResult *r = fitScanPoint1d(chi2minScan);
+				bestMinFoundInScan = TMath::Min((double)chi2minScan, (double)bestMinFoundInScan);
+				storeScanResult1d(r, chi2minScan, scanvalue, i);
 
-			// Save the 1-CL value and the corresponding fit result.
-			// But only if better than before!
-			if ( hCL->GetBinContent(hCL->FindBin(scanvalue)) <= oneMinusCL ){
-				hCL->SetBinContent(hCL->FindBin(scanvalue), oneMinusCL);
-				hChi2min->SetBinContent(hCL->FindBin(scanvalue), chi2minScan);
-				int iRes = hCL->FindBin(scanvalue)-1;
-				curveResults[iRes] = r;
+				nStep++;
 			}
-
-			nStep++;
 		}
 	}
 	cout << "MethodProbScan::scan1d() : scan done.           " << endl;
@@ -277,7 +247,7 @@ int MethodProbScan::scan1d(bool fast, bool reverse)
 		}
 	}
 
-	setParameters(w, parsName, startPars->get(0));
+	getParameterBinding()->load(startParsValues);
 	saveSolutions();
 	confirmSolutions();
 
@@ -286,31 +256,465 @@ int MethodProbScan::scan1d(bool fast, bool reverse)
 }
 
 ///
-/// Delete a pointer if it is not included in
-/// the curveResults2d vector. Also removes it
-/// from the allResults vector by setting the entry
-/// to 0.
-/// \return true if r was deleted, or if it is 0
+/// Helper function for scan1d(). Fits the PDF at the current
+/// parameter values, using the minimization method requested on
+/// the command line. The fit result is returned as a slim fit
+/// result, which is also added to allResults by storeScanResult1d().
+///
+/// \param chi2minScan - return value: the chi2 of the fit
+/// \return the fit result, caller takes ownership
+///
+RooSlimFitResult* MethodProbScan::fitScanPoint1d(double &chi2minScan)
+{
+	RooFitResult *fr = 0;
+	if ( arg->probforce )         fr = fitToMinForce(w, combiner->getPdfName(), "", getMinimizerSession(), arg);
+	else if ( arg->probimprove )  fr = getImproveFitter()->fit();
+	else                          fr = fitToMinBringBackAngles(w->pdf(pdfName), false, -1, getMinimizerSession());
+	chi2minScan = fr->minNll();
+	if ( std::isinf(chi2minScan) ) chi2minScan=1e4; // else the toys in PDF_testConstraint don't work
+	RooSlimFitResult *r = new RooSlimFitResult(fr); // try to save memory by using the slim fit result
+	delete fr;
+	return r;
+}
+
+///
+/// Helper function for scan1d(). Books a fit result of the scan:
+/// adds it to allResults, updates the global minimum, and if it is
+/// better than what we had before in that bin, saves it into the
+/// hCL and hChi2min histograms and into curveResults.
+///
+/// \param r           - the fit result
+/// \param chi2minScan - the chi2 of the fit
+/// \param scanvalue   - value of the scan parameter
+/// \param i           - scan step, only used for printout
+///
+void MethodProbScan::storeScanResult1d(RooSlimFitResult *r, double chi2minScan, float scanvalue, int i)
+{
+	allResults.push_back(r);
+
+	TString warningChi2Neg;
+	if ( chi2minScan < 0 ){
+		float newChi2minScan = chi2minGlobal + 25.; // 5sigma more than best point
+		warningChi2Neg = "MethodProbScan::scan1d() : WARNING : " + title;
+		warningChi2Neg += TString(Form(" chi2 negative for scan point %i: %f",i,chi2minScan));
+		warningChi2Neg += " setting to: " + TString(Form("%f",newChi2minScan));
+		//cout << warningChi2Neg << "\r" << flush;
+		cout << warningChi2Neg << endl;
+		chi2minScan = newChi2minScan;
+	}
+
+	// If we find a minimum smaller than the old "global" minimum, this means that all
+	// previous 1-CL values are too high.
+	if ( chi2minScan<chi2minGlobal ){
+		if ( arg->verbose ) cout << "MethodProbScan::scan1d() : WARNING : '" << title << "' new global minimum found! "
+																<< " chi2minScan=" << chi2minScan << endl;
+		chi2minGlobal = chi2minScan;
+		// recompute previous 1-CL values
+		for ( int k=1; k<=hCL->GetNbinsX(); k++ ){
+			hCL->SetBinContent(k, TMath::Prob(hChi2min->GetBinContent(k)-chi2minGlobal, 1));
+		}
+	}
+
+	double deltaChi2 = chi2minScan - chi2minGlobal;
+	double oneMinusCL = TMath::Prob(deltaChi2, 1);
+
+	// Save the 1-CL value and the corresponding fit result.
+	// But only if better than before!
+	if ( hCL->GetBinContent(hCL->FindBin(scanvalue)) <= oneMinusCL ){
+		hCL->SetBinContent(hCL->FindBin(scanvalue), oneMinusCL);
+		hChi2min->SetBinContent(hCL->FindBin(scanvalue), chi2minScan);
+		int iRes = hCL->FindBin(scanvalue)-1;
+		curveResults[iRes] = r;
+	}
+}
+
+///
+/// Helper function for scan1d(). Adaptive 1d scan (--probadaptive).
+///
+/// The first call starts from a coarse grid, the nPoints1d bins of hCL.
+/// The cells are kept across calls, later calls start from the cells of
+/// the earlier ones. The cells are fitted in the order of the serial scan,
+/// honouring fast and reverse, and each cell keeps the better of its old
+/// and its new fit, like the bins of the serial scan. Then, in rounds, each scan point is
+/// the center of a cell, and a cell is split into three if
+///   - the 1-CL curve crosses the 1 or 2 sigma level between it and a
+///     neighbor,
+///   - the 1-CL value changes by more than 0.1 between it and a neighbor,
+///   - or it is a local minimum of the chi2 with 1-CL above 3 sigma,
+///     then its neighbors are split as well.
+/// Splitting into three keeps the old scan point at the center of the
+/// middle cell, so only the two outer cells need new fits, which start
+/// from the parameters of the old point. Cells are not split once their
+/// width is below the precision given by --probadaptive, as a fraction
+/// of the scan range.
+///
+/// At the end hCL and hChi2min are replaced by histograms with one,
+/// in general non-uniform, bin per cell. All fits are added to
+/// allResults. The fits run serially, --nthreads is ignored.
 ///
-bool MethodProbScan::deleteIfNotInCurveResults2d(RooSlimFitResult *r)
+/// \param fast               - only scan away from the start value
+/// \param reverse            - scan down from the start value first
+/// \param startValue         - value of the scan parameter at function call
+/// \param bestMinFoundInScan - return value: smallest chi2 found
+///
+void MethodProbScan::scan1dAdaptive(bool fast, bool reverse, float startValue, double &bestMinFoundInScan)
 {
-	if ( r==0 ) return true;
-	bool del = true;
-	for ( int j=0; j<hCL2d->GetNbinsX(); j++ )
-		for ( int k=0; k<hCL2d->GetNbinsY(); k++ ){
-			if ( r==curveResults2d[j][k] ){
-				del = false;
+	float min = hCL->GetXaxis()->GetXmin();
+	float max = hCL->GetXaxis()->GetXmax();
+	double minWidth = arg->probadaptive*(max-min);
+	float levels[2] = {1.-0.6827, 1.-0.9545};
+	int nFits = 0;
+
+	// coarse grid
+	vector<AdaptiveCell1d> &cells = adaptiveCells1d;
+	if ( cells.empty() ){
+		cells.resize(nPoints1d);
+		for ( int i=0; i<nPoints1d; i++ ){
+			cells[i].lo = min + (max-min)*(double)i/(double)nPoints1d;
+			cells[i].hi = min + (max-min)*(double)(i+1)/(double)nPoints1d;
+			cells[i].chi2 = 1e6;
+			cells[i].r = 0;
+		}
+	}
+
+	// fit all cells like the serial scan: up from the start value to the
+	// upper limit and back, then down to the lower limit and back
+	int n = cells.size();
+	int iStart = 0;
+	while ( iStart<n-1 && cells[iStart].hi<=startValue ) iStart++;
+	for ( int jj=0; jj<4; jj++ )
+	{
+		int j = reverse ? (jj+2)%4 : jj;
+		if ( fast && ( j==1 || j==3 ) ) continue;
+		int first, stop, dir;
+		switch(j)
+		{
+			case 0:
+				// UP
+				getParameterBinding()->load(startParsValues);
+				first = iStart;
+				stop = n;
+				dir = 1;
 				break;
+			case 1:
+				// DOWN
+				first = n-1;
+				stop = iStart-1;
+				dir = -1;
+				break;
+			case 2:
+				// DOWN
+				getParameterBinding()->load(startParsValues);
+				first = iStart-1;
+				stop = -1;
+				dir = -1;
+				break;
+			case 3:
+				// UP
+				first = 0;
+				stop = iStart;
+				dir = 1;
+				break;
+		}
+		for ( int i=first; i!=stop; i+=dir ){
+			fitAdaptiveCell1d(cells[i]);
+			nFits++;
+		}
+	}
+
+	// refine
+	for ( int iRound=1; true; iRound++ )
+	{
+		n = cells.size();
+		double chi2min = chi2minGlobal;
+		for ( int k=0; k<n; k++ ) chi2min = TMath::Min(chi2min, cells[k].chi2);
+		vector<double> p(n);
+		for ( int k=0; k<n; k++ ) p[k] = TMath::Prob(cells[k].chi2-chi2min, 1);
+
+		vector<bool> split(n, false);
+		for ( int k=0; k<n-1; k++ ){
+			bool steep = fabs(p[k]-p[k+1])>0.1;
+			bool crossing = false;
+			for ( int l=0; l<2; l++ ){
+				if ( (p[k]-levels[l])*(p[k+1]-levels[l])<=0 ) crossing = true;
 			}
+			if ( steep || crossing ) split[k] = split[k+1] = true;
 		}
-	if ( del ){
-		delete r;
-		// remove also from allResults vector
-		for ( int j=0; j<allResults.size(); j++ ){
-			if ( r==allResults[j] ) allResults[j] = 0;
+		for ( int k=0; k<n; k++ ){
+			if ( p[k]<1.-0.9973 ) continue;
+			if ( k>0 && cells[k].chi2>=cells[k-1].chi2 ) continue;
+			if ( k<n-1 && cells[k].chi2>cells[k+1].chi2 ) continue;
+			split[k] = true;
+			if ( k>0 ) split[k-1] = true;
+			if ( k<n-1 ) split[k+1] = true;
 		}
+
+		vector<AdaptiveCell1d> refined;
+		int nNew = 0;
+		for ( int k=0; k<n; k++ ){
+			AdaptiveCell1d &c = cells[k];
+			if ( !split[k] || c.hi-c.lo<=minWidth ){
+				refined.push_back(c);
+				continue;
+			}
+			AdaptiveCell1d left, middle, right;
+			left.chi2 = right.chi2 = 1e6;
+			left.r = right.r = 0;
+			left.lo = c.lo;
+			left.hi = c.lo+(c.hi-c.lo)/3.;
+			right.lo = c.hi-(c.hi-c.lo)/3.;
+			right.hi = c.hi;
+			middle = c;
+			middle.lo = left.hi;
+			middle.hi = right.lo;
+			getParameterBinding()->load(c.r);
+			fitAdaptiveCell1d(left);
+			getParameterBinding()->load(c.r);
+			fitAdaptiveCell1d(right);
+			refined.push_back(left);
+			refined.push_back(middle);
+			refined.push_back(right);
+			nNew += 2;
+		}
+		cells = refined;
+		nFits += nNew;
+		if ( arg->verbose ) cout << "MethodProbScan::scan1dAdaptive() : round " << iRound << ": "
+			<< nNew << " new points, " << cells.size() << " points in total" << endl;
+		if ( nNew==0 ) break;
+	}
+
+	// replace the histograms by ones with a bin per cell
+	n = cells.size();
+	vector<double> edges(n+1);
+	for ( int k=0; k<n; k++ ) edges[k] = cells[k].lo;
+	edges[n] = cells[n-1].hi;
+	for ( int k=0; k<n; k++ ){
+		bestMinFoundInScan = TMath::Min(cells[k].chi2, bestMinFoundInScan);
+		chi2minGlobal = TMath::Min(cells[k].chi2, chi2minGlobal);
+	}
+	delete hCL;
+	delete hChi2min;
+	hCL = new TH1F("hCL"+getUniqueRootName(), "hCL"+pdfName, n, &edges[0]);
+	hChi2min = new TH1F("hChi2min"+getUniqueRootName(), "hChi2min"+pdfName, n, &edges[0]);
+	curveResults.assign(n, (RooSlimFitResult*)0);
+	for ( int k=0; k<n; k++ ){
+		hChi2min->SetBinContent(k+1, cells[k].chi2);
+		hCL->SetBinContent(k+1, TMath::Prob(cells[k].chi2-chi2minGlobal, 1));
+		curveResults[k] = cells[k].r;
 	}
-	return del;
+	cout << "MethodProbScan::scan1dAdaptive() : " << nFits << " fits, "
+		<< n << " scan points (uniform grid of this precision: "
+		<< (int)ceil(1./arg->probadaptive) << " points)" << endl;
+}
+
+///
+/// Helper function for scan1dAdaptive(). Fits the scan point at the center
+/// of a cell, starting from the current parameter values. The fit result
+/// is added to allResults, and replaces the one of the cell if its chi2
+/// is lower. A negative chi2 is set to 5 sigma above the global minimum,
+/// like in storeScanResult1d().
+///
+void MethodProbScan::fitAdaptiveCell1d(AdaptiveCell1d &cell)
+{
+	if ( scanDisableDragMode ) getParameterBinding()->load(startParsValues);
+	w->var(scanVar1)->setVal((cell.lo+cell.hi)/2.);
+	double chi2;
+	RooSlimFitResult *r = fitScanPoint1d(chi2);
+	allResults.push_back(r);
+	if ( chi2<0 ) chi2 = chi2minGlobal + 25.;
+	if ( cell.r && cell.chi2<=chi2 ) return;
+	cell.r = r;
+	cell.chi2 = chi2;
+}
+
+///
+/// Helper function for scan1d(). Runs the 1d scan in --nthreads
+/// parallel segments.
+///
+/// The scan range is split into contiguous segments of scan points.
+/// Each segment is scanned like the full range in the serial mode:
+/// starting at its anchor, the point closest to the start value, it
+/// scans up to the segment end and back, then down to the segment start
+/// and back, dragging the parameters along. Each segment so has its own
+/// drag chain. The segment holding the start value starts from the start
+/// parameters. The other ones are seeded by a serial pre-pass that drags
+/// the parameters from the start value outwards over the anchors of the
+/// segments, as the serial scan would reach them, one fit per segment.
+///
+/// RooMinuit keeps its fitter in a static data member, so the segments
+/// are scanned by forked worker processes, each holding a private
+/// copy of the workspace. The fit results are passed back through
+/// temporary root files. A final reconciliation pass books them in
+/// segment order through storeScanResult1d(), which keeps the best
+/// chi2 per bin in hCL, hChi2min, and curveResults. The temporary files
+/// are removed also if a worker fails.
+///
+/// \param fast               - scan each point only once
+/// \param reverse            - scan down before scanning up
+/// \param startValue         - value of the scan parameter at function call
+/// \param bestMinFoundInScan - return value: smallest chi2 found
+///
+void MethodProbScan::scan1dParallel(bool fast, bool reverse, float startValue, double &bestMinFoundInScan)
+{
+	RooRealVar *par = w->var(scanVar1);
+	float min = hCL->GetXaxis()->GetXmin();
+	float max = hCL->GetXaxis()->GetXmax();
+	int nSegments = TMath::Min(arg->nthreads, nPoints1d);
+	int iStartValue = TMath::Min(TMath::Max(hCL->FindBin(startValue)-1, 0), nPoints1d-1);
+	cout << "MethodProbScan::scan1d() : scanning in " << nSegments << " parallel segments ..." << endl;
+
+	// seed the segments: drag from the start value over the anchors of
+	// the segments above it, then over those below it
+	vector<vector<double> > seeds(nSegments, startParsValues);
+	int iStartSeg = iStartValue*nSegments/nPoints1d;
+	while ( iStartSeg>0 && iStartValue<iStartSeg*nPoints1d/nSegments ) iStartSeg--;
+	while ( iStartSeg<nSegments-1 && iStartValue>=(iStartSeg+1)*nPoints1d/nSegments ) iStartSeg++;
+	for ( int step=1; step>=-1; step-=2 )
+	{
+		getParameterBinding()->load(startParsValues);
+		for ( int iSeg=iStartSeg+step; iSeg>=0 && iSeg<nSegments; iSeg+=step )
+		{
+			int iAnchor = step>0 ? iSeg*nPoints1d/nSegments : (iSeg+1)*nPoints1d/nSegments-1;
+			float scanvalue = min + (max-min)*(double)iAnchor/(double)nPoints1d + hCL->GetBinWidth(1)/2.;
+			par->setVal(scanvalue);
+			if ( scanvalue < par->getMin() || scanvalue > par->getMax() ) continue;
+			double chi2minScan;
+			RooSlimFitResult *r = fitScanPoint1d(chi2minScan);
+			getParameterBinding()->store(seeds[iSeg]);
+			bestMinFoundInScan = TMath::Min((double)chi2minScan, (double)bestMinFoundInScan);
+			storeScanResult1d(r, chi2minScan, scanvalue, iAnchor);
+		}
+	}
+
+	// start one worker per segment
+	vector<TString> fNames;
+	vector<pid_t> pids;
+	cout.flush();
+	fflush(stdout);
+	for ( int iSeg=0; iSeg<nSegments; iSeg++ )
+	{
+		TString fName = Form("%s/gammacombo_scan1d_%i_seg%i.root", gSystem->TempDirectory(), getpid(), iSeg);
+		pid_t pid = fork();
+		if ( pid<0 ){
+			cout << "MethodProbScan::scan1dParallel() : ERROR : couldn't start worker " << iSeg << ". Exit." << endl;
+			for ( int k=0; k<pids.size(); k++ ) waitpid(pids[k], 0, 0);
+			for ( int k=0; k<fNames.size(); k++ ) gSystem->Unlink(fNames[k]);
+			exit(1);
+		}
+		if ( pid==0 ){
+			// worker process: scan points iLow...iHigh (inclusive)
+			isWorkerProcess = true;
+			int iLow  = iSeg*nPoints1d/nSegments;
+			int iHigh = (iSeg+1)*nPoints1d/nSegments-1;
+			int iAnchor = TMath::Min(TMath::Max(iStartValue, iLow), iHigh);
+			TFile f(fName, "recreate");
+			int nResults = 0;
+			for ( int jj=0; jj<4; jj++ )
+			{
+				// j = 0: anchor -> upper end, 1: upper end -> anchor,
+				//     2: anchor -> lower end, 3: lower end -> anchor
+				int j = reverse ? (jj+2)%4 : jj;
+				if ( fast && ( j==1 || j==3 ) ) continue;
+				int iFirst, iLast, step;
+				switch(j)
+				{
+					case 0:
+						getParameterBinding()->load(seeds[iSeg]);
+						iFirst = iAnchor; iLast = iHigh; step = 1;
+						break;
+					case 1:
+						iFirst = iHigh; iLast = iAnchor; step = -1;
+						break;
+					case 2:
+						getParameterBinding()->load(seeds[iSeg]);
+						iFirst = iAnchor; iLast = iLow; step = -1;
+						break;
+					case 3:
+						iFirst = iLow; iLast = iAnchor; step = 1;
+						break;
+				}
+				for ( int i=iFirst; i!=iLast+step; i+=step )
+				{
+					float scanvalue = min + (max-min)*(double)i/(double)nPoints1d + hCL->GetBinWidth(1)/2.;
+					if ( scanDisableDragMode ) getParameterBinding()->load(startParsValues);
+					par->setVal(scanvalue);
+					if ( scanvalue < par->getMin() || scanvalue > par->getMax() ) continue;
+					double chi2minScan;
+					RooSlimFitResult *r = fitScanPoint1d(chi2minScan);
+					f.WriteObject(r, Form("r%i",nResults++));
+					delete r;
+				}
+			}
+			f.Close();
+			cout.flush();
+			fflush(stdout);
+			_exit(0); // don't run any ROOT cleanup in the worker
+		}
+		fNames.push_back(fName);
+		pids.push_back(pid);
+	}
+
+	// wait for all workers before touching their files
+	bool failed = false;
+	for ( int iSeg=0; iSeg<nSegments; iSeg++ )
+	{
+		int status;
+		waitpid(pids[iSeg], &status, 0);
+		if ( !WIFEXITED(status) || WEXITSTATUS(status)!=0 ){
+			cout << "MethodProbScan::scan1dParallel() : ERROR : worker " << iSeg << " failed." << endl;
+			failed = true;
+		}
+	}
+	if ( failed ){
+		for ( int k=0; k<nSegments; k++ ) gSystem->Unlink(fNames[k]);
+		cout << "MethodProbScan::scan1dParallel() : ERROR : scan failed. Exit." << endl;
+		exit(1);
+	}
+
+	// reconcile: book the results of all segments
+	for ( int iSeg=0; iSeg<nSegments; iSeg++ )
+	{
+		TFile *f = TFile::Open(fNames[iSeg]);
+		if ( !f || f->IsZombie() ){
+			cout << "MethodProbScan::scan1dParallel() : ERROR : couldn't read results of segment " << iSeg << ". Exit." << endl;
+			for ( int k=iSeg; k<nSegments; k++ ) gSystem->Unlink(fNames[k]);
+			exit(1);
+		}
+		for ( int k=0; ; k++ ){
+			RooSlimFitResult *r = (RooSlimFitResult*)f->Get(Form("r%i",k));
+			if ( !r ) break;
+			double chi2minScan = r->minNll();
+			if ( std::isinf(chi2minScan) ) chi2minScan=1e4;
+			bestMinFoundInScan = TMath::Min((double)chi2minScan, (double)bestMinFoundInScan);
+			float scanvalue = r->getConstParVal(scanVar1);
+			storeScanResult1d(r, chi2minScan, scanvalue, hCL->FindBin(scanvalue)-1);
+		}
+		f->Close();
+		delete f;
+		gSystem->Unlink(fNames[iSeg]);
+	}
+}
+
+///
+/// Release the fit result of the current 2d scan at a scan point, once
+/// it isn't needed for start parameters anymore. It is deleted, and
+/// its allResults entry set to 0, unless it made it into curveResults2d.
+/// As a result can only be in curveResults2d at the bin it was fitted
+/// at, this is a constant time check, see storeScanResult2d().
+///
+/// \param i, j - bin coordinates of the scan point
+/// \return true if the result was deleted
+///
+bool MethodProbScan::releaseScanResult2d(int i, int j)
+{
+	int k = scanResultIndex2d[i-1][j-1];
+	if ( k<0 ) return false;
+	scanResultIndex2d[i-1][j-1] = -1;
+	RooSlimFitResult *r = allResults[k];
+	if ( r==0 || r==curveResults2d[i-1][j-1] ) return false;
+	delete r;
+	allResults[k] = 0;
+	return true;
 }
 
 ///
@@ -355,6 +759,420 @@ bool MethodProbScan::computeInnerTurnCoords(const int iStart, const int jStart,
 }
 
 
+///
+/// Helper function for scan2d(). Fits one point of the 2d scan: sets the
+/// start parameters from the inner turn of the spiral, sets the scan
+/// parameters to the bin centers, and fits. The parameter errors, which
+/// set the initial step sizes of Minuit, are reset to their values at the
+/// start of the scan, so that the fit doesn't depend on the fits done
+/// before it in the same process.
+///
+/// \param iStart, jStart    - center of the spiral
+/// \param i, j              - bin coordinates of the scan point
+/// \param mycurveResults2d  - fit results of the current scan, provide the start parameters
+/// \return the fit result, caller takes ownership
+///
+RooSlimFitResult* MethodProbScan::fitScanPoint2d(int iStart, int jStart, int i, int j,
+		vector<vector<RooSlimFitResult*> > &mycurveResults2d)
+{
+	// set start parameters from inner turn of the spiral
+	int xStartPars, yStartPars;
+	computeInnerTurnCoords(iStart, jStart, i, j, xStartPars, yStartPars, 1);
+	RooSlimFitResult *rStartPars = mycurveResults2d[xStartPars-1][yStartPars-1];
+	if ( rStartPars ) setParameters(w, parsName, rStartPars);
+	getParameterBinding()->loadErrors(startParsErrors);
+
+	// alternative choice for start parameters: always from what we found at function call
+	// setParameters(w, parsName, startPars->get(0));
+
+	return fitScanBin2d(i, j);
+}
+
+///
+/// Helper function for scan2d(). Fits the scan point at the center of
+/// a bin of hCL2d, starting from the current parameter values.
+///
+/// \param i, j - bin coordinates of the scan point
+/// \return the fit result, caller takes ownership
+///
+RooSlimFitResult* MethodProbScan::fitScanBin2d(int i, int j)
+{
+	// set scan point
+	w->var(scanVar1)->setVal(hCL2d->GetXaxis()->GetBinCenter(i));
+	w->var(scanVar2)->setVal(hCL2d->GetYaxis()->GetBinCenter(j));
+
+	// fit!
+	RooFitResult *fr;
+	if ( !arg->probforce ) fr = fitToMinBringBackAngles(w->pdf(pdfName), false, -1, getMinimizerSession());
+	else                   fr = fitToMinForce(w, combiner->getPdfName(), "", getMinimizerSession(), arg);
+	RooSlimFitResult *r = new RooSlimFitResult(fr); // try to save memory by using the slim fit result
+	delete fr;
+	return r;
+}
+
+///
+/// Helper function for scan2d(). Fits all points of one ring of the
+/// scan spiral. As each point only depends on the previous ring, the
+/// points are fitted in parallel if --nthreads is given.
+///
+/// RooMinuit keeps its fitter in a static data member, so the workers
+/// are forked processes, each holding a private copy of the workspace.
+/// Each worker fits every nWorkers-th point of the ring, and passes its
+/// fit results back through a temporary root file. The results don't
+/// depend on the number of workers.
+///
+/// \param iStart, jStart    - center of the spiral
+/// \param ringI, ringJ      - bin coordinates of the points of the ring
+/// \param mycurveResults2d  - fit results of the current scan, provide the start parameters
+/// \param results           - return value: one fit result per point, caller takes ownership
+///
+void MethodProbScan::fitRing2d(int iStart, int jStart, const vector<int> &ringI, const vector<int> &ringJ,
+		vector<vector<RooSlimFitResult*> > &mycurveResults2d, vector<RooSlimFitResult*> &results)
+{
+	results.clear();
+	int nPoints = ringI.size();
+	int nWorkers = TMath::Min(arg->nthreads, nPoints);
+	if ( nWorkers<=1 ){
+		for ( int k=0; k<nPoints; k++ ){
+			results.push_back(fitScanPoint2d(iStart, jStart, ringI[k], ringJ[k], mycurveResults2d));
+		}
+		return;
+	}
+
+	// start the workers
+	vector<TString> fNames;
+	vector<pid_t> pids;
+	cout.flush();
+	fflush(stdout);
+	for ( int iWorker=0; iWorker<nWorkers; iWorker++ )
+	{
+		TString fName = Form("%s/gammacombo_scan2d_%i_worker%i.root", gSystem->TempDirectory(), getpid(), iWorker);
+		pid_t pid = fork();
+		if ( pid<0 ){
+			cout << "MethodProbScan::fitRing2d() : ERROR : couldn't start worker " << iWorker << ". Exit." << endl;
+			exit(1);
+		}
+		if ( pid==0 ){
+			// worker process
+			isWorkerProcess = true;
+			TFile f(fName, "recreate");
+			for ( int k=iWorker; k<nPoints; k+=nWorkers ){
+				RooSlimFitResult *r = fitScanPoint2d(iStart, jStart, ringI[k], ringJ[k], mycurveResults2d);
+				f.WriteObject(r, Form("r%i",k));
+				delete r;
+			}
+			f.Close();
+			cout.flush();
+			fflush(stdout);
+			_exit(0); // don't run any ROOT cleanup in the worker
+		}
+		fNames.push_back(fName);
+		pids.push_back(pid);
+	}
+
+	// collect the results in the order of the ring
+	vector<TFile*> files;
+	for ( int iWorker=0; iWorker<nWorkers; iWorker++ )
+	{
+		int status;
+		waitpid(pids[iWorker], &status, 0);
+		TFile *f = 0;
+		if ( WIFEXITED(status) && WEXITSTATUS(status)==0 ) f = TFile::Open(fNames[iWorker]);
+		if ( !f || f->IsZombie() ){
+			cout << "MethodProbScan::fitRing2d() : ERROR : worker " << iWorker << " failed. Exit." << endl;
+			exit(1);
+		}
+		files.push_back(f);
+	}
+	for ( int k=0; k<nPoints; k++ ){
+		RooSlimFitResult *r = (RooSlimFitResult*)files[k%nWorkers]->Get(Form("r%i",k));
+		if ( !r ){
+			cout << "MethodProbScan::fitRing2d() : ERROR : fit result of point " << k << " is missing. Exit." << endl;
+			exit(1);
+		}
+		results.push_back(r);
+	}
+	for ( int iWorker=0; iWorker<nWorkers; iWorker++ ){
+		files[iWorker]->Close();
+		delete files[iWorker];
+		gSystem->Unlink(fNames[iWorker]);
+	}
+
+	// leave the workspace in a defined state, like after a serial scan
+	setParameters(w, parsName, results[nPoints-1]);
+}
+
+///
+/// Helper function for scan2d(). Books a fit result of the scan:
+/// adds it to allResults, updates the global minimum, and if it is
+/// better than what we had before in that bin, saves it into the
+/// hCL2d and hChi2min2d histograms and into curveResults2d.
+///
+/// The positions in allResults of the new result and of the curve
+/// result of each bin are kept in scanResultIndex2d and
+/// curveResultIndex2d. A curve result of an earlier scan that is
+/// replaced here isn't referenced anymore, and is deleted right away.
+/// The new result is released by releaseScanResult2d(). Interpolated
+/// bins of scan2dAdaptive() are always replaced.
+///
+/// \param r    - the fit result
+/// \param i, j - bin coordinates of the scan point
+/// \param ndof - number of degrees of freedom used to compute 1-CL
+///
+void MethodProbScan::storeScanResult2d(RooSlimFitResult *r, int i, int j, int ndof)
+{
+	int k = allResults.size();
+	allResults.push_back(r);
+	scanResultIndex2d[i-1][j-1] = k;
+	double chi2minScan = r->minNll();
+
+	// If we find a new global minumum, this means that all
+	// previous 1-CL values are too high. We'll save the new possible solution, adjust the global
+	// minimum, return a status code, and stop.
+	if ( chi2minScan > -500 && chi2minScan<chi2minGlobal ){
+		// warn only if there was a significant improvement
+		if ( arg->debug || chi2minScan<chi2minGlobal-1e-2 ){
+			if ( arg->verbose ) cout << "MethodProbScan::scan2d() : WARNING : '" << title << "' new global minimum found! chi2minGlobal="
+				<< chi2minGlobal << " chi2minScan=" << chi2minScan << endl;
+		}
+		chi2minGlobal = chi2minScan;
+		// recompute previous 1-CL values
+		for ( int k=1; k<=hCL2d->GetNbinsX(); k++ )
+			for ( int l=1; l<=hCL2d->GetNbinsY(); l++ ){
+				hCL2d->SetBinContent(k, l, TMath::Prob(hChi2min2d->GetBinContent(k,l)-chi2minGlobal, ndof));
+			}
+	}
+
+	double deltaChi2 = chi2minScan - chi2minGlobal;
+	double oneMinusCL = TMath::Prob(deltaChi2, ndof);
+
+	// Save the 1-CL value. But only if better than before!
+	if ( interpolated2d[i-1][j-1] || hCL2d->GetBinContent(i, j) < oneMinusCL ){
+		interpolated2d[i-1][j-1] = false;
+		hCL2d->SetBinContent(i, j, oneMinusCL);
+		hChi2min2d->SetBinContent(i, j, chi2minScan);
+		// Results that were loaded from a file, or whose curveResults2d
+		// were reset by initScan(), are not ours to delete.
+		RooSlimFitResult *rOld = curveResults2d[i-1][j-1];
+		int kOld = curveResultIndex2d[i-1][j-1];
+		if ( rOld && kOld>=0 && allResults[kOld]==rOld ){
+			delete rOld;
+			allResults[kOld] = 0;
+		}
+		curveResults2d[i-1][j-1] = r;
+		curveResultIndex2d[i-1][j-1] = k;
+	}
+}
+
+///
+/// Helper function for scan2dAdaptive(). Fits one bin, books the
+/// result, and remembers it for the start parameters of later fits.
+///
+/// \param i, j   - bin coordinates, starting at 0
+/// \param fitted - fit results of this scan, index = bin-1
+///
+void MethodProbScan::fitAdaptiveBin2d(int i, int j, int ndof, vector<vector<RooSlimFitResult*> > &fitted,
+		double &bestMinFoundInScan)
+{
+	RooSlimFitResult *r = fitScanBin2d(i+1, j+1);
+	fitted[i][j] = r;
+	storeScanResult2d(r, i+1, j+1, ndof);
+	bestMinFoundInScan = TMath::Min((double)r->minNll(), bestMinFoundInScan);
+}
+
+///
+/// Helper function for scan2dAdaptive(). Checks if a block needs to be
+/// refined: if the chi2 at its corners brackets one of the contour
+/// levels, the 1, 2, 3 sigma levels for one and for two degrees of
+/// freedom, if its lowest corner is inside the outermost level, or if a
+/// bin on its edges, fitted for a neighboring block, differs from the
+/// interpolation of the corners by more than one unit of chi2.
+///
+bool MethodProbScan::bracketsContour2d(const AdaptiveBlock2d &b, const vector<vector<RooSlimFitResult*> > &fitted) const
+{
+	double levels[6] = {1., 4., 9., 2.30, 6.18, 11.83};
+	double corners[4] = {fitted[b.i0][b.j0]->minNll(), fitted[b.i1][b.j0]->minNll(),
+		fitted[b.i0][b.j1]->minNll(), fitted[b.i1][b.j1]->minNll()};
+	double lo = corners[0];
+	double hi = corners[0];
+	for ( int k=1; k<4; k++ ){
+		lo = TMath::Min(lo, corners[k]);
+		hi = TMath::Max(hi, corners[k]);
+	}
+	lo -= chi2minGlobal;
+	hi -= chi2minGlobal;
+	for ( int l=0; l<6; l++ ){
+		if ( lo<=levels[l] && levels[l]<=hi ) return true;
+	}
+	if ( lo<=levels[5] ) return true;
+	for ( int i=b.i0; i<=b.i1; i++ )
+		for ( int j=b.j0; j<=b.j1; j++ ){
+			if ( !fitted[i][j] ) continue;
+			if ( fabs(fitted[i][j]->minNll()-interpolateBlock2d(b, fitted, i, j))>1. ) return true;
+		}
+	return false;
+}
+
+///
+/// Helper function for scan2dAdaptive(). Bilinear interpolation of
+/// the chi2 at the corners of a block.
+///
+/// \param i, j - bin coordinates inside the block, starting at 0
+///
+double MethodProbScan::interpolateBlock2d(const AdaptiveBlock2d &b, const vector<vector<RooSlimFitResult*> > &fitted, int i, int j) const
+{
+	double c00 = fitted[b.i0][b.j0]->minNll();
+	double c10 = fitted[b.i1][b.j0]->minNll();
+	double c01 = fitted[b.i0][b.j1]->minNll();
+	double c11 = fitted[b.i1][b.j1]->minNll();
+	double u = b.i1>b.i0 ? (double)(i-b.i0)/(double)(b.i1-b.i0) : 0.;
+	double v = b.j1>b.j0 ? (double)(j-b.j0)/(double)(b.j1-b.j0) : 0.;
+	return (1.-u)*(1.-v)*c00 + u*(1.-v)*c10 + (1.-u)*v*c01 + u*v*c11;
+}
+
+///
+/// Helper function for scan2d(). Adaptive 2d scan (--probadaptive2d N).
+///
+/// First, only every N-th bin of hCL2d in each direction is fitted,
+/// the last one, and the row and column of the start point. These points
+/// are fitted ring by ring around the start point, which is fitted first,
+/// from the start parameters. Each other point takes its start parameters
+/// from the neighbor one ring further in. The coarse grid defines
+/// blocks of bins, not all of the same size. A block is split into four,
+/// two at the smallest size, if the chi2 at its corners brackets one of
+/// the contour levels, if it reaches inside the outermost level, or if
+/// the interpolation of its corners is off, see bracketsContour2d(). The
+/// new points, at the middles of the edges and the center, start from the
+/// closest corner. Splitting repeats, also after a new global minimum
+/// was found, until no block needs it or all of those are single bins.
+/// So only the region far outside of the contours stays at the coarse
+/// resolution.
+///
+/// The bins that were not fitted are filled by bilinear interpolation of
+/// the chi2 at the corners of their block, and have no entry in
+/// curveResults2d. They are replaced by any later fit of the bin, see
+/// storeScanResult2d(). The fits run serially, --nthreads is ignored.
+///
+/// \param iStart, jStart      - bin coordinates of the start point
+/// \param ndof                - number of degrees of freedom used to compute 1-CL
+/// \param bestMinFoundInScan  - return value: smallest chi2 found
+///
+void MethodProbScan::scan2dAdaptive(int iStart, int jStart, int ndof, double &bestMinFoundInScan)
+{
+	int step = arg->probadaptive2d;
+	vector<vector<RooSlimFitResult*> > fitted(nPoints2dx, vector<RooSlimFitResult*>(nPoints2dy, (RooSlimFitResult*)0));
+	int nFits = 0;
+
+	// coarse grid
+	vector<int> coarseI, coarseJ;
+	for ( int i=0; i<nPoints2dx; i+=step ) coarseI.push_back(i);
+	if ( coarseI.back()!=nPoints2dx-1 ) coarseI.push_back(nPoints2dx-1);
+	for ( int j=0; j<nPoints2dy; j+=step ) coarseJ.push_back(j);
+	if ( coarseJ.back()!=nPoints2dy-1 ) coarseJ.push_back(nPoints2dy-1);
+	int ciStart = 0;
+	while ( coarseI[ciStart]<iStart-1 ) ciStart++;
+	if ( coarseI[ciStart]!=iStart-1 ) coarseI.insert(coarseI.begin()+ciStart, iStart-1);
+	int cjStart = 0;
+	while ( coarseJ[cjStart]<jStart-1 ) cjStart++;
+	if ( coarseJ[cjStart]!=jStart-1 ) coarseJ.insert(coarseJ.begin()+cjStart, jStart-1);
+	int nI = coarseI.size();
+	int nJ = coarseJ.size();
+	int nRings = TMath::Max(TMath::Max(ciStart, nI-1-ciStart), TMath::Max(cjStart, nJ-1-cjStart));
+	for ( int ring=0; ring<=nRings; ring++ ){
+		for ( int ci=0; ci<nI; ci++ )
+			for ( int cj=0; cj<nJ; cj++ ){
+				if ( TMath::Max(abs(ci-ciStart), abs(cj-cjStart))!=ring ) continue;
+				if ( ring==0 ) getParameterBinding()->load(startParsValues);
+				else {
+					int ciIn = ci - (ci>ciStart) + (ci<ciStart);
+					int cjIn = cj - (cj>cjStart) + (cj<cjStart);
+					getParameterBinding()->load(fitted[coarseI[ciIn]][coarseJ[cjIn]]);
+				}
+				fitAdaptiveBin2d(coarseI[ci], coarseJ[cj], ndof, fitted, bestMinFoundInScan);
+				nFits++;
+			}
+		cout << Form("MethodProbScan::scan2d() : coarse grid %3.0f%%", (float)(ring+1)/(float)(nRings+1)*100.)
+			<< "       \r" << flush;
+	}
+	cout << endl;
+
+	// refine blocks that bracket a contour
+	vector<AdaptiveBlock2d> blocks;
+	for ( int ci=0; ci<nI-1; ci++ )
+		for ( int cj=0; cj<nJ-1; cj++ ){
+			AdaptiveBlock2d b;
+			b.i0 = coarseI[ci];
+			b.i1 = coarseI[ci+1];
+			b.j0 = coarseJ[cj];
+			b.j1 = coarseJ[cj+1];
+			blocks.push_back(b);
+		}
+	bool changed = true;
+	while ( changed )
+	{
+		changed = false;
+		vector<AdaptiveBlock2d> next;
+		for ( int k=0; k<blocks.size(); k++ )
+		{
+			AdaptiveBlock2d b = blocks[k];
+			if ( (b.i1-b.i0<=1 && b.j1-b.j0<=1) || !bracketsContour2d(b, fitted) ){
+				next.push_back(b);
+				continue;
+			}
+			changed = true;
+			vector<int> is, js;
+			is.push_back(b.i0);
+			if ( b.i1-b.i0>1 ) is.push_back((b.i0+b.i1)/2);
+			is.push_back(b.i1);
+			js.push_back(b.j0);
+			if ( b.j1-b.j0>1 ) js.push_back((b.j0+b.j1)/2);
+			js.push_back(b.j1);
+			for ( int ii=0; ii<is.size(); ii++ )
+				for ( int jj=0; jj<js.size(); jj++ ){
+					int i = is[ii];
+					int j = js[jj];
+					if ( fitted[i][j] ) continue;
+					// start from the closest corner
+					int iCorner = abs(i-b.i0)<=abs(i-b.i1) ? b.i0 : b.i1;
+					int jCorner = abs(j-b.j0)<=abs(j-b.j1) ? b.j0 : b.j1;
+					getParameterBinding()->load(fitted[iCorner][jCorner]);
+					fitAdaptiveBin2d(i, j, ndof, fitted, bestMinFoundInScan);
+					nFits++;
+				}
+			for ( int ii=0; ii<is.size()-1; ii++ )
+				for ( int jj=0; jj<js.size()-1; jj++ ){
+					AdaptiveBlock2d c;
+					c.i0 = is[ii];
+					c.i1 = is[ii+1];
+					c.j0 = js[jj];
+					c.j1 = js[jj+1];
+					next.push_back(c);
+				}
+		}
+		blocks = next;
+		if ( arg->verbose ) cout << "MethodProbScan::scan2d() : refined to " << blocks.size() << " blocks, "
+			<< nFits << " fits" << endl;
+	}
+
+	// interpolate the bins that were not fitted
+	for ( int k=0; k<blocks.size(); k++ )
+	{
+		const AdaptiveBlock2d &b = blocks[k];
+		for ( int i=b.i0; i<=b.i1; i++ )
+			for ( int j=b.j0; j<=b.j1; j++ ){
+				if ( fitted[i][j] ) continue;
+				double chi2 = interpolateBlock2d(b, fitted, i, j);
+				if ( curveResults2d[i][j] ) continue;
+				if ( !interpolated2d[i][j] && hChi2min2d->GetBinContent(i+1, j+1)<=chi2 ) continue;
+				interpolated2d[i][j] = true;
+				hChi2min2d->SetBinContent(i+1, j+1, chi2);
+				hCL2d->SetBinContent(i+1, j+1, TMath::Prob(chi2-chi2minGlobal, ndof));
+			}
+	}
+	cout << "MethodProbScan::scan2d() : adaptive scan: " << nFits << " fits for "
+		<< nPoints2dx*nPoints2dy << " scan points." << endl;
+}
+
 void MethodProbScan::sanityChecks()
 {
 	if ( !w->set(parsName) ){
@@ -377,7 +1195,8 @@ void MethodProbScan::sanityChecks()
 /// Fills the hCL2d histogram with the 1-CL curve.
 /// Saves all encountered fit results to allResults.
 /// Saves the fit results that make it into the 1-CL curve into curveResults2d.
-/// Scan strategy: Spiral out!
+/// Scan strategy: Spiral out! With --probadaptive2d, refine a coarse grid
+/// only where the contours are, see scan2dAdaptive().
 ///
 int MethodProbScan::scan2d()
 {
@@ -400,10 +1219,15 @@ int MethodProbScan::scan2d()
 		for ( int j=0; j<nPoints2dy; j++ ) tmp.push_back(0);
 		mycurveResults2d.push_back(tmp);
 	}
+	scanResultIndex2d.assign(nPoints2dx, vector<int>(nPoints2dy, -1));
+	if ( curveResultIndex2d.size()!=nPoints2dx ) curveResultIndex2d.assign(nPoints2dx, vector<int>(nPoints2dy, -1));
+	if ( interpolated2d.size()!=nPoints2dx ) interpolated2d.assign(nPoints2dx, vector<bool>(nPoints2dy, false));
 
 	// store start parameters so we can reset them later
 	startPars = new RooDataSet("startPars", "startPars", *w->set(parsName));
 	startPars->add(*w->set(parsName));
+	getParameterBinding()->store(startParsValues);
+	getParameterBinding()->storeErrors(startParsErrors);
 
 	// // start scan from global minimum (not always a good idea as we need to set from other places as well)
 	// setParameters(w, parsName, globalMin);
@@ -455,145 +1279,136 @@ int MethodProbScan::scan2d()
 
 	// timer
 	TStopwatch tFit;
-	TStopwatch tSlimResult;
 	TStopwatch tScan;
 	TStopwatch tMemory;
 
-	// set up the scan spiral
-	int X = 2*nPoints2dx;
-	int Y = 2*nPoints2dy;
-	int x,y,dx,dy;
-	x = y = dx = 0;
-	dy = -1;
-	int t = std::max(X,Y);
-	int maxI = t*t;
-	for ( int spiralstep=0; spiralstep<maxI; spiralstep++ )
-	{
-		if ((-X/2 <= x) && (x <= X/2) && (-Y/2 <= y) && (y <= Y/2))
+	if ( arg->probadaptive2d>0 ){
+		tScan.Start(false);
+		tFit.Start(false);
+		scan2dAdaptive(iStart, jStart, ndof, bestMinFoundInScan);
+		tFit.Stop();
+		tScan.Stop();
+		for ( int k=1; k<=hChi2min2d->GetNbinsX(); k++ )
+			for ( int l=1; l<=hChi2min2d->GetNbinsY(); l++ ) hDbgChi2min2d->SetBinContent(k, l, hChi2min2d->GetBinContent(k,l));
+		hDbgChi2min2d->Draw("colz");
+		startpointmark->Draw();
+		cDbg->Update();
+	}
+	else {
+		// Set up the scan spiral. The spiral visits the rings around the start
+		// point one after the other. Each point takes its start parameters from
+		// the previous ring (see computeInnerTurnCoords()), so all points of one
+		// ring can be fitted independently of each other: we collect the points
+		// of a ring, fit them all at once in fitRing2d(), possibly in parallel,
+		// and then book the results in spiral order.
+		int X = 2*nPoints2dx;
+		int Y = 2*nPoints2dy;
+		int x,y,dx,dy;
+		x = y = dx = 0;
+		dy = -1;
+		int t = std::max(X,Y);
+		int maxI = t*t;
+		int ring = 0;
+		vector<int> ringI, ringJ;
+		for ( int spiralstep=0; spiralstep<=maxI; spiralstep++ )
 		{
-			int i = x+iStart;
-			int j = y+jStart;
-			if ( i>0 && i<=nPoints2dx && j>0 && j<=nPoints2dy )
+			// ring complete: fit it, book the results
+			if ( spiralstep==maxI || std::max(abs(x),abs(y))!=ring )
 			{
 				tScan.Start(false);
+				tFit.Start(false);
+				vector<RooSlimFitResult*> ringResults;
+				fitRing2d(iStart, jStart, ringI, ringJ, mycurveResults2d, ringResults);
+				tFit.Stop();
 
-				// status bar
-				if (((int)nSteps % (int)(nTotalSteps/printFreq)) == 0){
-					cout << Form("MethodProbScan::scan2d() : scanning %3.0f%%", (float)nSteps/(float)nTotalSteps*100.)
-															 << "       \r" << flush;
+				for ( int p=0; p<ringI.size(); p++ )
+				{
+					int i = ringI[p];
+					int j = ringJ[p];
+					RooSlimFitResult *r = ringResults[p];
+					double chi2minScan = r->minNll();
+
+					// status bar
+					if (((int)nSteps % (int)(nTotalSteps/printFreq)) == 0){
+						cout << Form("MethodProbScan::scan2d() : scanning %3.0f%%", (float)nSteps/(float)nTotalSteps*100.)
+																 << "       \r" << flush;
+					}
+					nSteps++;
+
+					// status histogram
+					if ( i!=iStart || j!=jStart ) hDbgStart->SetBinContent(i, j, 500./*firstScan ? 1. : hChi2min2dMin+36*/);
+
+					bestMinFoundInScan = TMath::Min((double)chi2minScan, (double)bestMinFoundInScan);
+					mycurveResults2d[i-1][j-1] = r;
+					storeScanResult2d(r, i, j, ndof);
+					if ( curveResults2d[i-1][j-1]==r ) hDbgChi2min2d->SetBinContent(i, j, chi2minScan);
+
+					// draw/update histograms - doing only every 10th update saves
+					// a lot of time for small combinations
+					if ( ( arg->interactive && ((int)nSteps % 10 == 0) ) || nSteps==nTotalSteps ){
+						hDbgChi2min2d->Draw("colz");
+						hDbgStart->Draw("boxsame");
+						startpointmark->Draw();
+						cDbg->Update();
+					}
 				}
-				nSteps++;
-
-				// status histogram
-				if ( spiralstep>0 ) hDbgStart->SetBinContent(i, j, 500./*firstScan ? 1. : hChi2min2dMin+36*/);
-
-				// set start parameters from inner turn of the spiral
-				int xStartPars, yStartPars;
-				computeInnerTurnCoords(iStart, jStart, i, j, xStartPars, yStartPars, 1);
-				RooSlimFitResult *rStartPars = mycurveResults2d[xStartPars-1][yStartPars-1];
-				if ( rStartPars ) setParameters(w, parsName, rStartPars);
 
 				// memory management:
-				tMemory.Start(false);
 				// delete old, inner fit results, that we don't need for start parameters anymore
 				// for this we take the second-inner-most turn.
-				int iOld, jOld;
-				bool innerTurnExists = computeInnerTurnCoords(iStart, jStart, i, j, iOld, jOld, 2);
-				if ( innerTurnExists ){
-					deleteIfNotInCurveResults2d(mycurveResults2d[iOld-1][jOld-1]);
-					mycurveResults2d[iOld-1][jOld-1] = 0;
-				}
-				tMemory.Stop();
-
-				// alternative choice for start parameters: always from what we found at function call
-				// setParameters(w, parsName, startPars->get(0));
-
-				// set scan point
-				float scanvalue1 = hCL2d->GetXaxis()->GetBinCenter(i);
-				float scanvalue2 = hCL2d->GetYaxis()->GetBinCenter(j);
-				par1->setVal(scanvalue1);
-				par2->setVal(scanvalue2);
-
-				// fit!
-				tFit.Start(false);
-				RooFitResult *fr;
-				if ( !arg->probforce ) fr = fitToMinBringBackAngles(w->pdf(pdfName), false, -1);
-				else                   fr = fitToMinForce(w, combiner->getPdfName());
-				double chi2minScan = fr->minNll();
-				tFit.Stop();
-				tSlimResult.Start(false);
-				RooSlimFitResult *r = new RooSlimFitResult(fr); // try to save memory by using the slim fit result
-				tSlimResult.Stop();
-				delete fr;
-				allResults.push_back(r);
-				bestMinFoundInScan = TMath::Min((double)chi2minScan, (double)bestMinFoundInScan);
-				mycurveResults2d[i-1][j-1] = r;
-
-				// If we find a new global minumum, this means that all
-				// previous 1-CL values are too high. We'll save the new possible solution, adjust the global
-				// minimum, return a status code, and stop.
-				if ( chi2minScan > -500 && chi2minScan<chi2minGlobal ){
-					// warn only if there was a significant improvement
-					if ( arg->debug || chi2minScan<chi2minGlobal-1e-2 ){
-						if ( arg->verbose ) cout << "MethodProbScan::scan2d() : WARNING : '" << title << "' new global minimum found! chi2minGlobal="
-															<< chi2minGlobal << " chi2minScan=" << chi2minScan << endl;
+				tMemory.Start(false);
+				for ( int p=0; p<ringI.size(); p++ ){
+					int iOld, jOld;
+					bool innerTurnExists = computeInnerTurnCoords(iStart, jStart, ringI[p], ringJ[p], iOld, jOld, 2);
+					if ( innerTurnExists ){
+						releaseScanResult2d(iOld, jOld);
+						mycurveResults2d[iOld-1][jOld-1] = 0;
 					}
-					chi2minGlobal = chi2minScan;
-					// recompute previous 1-CL values
-					for ( int k=1; k<=hCL2d->GetNbinsX(); k++ )
-						for ( int l=1; l<=hCL2d->GetNbinsY(); l++ ){
-							hCL2d->SetBinContent(k, l, TMath::Prob(hChi2min2d->GetBinContent(k,l)-chi2minGlobal, ndof));
-						}
 				}
+				tMemory.Stop();
+				tScan.Stop();
 
-				double deltaChi2 = chi2minScan - chi2minGlobal;
-				double oneMinusCL = TMath::Prob(deltaChi2, ndof);
-
-				// Save the 1-CL value. But only if better than before!
-				if ( hCL2d->GetBinContent(i, j) < oneMinusCL ){
-					hCL2d->SetBinContent(i, j, oneMinusCL);
-					hChi2min2d->SetBinContent(i, j, chi2minScan);
-					hDbgChi2min2d->SetBinContent(i, j, chi2minScan);
-					curveResults2d[i-1][j-1] = r;
-				}
+				ringI.clear();
+				ringJ.clear();
+				ring = std::max(abs(x),abs(y));
+				if ( spiralstep==maxI ) break;
+			}
 
-				// draw/update histograms - doing only every 10th update saves
-				// a lot of time for small combinations
-				if ( ( arg->interactive && ((int)nSteps % 10 == 0) ) || nSteps==nTotalSteps ){
-					hDbgChi2min2d->Draw("colz");
-					hDbgStart->Draw("boxsame");
-					startpointmark->Draw();
-					cDbg->Update();
+			if ((-X/2 <= x) && (x <= X/2) && (-Y/2 <= y) && (y <= Y/2))
+			{
+				int i = x+iStart;
+				int j = y+jStart;
+				if ( i>0 && i<=nPoints2dx && j>0 && j<=nPoints2dy )
+				{
+					ringI.push_back(i);
+					ringJ.push_back(j);
 				}
-				tScan.Stop();
 			}
+			// spiral stuff:
+			if( (x == y) || ((x < 0) && (x == -y)) || ((x > 0) && (x == 1-y)))
+			{
+				t = dx;
+				dx = -dy;
+				dy = t;
+			}
+			x += dx;
+			y += dy;
 		}
-		// spiral stuff:
-		if( (x == y) || ((x < 0) && (x == -y)) || ((x > 0) && (x == 1-y)))
-		{
-			t = dx;
-			dx = -dy;
-			dy = t;
-		}
-		x += dx;
-		y += dy;
 	}
 	cout << "MethodProbScan::scan2d() : scan done.            " << endl;
 	if ( arg->debug ){
 		cout << "MethodProbScan::scan2d() : full scan time:             "; tScan.Print();
 		cout << "MethodProbScan::scan2d() : - fitting:                  "; tFit.Print();
-		cout << "MethodProbScan::scan2d() : - create RooSlimFitResults: "; tSlimResult.Print();
 		cout << "MethodProbScan::scan2d() : - memory management:        "; tMemory.Print();
 	}
-	setParameters(w, parsName, startPars->get(0));
+	getParameterBinding()->load(startParsValues);
 	saveSolutions2d();
 	if ( arg->debug ) printLocalMinima();
 	confirmSolutions();
 
 	// clean all fit results that didn't make it into the final result
-	for ( int i=0; i<allResults.size(); i++ ){
-		deleteIfNotInCurveResults2d(allResults[i]);
-	}
+	for ( int i=1; i<=nPoints2dx; i++ )
+		for ( int j=1; j<=nPoints2dy; j++ ) releaseScanResult2d(i, j);
 
 	if ( bestMinFoundInScan-bestMinOld > 0.1 )
 	{
@@ -0,0 +1,142 @@
+#include "MinimizerSession.h"
+#include "Utils.h"
+
+MinimizerSession* MinimizerSession::attached = 0;
+
+///
+/// Create a session that minimizes -2*log(pdf). If the PDF provides
+/// a native chi2 (see Utils::findGausChi2Var()), that one is used
+/// instead.
+///
+MinimizerSession::MinimizerSession(RooAbsPdf *pdf)
+{
+	this->pdf = pdf;
+	llFormula = 0;
+	fcn = Utils::findGausChi2Var(pdf);
+	if ( !fcn ){
+		llFormula = new RooFormulaVar("ll", "ll", "-2*log(@0)", RooArgSet(*pdf));
+		fcn = llFormula;
+	}
+	init();
+}
+
+///
+/// Create a session that minimizes the given function.
+///
+MinimizerSession::MinimizerSession(RooAbsReal *fcn)
+{
+	this->pdf = 0;
+	this->fcn = fcn;
+	llFormula = 0;
+	init();
+}
+
+MinimizerSession::~MinimizerSession()
+{
+	if ( minuit ) delete minuit;
+	if ( attached==this ) attached = 0;
+	if ( llFormula ) delete llFormula;
+}
+
+void MinimizerSession::init()
+{
+	minuit = 0;
+	nFloatBuilt = 0;
+	nBuilds = 0;
+	errorLevel = 1.0;
+	printLevel = -1;
+	strategy = 2;
+	logFile = "";
+	status = -1;
+	chi2 = 0.0;
+	edm = 0.0;
+	covQual = -1;
+	nFloat = 0;
+	RooArgSet *pars = fcn->getParameters(RooArgSet());
+	TIterator* it = pars->createIterator();
+	while ( RooAbsArg* p = (RooAbsArg*)it->Next() ){
+		if ( p->InheritsFrom("RooRealVar") ) parameters.add(*p);
+	}
+	delete it;
+	delete pars;
+}
+
+///
+/// Count the parameters of the function that are currently floating.
+///
+int MinimizerSession::countFloating() const
+{
+	int n = 0;
+	for ( int i=0; i<parameters.getSize(); i++ ){
+		if ( !((RooRealVar*)parameters.at(i))->isConstant() ) n++;
+	}
+	return n;
+}
+
+///
+/// Make sure this session's RooMinuit object owns the static TFitter,
+/// and that the TFitter is large enough. Rebuild it otherwise.
+///
+void MinimizerSession::attach()
+{
+	int n = countFloating();
+	if ( minuit && attached==this && n<=nFloatBuilt ) return;
+	if ( minuit ) delete minuit;
+	minuit = new RooMinuit(*fcn);
+	nFloatBuilt = n;
+	nBuilds++;
+	attached = this;
+}
+
+///
+/// Run MIGRAD, and HESSE if requested. Starting values, constant flags
+/// and limits are taken from the current state of the parameters.
+/// After the fit the parameters are at the minimum.
+///
+/// \param thorough - also run HESSE
+/// \return status of the last minimization step
+///
+int MinimizerSession::fit(bool thorough)
+{
+	RooMsgService::instance().setGlobalKillBelow(ERROR);
+	attach();
+	if ( printLevel<0 ){
+		minuit->setPrintLevel(-2);
+		minuit->setNoWarn();
+	}
+	else minuit->setPrintLevel(1);
+	if ( logFile!="" ) minuit->setLogFile(logFile);
+	minuit->setErrorLevel(errorLevel);
+	minuit->setStrategy(strategy);
+	minuit->setProfile(0); // 1 enables migrad timer
+	status = minuit->migrad();
+	if ( thorough ) status = minuit->hesse();
+	nFloat = countFloating();
+	if ( nFloat>0 ){
+		double fmin, fedm, errdef;
+		int npari, nparx, istat;
+		gMinuit->mnstat(fmin, fedm, errdef, npari, nparx, istat);
+		chi2 = fmin;
+		edm = fedm;
+		covQual = istat;
+	}
+	else{
+		chi2 = fcn->getVal();
+		edm = 0.0;
+		covQual = -1;
+	}
+	RooMsgService::instance().setGlobalKillBelow(INFO);
+	return status;
+}
+
+///
+/// Create a RooFitResult of the last fit. The caller takes ownership.
+///
+RooFitResult* MinimizerSession::save()
+{
+	if ( !minuit || attached!=this ){
+		cout << "MinimizerSession::save() : ERROR : the last fit was not performed by this session. Exit." << endl;
+		exit(1);
+	}
+	return minuit->save();
+}
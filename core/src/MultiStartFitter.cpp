@@ -0,0 +1,444 @@
+#include "MultiStartFitter.h"
+
+UInt_t MultiStartFitter::nLatinHypercubes = 0;
+
+// Direction numbers of the Sobol sequence for dimensions 2 to 16,
+// from S. Joe and F. Y. Kuo, SIAM J. Sci. Comput. 30, 2635 (2008).
+// Dimension 1 is the van der Corput sequence.
+static const int sobolMaxDim = 16;
+static const int sobolS[sobolMaxDim-1] = {1, 2, 3, 3, 4, 4, 5, 5, 5, 5, 5, 5, 6, 6, 6};
+static const int sobolA[sobolMaxDim-1] = {0, 1, 1, 2, 1, 4, 2, 4, 7, 11, 13, 14, 1, 13, 16};
+static const int sobolM[sobolMaxDim-1][6] = {
+	{1}, {1,3}, {1,3,1}, {1,1,1}, {1,1,3,3}, {1,3,5,13},
+	{1,1,5,5,17}, {1,1,5,5,5}, {1,1,7,11,19}, {1,1,5,1,1}, {1,1,1,3,11},
+	{1,3,5,5,31}, {1,3,3,9,7,49}, {1,1,1,15,21,21}, {1,3,1,13,27,49}};
+
+///
+/// \param w - workspace holding the PDF
+/// \param name - name of the PDF without leading "pdf_"
+/// \param session - minimizer to be used, a new one is created if not given
+///                  or if it belongs to another PDF
+///
+MultiStartFitter::MultiStartFitter(RooWorkspace *w, TString name, MinimizerSession *session)
+{
+	this->w = w;
+	this->name = name;
+	parsName = "par_"+name;
+	pdfName  = "pdf_"+name;
+	if ( !w->set(parsName) ){
+		cout << "MultiStartFitter::MultiStartFitter() : ERROR : parsName not found: " << parsName << ". Exit." << endl;
+		exit(1);
+	}
+	this->session = session;
+	ownSession = false;
+	if ( !session || session->getPdf()!=w->pdf(pdfName) ){
+		this->session = new MinimizerSession(w->pdf(pdfName));
+		ownSession = true;
+	}
+	binding = new ParameterBinding(w->set(parsName));
+	forceVariables = "";
+	startSet = kCorners;
+	nStarts = -1;
+	nWorkers = 0;
+	abandonMargin = -1.;
+	nErrors = 0;
+	nAbandoned = 0;
+}
+
+MultiStartFitter::~MultiStartFitter()
+{
+	if ( ownSession ) delete session;
+	delete binding;
+}
+
+///
+/// Choose the start points.
+///
+/// \param s - "corners": all corners of the ranges of the varied parameters,
+///            "lhs": a Latin hypercube, "sobol": a Sobol sequence
+///
+void MultiStartFitter::setStartSet(TString s)
+{
+	if ( s=="corners" ) startSet = kCorners;
+	else if ( s=="lhs" ) startSet = kLatinHypercube;
+	else if ( s=="sobol" ) startSet = kSobol;
+	else {
+		cout << "MultiStartFitter::setStartSet() : ERROR : unknown start set '" << s
+			<< "', use 'corners', 'lhs', or 'sobol'. Exit." << endl;
+		exit(1);
+	}
+}
+
+///
+/// Select the parameters to be varied, and get their force ranges.
+/// Default is to vary all angles, all ratios except rD_k3pi and rD_kpi,
+/// and the k3pi coherence factor.
+///
+void MultiStartFitter::selectParameters()
+{
+	varyPars.removeAll();
+	rangeMin.clear();
+	rangeMax.clear();
+	TIterator* it = w->set(parsName)->createIterator();
+	while ( RooRealVar* p = (RooRealVar*)it->Next() )
+	{
+		if ( p->isConstant() ) continue;
+		if ( forceVariables=="" && ( false
+					|| TString(p->GetName()).BeginsWith("d") ///< use these variables
+					// || TString(p->GetName()).BeginsWith("r")
+					|| TString(p->GetName()).BeginsWith("k")
+					|| TString(p->GetName()) == "g"
+					) && ! (
+						TString(p->GetName()) == "rD_k3pi"  ///< don't use these
+						|| TString(p->GetName()) == "rD_kpi"
+						// || TString(p->GetName()) == "dD_kpi"
+						|| TString(p->GetName()) == "d_dk"
+						|| TString(p->GetName()) == "d_dsk"
+						))
+		{
+			varyPars.add(*p);
+		}
+		else if ( forceVariables.Contains(TString(p->GetName())+",") )
+		{
+			varyPars.add(*p);
+		}
+	}
+	delete it;
+	for ( int ip=0; ip<varyPars.getSize(); ip++ ){
+		RooRealVar *p = (RooRealVar*)varyPars.at(ip);
+		float oldMin = p->getMin();
+		float oldMax = p->getMax();
+		setLimit(w, p->GetName(), "force");
+		rangeMin.push_back(p->getMin());
+		rangeMax.push_back(p->getMax());
+		p->setRange(oldMin, oldMax);
+	}
+}
+
+///
+/// We define a binary mask where each bit corresponds
+/// to parameter at max or at min.
+///
+void MultiStartFitter::makeStartsCorners()
+{
+	int nPars = varyPars.getSize();
+	starts.clear();
+	for ( int i=0; i<pow(2.,nPars); i++ ){
+		vector<double> start(nPars);
+		for ( int ip=0; ip<nPars; ip++ ){
+			start[ip] = i/(int)pow(2.,ip) % 2==0 ? rangeMin[ip] : rangeMax[ip];
+		}
+		starts.push_back(start);
+	}
+}
+
+///
+/// Latin hypercube: the range of each parameter is divided into n
+/// strata, and each stratum is used by exactly one start point.
+/// Each hypercube draws from a stream of its own, numbered by the
+/// hypercubes made before in this process, see CounterRng.
+///
+void MultiStartFitter::makeStartsLatinHypercube(int n)
+{
+	int nPars = varyPars.getSize();
+	CounterRng rnd = CounterRng::stream(0, nLatinHypercubes++, CounterRng::kSubStreamMultiStart);
+	starts.assign(n, vector<double>(nPars));
+	vector<int> perm(n);
+	for ( int ip=0; ip<nPars; ip++ ){
+		for ( int k=0; k<n; k++ ) perm[k] = k;
+		for ( int k=n-1; k>0; k-- ){
+			int l = TMath::Min((int)(rnd.uniform()*(k+1)), k);
+			int tmp = perm[k];
+			perm[k] = perm[l];
+			perm[l] = tmp;
+		}
+		for ( int k=0; k<n; k++ ){
+			starts[k][ip] = rangeMin[ip] + (perm[k]+rnd.uniform())/n*(rangeMax[ip]-rangeMin[ip]);
+		}
+	}
+}
+
+///
+/// Sobol sequence, skipping its first point, which is the lower corner.
+/// Available for up to 16 varied parameters, for more a Latin
+/// hypercube is used.
+///
+void MultiStartFitter::makeStartsSobol(int n)
+{
+	int nPars = varyPars.getSize();
+	if ( nPars>sobolMaxDim ){
+		cout << "MultiStartFitter::makeStartsSobol() : WARNING : Sobol sequence available for up to "
+			<< sobolMaxDim << " parameters, using a Latin hypercube." << endl;
+		makeStartsLatinHypercube(n);
+		return;
+	}
+	const int nBits = 32;
+	vector<vector<unsigned int> > v(nPars, vector<unsigned int>(nBits+1, 0));
+	for ( int ip=0; ip<nPars; ip++ ){
+		if ( ip==0 ){
+			for ( int i=1; i<=nBits; i++ ) v[ip][i] = 1u << (nBits-i);
+			continue;
+		}
+		int s = sobolS[ip-1];
+		int a = sobolA[ip-1];
+		for ( int i=1; i<=s; i++ ) v[ip][i] = (unsigned int)sobolM[ip-1][i-1] << (nBits-i);
+		for ( int i=s+1; i<=nBits; i++ ){
+			v[ip][i] = v[ip][i-s] ^ (v[ip][i-s] >> s);
+			for ( int k=1; k<s; k++ ) v[ip][i] ^= ((a >> (s-1-k)) & 1) * v[ip][i-k];
+		}
+	}
+	starts.assign(n, vector<double>(nPars));
+	vector<unsigned int> x(nPars, 0);
+	for ( int k=1; k<=n; k++ ){
+		// Gray code order: flip the direction number of the lowest zero bit of k-1
+		int c = 1;
+		unsigned int value = k-1;
+		while ( value & 1 ){
+			value >>= 1;
+			c++;
+		}
+		for ( int ip=0; ip<nPars; ip++ ){
+			x[ip] ^= v[ip][c];
+			starts[k-1][ip] = rangeMin[ip] + x[ip]/pow(2.,nBits)*(rangeMax[ip]-rangeMin[ip]);
+		}
+	}
+}
+
+///
+/// Same selection as the original force method: a good fit replaces
+/// a good fit only if its chi2 is smaller, anything replaces a bad fit.
+///
+bool MultiStartFitter::isBetter(const Candidate &c, const Candidate &best) const
+{
+	if ( !c.found ) return false;
+	if ( !best.found || !best.good ) return true;
+	return c.good && c.chi2<best.chi2;
+}
+
+///
+/// Lower the best chi2 shared by all workers, if chi2 is smaller.
+/// The double is compared and swapped as a 64 bit integer, so that
+/// concurrent updates of two workers can't get lost.
+///
+void MultiStartFitter::updateSharedBestChi2(volatile double *sharedBestChi2, double chi2)
+{
+	volatile long long *bits = (volatile long long*)sharedBestChi2;
+	while ( true ){
+		long long oldBits = *bits;
+		double oldChi2;
+		memcpy(&oldChi2, &oldBits, sizeof(double));
+		if ( chi2>=oldChi2 ) return;
+		long long newBits;
+		memcpy(&newBits, &chi2, sizeof(double));
+		if ( __sync_bool_compare_and_swap(bits, oldBits, newBits) ) return;
+	}
+}
+
+///
+/// Fit every nStep-th start point, beginning with iFirst.
+///
+/// \param iFirst - first start point, the number of the worker
+/// \param nStep - fit every nStep-th start point, the number of workers
+/// \param best - receives the best fit, is updated if a better one is found
+/// \param sharedBestChi2 - the best chi2 of a good fit of all workers
+/// \param bestResult - if given, receives the fit result of the best fit,
+///                     the one it held before is deleted if replaced
+///
+void MultiStartFitter::fitStarts(int iFirst, int nStep, Candidate &best, volatile double *sharedBestChi2,
+		RooFitResult **bestResult)
+{
+	int printlevel = -1;
+	int nPars = varyPars.getSize();
+	for ( int i=iFirst; i<starts.size(); i+=nStep )
+	{
+		if ( nStep==1 ) cout << "MultiStartFitter::fit() : fit " << i << "        \r" << flush;
+		binding->load(startValues);
+		for ( int ip=0; ip<nPars; ip++ )
+		{
+			RooRealVar *p = (RooRealVar*)varyPars.at(ip);
+			float oldMin = p->getMin();
+			float oldMax = p->getMax();
+			setLimit(w, p->GetName(), "force");
+			p->setVal(starts[i][ip]);
+			p->setRange(oldMin, oldMax);
+		}
+
+		// check if start parameters are sensible, skip if they're not
+		double startParChi2 = getChi2(w->pdf(pdfName));
+		if ( startParChi2>2000 ){
+			nErrors += 1;
+			continue;
+		}
+
+		// quick fit, abandon the start if it runs into a worse minimum
+		if ( abandonMargin>=0. ){
+			session->setPrintLevel(printlevel);
+			session->setErrorLevel(1.0);
+			session->setStrategy(0);
+			session->fit(false);
+			if ( session->getChi2() > *sharedBestChi2+abandonMargin ){
+				nAbandoned += 1;
+				continue;
+			}
+		}
+
+		// refit
+		fitToMinBringBackAngles(session, false, printlevel);
+		Candidate c;
+		c.found = true;
+		c.good = session->getEdm()<1 && session->getCovQual()==3;
+		c.chi2 = session->getChi2();
+		if ( isBetter(c, best) ){
+			binding->store(c.values);
+			best = c;
+			if ( bestResult ){
+				delete *bestResult;
+				*bestResult = session->save();
+			}
+		}
+		if ( c.good ) updateSharedBestChi2(sharedBestChi2, c.chi2);
+	}
+}
+
+///
+/// Run the fits. The parameters are left at the best minimum.
+///
+/// \return the fit result of the best minimum, the caller takes ownership
+///
+RooFitResult* MultiStartFitter::fit()
+{
+	int printlevel = -1;
+	RooMsgService::instance().setGlobalKillBelow(ERROR);
+	nErrors = 0;
+	nAbandoned = 0;
+
+	selectParameters();
+	int nPars = varyPars.getSize();
+	if ( startSet==kCorners ) makeStartsCorners();
+	else {
+		int n = nStarts>0 ? nStarts : 8*nPars;
+		if ( startSet==kLatinHypercube ) makeStartsLatinHypercube(n);
+		else makeStartsSobol(n);
+	}
+	cout << "MultiStartFitter::fit() : nPars = " << nPars << " => " << starts.size() << " fits" << endl;
+	cout << "MultiStartFitter::fit() : varying ";
+	varyPars.Print();
+
+	// the start parameters of all fits
+	binding->store(startValues);
+
+	// initial fit from the current parameters
+	int nActualWorkers = isWorkerProcess ? 1 : TMath::Min(nWorkers, (int)starts.size());
+	RooFitResult *r = 0;
+	fitToMinBringBackAngles(session, false, printlevel);
+	if ( nActualWorkers<=1 ) r = session->save();
+	Candidate best;
+	best.found = true;
+	best.good = session->getEdm()<1 && session->getCovQual()==3;
+	best.chi2 = session->getChi2();
+	binding->store(best.values);
+
+	// the best chi2, shared with the workers
+	volatile double *sharedBestChi2 = (volatile double*)mmap(0, sizeof(double), PROT_READ|PROT_WRITE, MAP_SHARED|MAP_ANONYMOUS, -1, 0);
+	if ( sharedBestChi2==MAP_FAILED ){
+		cout << "MultiStartFitter::fit() : ERROR : couldn't create shared memory. Exit." << endl;
+		exit(1);
+	}
+	*sharedBestChi2 = best.good ? best.chi2 : 1e300;
+
+	if ( nActualWorkers<=1 ){
+		fitStarts(0, 1, best, sharedBestChi2, &r);
+		cout << endl;
+	}
+	else {
+		vector<FILE*> buffers;
+		vector<pid_t> pids;
+		cout.flush();
+		fflush(stdout);
+		for ( int iWorker=0; iWorker<nActualWorkers; iWorker++ )
+		{
+			FILE *buffer = tmpfile();
+			if ( !buffer ){
+				cout << "MultiStartFitter::fit() : ERROR : couldn't create temporary file. Exit." << endl;
+				exit(1);
+			}
+			pid_t pid = fork();
+			if ( pid<0 ){
+				cout << "MultiStartFitter::fit() : ERROR : couldn't start worker " << iWorker << ". Exit." << endl;
+				exit(1);
+			}
+			if ( pid==0 ){
+				// worker process
+				isWorkerProcess = true;
+				Candidate c;
+				c.found = false;
+				c.good = false;
+				c.chi2 = 0.;
+				fitStarts(iWorker, nActualWorkers, c, sharedBestChi2);
+				int found = c.found;
+				int good = c.good;
+				fwrite(&found, sizeof(int), 1, buffer);
+				fwrite(&good, sizeof(int), 1, buffer);
+				fwrite(&c.chi2, sizeof(double), 1, buffer);
+				fwrite(&nErrors, sizeof(int), 1, buffer);
+				fwrite(&nAbandoned, sizeof(int), 1, buffer);
+				if ( c.found ) fwrite(&c.values[0], sizeof(double), c.values.size(), buffer);
+				fclose(buffer);
+				cout.flush();
+				fflush(stdout);
+				_exit(0); // don't run any ROOT cleanup in the worker
+			}
+			buffers.push_back(buffer);
+			pids.push_back(pid);
+		}
+
+		// collect the results in the order of the workers
+		for ( int iWorker=0; iWorker<nActualWorkers; iWorker++ )
+		{
+			int status;
+			waitpid(pids[iWorker], &status, 0);
+			if ( !WIFEXITED(status) || WEXITSTATUS(status)!=0 ){
+				cout << "MultiStartFitter::fit() : ERROR : worker " << iWorker << " failed. Exit." << endl;
+				exit(1);
+			}
+			FILE *buffer = buffers[iWorker];
+			rewind(buffer);
+			int found, good, nErrorsWorker, nAbandonedWorker;
+			Candidate c;
+			bool ok = fread(&found, sizeof(int), 1, buffer)==1
+				&& fread(&good, sizeof(int), 1, buffer)==1
+				&& fread(&c.chi2, sizeof(double), 1, buffer)==1
+				&& fread(&nErrorsWorker, sizeof(int), 1, buffer)==1
+				&& fread(&nAbandonedWorker, sizeof(int), 1, buffer)==1;
+			c.found = found;
+			c.good = good;
+			if ( ok && c.found ){
+				c.values.resize(binding->getSize());
+				ok = fread(&c.values[0], sizeof(double), c.values.size(), buffer)==c.values.size();
+			}
+			if ( !ok ){
+				cout << "MultiStartFitter::fit() : ERROR : couldn't read the result of worker " << iWorker << ". Exit." << endl;
+				exit(1);
+			}
+			fclose(buffer);
+			nErrors += nErrorsWorker;
+			nAbandoned += nAbandonedWorker;
+			if ( isBetter(c, best) ) best = c;
+		}
+	}
+	munmap((void*)sharedBestChi2, sizeof(double));
+
+	cout << "MultiStartFitter::fit() : nErrors = " << nErrors << ", nAbandoned = " << nAbandoned << endl;
+
+	// final fit from the best minimum of the workers, to get its fit result
+	if ( !r ){
+		binding->load(best.values);
+		r = fitToMinBringBackAngles(w->pdf(pdfName), false, printlevel, session);
+	}
+
+	RooMsgService::instance().setGlobalKillBelow(INFO);
+
+	// (re)set to best parameters
+	setParameters(w, parsName, r);
+	return r;
+}
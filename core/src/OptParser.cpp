@@ -29,12 +29,17 @@ OptParser::OptParser():
 
 	// Initialize the variables.
 	// For more complex arguments these are also the default values.
+	adaptive = 0.;
 	controlplot = false;
 	coverageCorrectionID = 0;
 	coverageCorrectionPoint = 0;
+	checkpoint = 0.;
+	columnar = false;
 	debug = false;
 	digits = -99;
 	enforcePhysRange = false;
+	fitpolicy = "twice";
+	forcestarts = "corners";
 	group = "GammaCombo";
 	groupPos = "";
 	id = -99;
@@ -47,12 +52,14 @@ OptParser::OptParser():
 	nBBpoints = -99;
 	ndiv = 407;
 	ndivy = 407;
+	nforcestarts = -99;
 	nosyst = false;
 	npoints1d = -99;
 	npoints2dx = -99;
 	npoints2dy = -99;
 	npointstoy = -99;
 	nrun = -99;
+	nthreads = -99;
 	ntoys = -99;
 	parevol = false;
 	plotid = -99;
@@ -73,18 +80,25 @@ OptParser::OptParser():
 	pluginPlotRangeMax = -100;
 	pluginPlotRangeMin = -100;
 	intprob = false;
+	probadaptive = 0.;
+	probadaptive2d = 0;
+	pruning = false;
+	seed = 0;
 	probforce = false;
 	probimprove = false;
 	printcor = false;
   queue = "";
+	resume = false;
 	scanforce = false;
 	scanrangeMax = -101;
 	scanrangeMin = -101;
 	scanrangeyMax = -102;
 	scanrangeyMin = -102;
 	smooth2d = false;
+	tailsampling = false;
 	usage = false;
 	verbose = false;
+	walltime = 0.;
 }
 
 ///
@@ -94,17 +108,22 @@ OptParser::OptParser():
 void OptParser::defineOptions()
 {
 	availableOptions.push_back("action");
+	availableOptions.push_back("adaptive");
 	availableOptions.push_back("asimov");
 	availableOptions.push_back("asimovfile");
 	availableOptions.push_back("combid");
 	availableOptions.push_back("color");
+	availableOptions.push_back("checkpoint");
+	availableOptions.push_back("columnar");
 	availableOptions.push_back("controlplots");
 	availableOptions.push_back("covCorrect");
 	availableOptions.push_back("covCorrectPoint");
 	availableOptions.push_back("debug");
 	availableOptions.push_back("digits");
 	availableOptions.push_back("evol");
+	availableOptions.push_back("fitpolicy");
 	availableOptions.push_back("fix");
+	availableOptions.push_back("forcestarts");
 	availableOptions.push_back("ext");
 	availableOptions.push_back("id");
 	availableOptions.push_back("importance");
@@ -122,12 +141,14 @@ void OptParser::defineOptions()
 	availableOptions.push_back("magnetic");
   availableOptions.push_back("nbatchjobs");
 	//availableOptions.push_back("nBBpoints");
+	availableOptions.push_back("nforcestarts");
 	availableOptions.push_back("nosyst");
 	availableOptions.push_back("npoints");
 	availableOptions.push_back("npoints2dx");
 	availableOptions.push_back("npoints2dy");
 	availableOptions.push_back("npointstoy");
 	availableOptions.push_back("nrun");
+	availableOptions.push_back("nthreads");
 	availableOptions.push_back("ntoys");
 	//availableOptions.push_back("pevid");
 	availableOptions.push_back("pr");
@@ -136,23 +157,30 @@ void OptParser::defineOptions()
 	availableOptions.push_back("intprob");
 	availableOptions.push_back("po");
 	availableOptions.push_back("prelim");
+	availableOptions.push_back("probadaptive");
+	availableOptions.push_back("probadaptive2d");
 	availableOptions.push_back("probforce");
+	availableOptions.push_back("pruning");
 	//availableOptions.push_back("probimprove");
 	availableOptions.push_back("ps");
 	availableOptions.push_back("pulls");
 	availableOptions.push_back("qh");
+	availableOptions.push_back("resume");
   availableOptions.push_back("queue");
 	availableOptions.push_back("sn");
 	availableOptions.push_back("sn2d");
 	availableOptions.push_back("scanforce");
 	availableOptions.push_back("scanrange");
 	availableOptions.push_back("scanrangey");
+	availableOptions.push_back("seed");
 	availableOptions.push_back("smooth2d");
+	availableOptions.push_back("tailsampling");
 	availableOptions.push_back("title");
 	availableOptions.push_back("usage");
 	availableOptions.push_back("unoff");
 	availableOptions.push_back("var");
 	availableOptions.push_back("verbose");
+	availableOptions.push_back("walltime");
 	//availableOptions.push_back("relation");
 	availableOptions.push_back("pluginplotrange");
 	availableOptions.push_back("plotnsigmacont");
@@ -202,15 +230,22 @@ void OptParser::bookPlottingOptions()
 ///
 void OptParser::bookPluginOptions()
 {
+	bookedOptions.push_back("adaptive");
+	bookedOptions.push_back("checkpoint");
+	bookedOptions.push_back("columnar");
   bookedOptions.push_back("controlplots");
+	bookedOptions.push_back("fitpolicy");
+	bookedOptions.push_back("forcestarts");
 	bookedOptions.push_back("id");
 	bookedOptions.push_back("importance");
 	bookedOptions.push_back("jobs");
 	bookedOptions.push_back("lightfiles");
   bookedOptions.push_back("nbatchjobs");
 	//bookedOptions.push_back("nBBpoints");
+	bookedOptions.push_back("nforcestarts");
 	bookedOptions.push_back("npointstoy");
 	bookedOptions.push_back("nrun");
+	bookedOptions.push_back("nthreads");
 	bookedOptions.push_back("ntoys");
 	//bookedOptions.push_back("pevid");
 	bookedOptions.push_back("pr");
@@ -218,6 +253,11 @@ void OptParser::bookPluginOptions()
 	bookedOptions.push_back("intprob");
 	bookedOptions.push_back("po");
 	bookedOptions.push_back("pluginplotrange");
+	bookedOptions.push_back("pruning");
+	bookedOptions.push_back("resume");
+	bookedOptions.push_back("seed");
+	bookedOptions.push_back("tailsampling");
+	bookedOptions.push_back("walltime");
 }
 
 ///
@@ -228,13 +268,18 @@ void OptParser::bookProbOptions()
 	bookedOptions.push_back("asimov");
 	bookedOptions.push_back("asimovfile");
 	bookedOptions.push_back("evol");
+	bookedOptions.push_back("forcestarts");
+	bookedOptions.push_back("nforcestarts");
 	bookedOptions.push_back("npoints");
 	bookedOptions.push_back("npoints2dx");
 	bookedOptions.push_back("npoints2dy");
+	bookedOptions.push_back("nthreads");
 	bookedOptions.push_back("pr");
 	bookedOptions.push_back("physrange");
 	bookedOptions.push_back("sn");
 	bookedOptions.push_back("sn2d");
+	bookedOptions.push_back("probadaptive");
+	bookedOptions.push_back("probadaptive2d");
 	bookedOptions.push_back("probforce");
 	//bookedOptions.push_back("probimprove");
 	bookedOptions.push_back("pulls");
@@ -344,6 +389,40 @@ void OptParser::parseArguments(int argc, char* argv[])
 			, false, -1, "int");
 	TCLAP::ValueArg<int> ntoysArg("", "ntoys", "number of toy experiments per job. Default: 25", false, 25, "int");
 	TCLAP::ValueArg<int> nrunArg("", "nrun", "Number of toy run. To be used with --action pluginbatch.", false, 1, "int");
+	TCLAP::ValueArg<float> checkpointArg("", "checkpoint", "Plugin batch: save the toys, and the progress of the job,"
+			" every this many minutes, so that a job that is killed can be continued with --resume."
+			" Default: 0, save only at the end.", false, 0., "float");
+	TCLAP::SwitchArg resumeArg("", "resume", "Plugin batch: continue the job from the toys it saved, see --checkpoint"
+			" and --walltime. The remaining toys come from the same random number streams as in the original job. Use the same"
+			" options as for the original job.", false);
+	TCLAP::ValueArg<float> walltimeArg("", "walltime", "Plugin batch: wall time budget of the job in minutes. When it"
+			" is used up, the job saves its toys and progress and stops, see --resume. Leave a margin for setting"
+			" up the job and for fitting one round of ntoys/10 toys. Default: 0, no limit.", false, 0., "float");
+	TCLAP::ValueArg<int> seedArg("", "seed", "Plugin: master seed of the random numbers. Together with --nrun, the"
+			" scan point and the toy number it determines every toy, so a run can be repeated exactly. Different"
+			" --nrun give independent toys for the same seed. Default: 0, use a random seed, which is printed.",
+			false, 0, "int");
+	TCLAP::ValueArg<int> nthreadsArg("", "nthreads", "Number of parallel workers. \n"
+			"Plugin: the toys of each scan point are fitted in parallel. The result does not depend "
+			"on the number of workers. \n"
+			"Prob, 1D: the scan range is split into this many segments that are scanned in parallel. \n"
+			"Prob, 2D: all points of one turn of the scan spiral are fitted in parallel. \n"
+			"--probforce, --scanforce: the start points are fitted in parallel. \n"
+			"Default: 0 (serial).", false, 0, "int");
+	TCLAP::ValueArg<string> fitpolicyArg("", "fitpolicy", "Plugin: how the toys are fitted. \n"
+			"twice: every fit is done twice, from two start points, and the better one is kept. \n"
+			"adaptive: learn which start point wins, start with that one, and skip the other fit if the "
+			"first one converged cleanly and, so far at this scan point, the other fit hardly ever found a better minimum. "
+			"Not with --nthreads, where each worker would learn on its own. \n"
+			"Default: twice", false, "twice", "string");
+	TCLAP::ValueArg<string> forcestartsArg("", "forcestarts", "Start points of the stronger minimum finding "
+			"method (--probforce, --scanforce). \n"
+			"corners: all corners of the ranges of the varied parameters, 2^n fits for n parameters. \n"
+			"lhs: a Latin hypercube of --nforcestarts points. \n"
+			"sobol: a Sobol sequence of --nforcestarts points. \n"
+			"Default: corners", false, "corners", "string");
+	TCLAP::ValueArg<int> nforcestartsArg("", "nforcestarts", "Number of start points for --forcestarts lhs "
+			"and sobol. Default: 8 per varied parameter", false, -1, "int");
 	TCLAP::ValueArg<int> npointsArg("", "npoints", "Number of scan points used by the Prob method. \n"
 			"1D plots: Default 100 points. \n"
 			"2D plots: Default 50 points per axis. In the 2D case, equal number of points "
@@ -372,6 +451,16 @@ void OptParser::parseArguments(int argc, char* argv[])
 	TCLAP::SwitchArg debugArg("d", "debug", "Enables debug level output.", false);
 	TCLAP::SwitchArg usageArg("u", "usage", "Prints usage information and exits.", false);
 	TCLAP::SwitchArg scanforceArg("f", "scanforce", "Use a stronger minimum finding method for the Plugin method.", false);
+	TCLAP::ValueArg<float> probadaptiveArg("", "probadaptive", "Prob, 1D: adaptive scan. Starts from the "
+			"--npoints grid and adds scan points only where the 1-CL curve crosses the 1 or 2 sigma levels, "
+			"has a local maximum, or changes steeply, until the scan points there are closer than "
+			"this fraction of the scan range. Example: --npoints 30 --probadaptive 0.001. "
+			"Default: 0 (uniform grid)", false, 0., "float");
+	TCLAP::ValueArg<int> probadaptive2dArg("", "probadaptive2d", "Prob, 2D: adaptive scan. Fits only every "
+			"N-th point of the --npoints2dx, --npoints2dy grid first, then refines only where the contours "
+			"pass, down to single grid points. The other points are interpolated. Runs serially, "
+			"not with -a plugin. Example: --npoints2dx 100 --npoints2dy 100 --probadaptive2d 8. "
+			"Default: 0 (full grid)", false, 0, "int");
 	TCLAP::SwitchArg probforceArg("", "probforce", "Use a stronger minimum finding method for the Prob method.", false);
 	TCLAP::SwitchArg probimproveArg("", "probimprove", "Use IMPROVE minimum finding for the Prob method.", false);
 	TCLAP::SwitchArg largestArg("", "largest", "Report largest CL interval: lowest boundary of "
@@ -382,14 +471,31 @@ void OptParser::parseArguments(int argc, char* argv[])
 			"of the best solution with the observables.", false);
 	TCLAP::SwitchArg lightfilesArg("", "lightfiles", "Produce only light weight root files for the plugin toys."
 			" They cannot be used for control plots but save disk space.", false);
+	TCLAP::SwitchArg columnarArg("", "columnar", "Store the parameters, observables and theory values of the plugin toys"
+			" in one array branch per category instead of one branch per variable. Tree aliases keep the usual"
+			" names (e.g. g_free) working in TTree::Draw().", false);
 	TCLAP::SwitchArg plotprelimArg("", "prelim", "Plot 'Preliminiary' into the plots. See also --unoff .", false);
 	TCLAP::SwitchArg plotunoffArg("", "unoff", "Plot 'Unofficial' into the plots. See also --prelim .", false);
 	TCLAP::SwitchArg prArg("", "pr", "Enforce the physical range on all parameters (needed to reproduce "
 			"the standard Feldman-Cousins with boundary example). If set, no nuisance will be allowed outside the "
 			"'phys' limit. However, toy generation of observables is not affected.", false);
+	TCLAP::ValueArg<float> adaptiveArg("", "adaptive", "Plugin: fit the toys of each scan point in rounds of"
+			" ntoys/10, and stop once the p-value is either clearly away from the 1, 2, 3 sigma levels, or known"
+			" to this relative precision near them. --ntoys is then the maximum number of toys per point."
+			" Default: 0 (off).", false, 0., "float");
 	TCLAP::SwitchArg importanceArg("", "importance", "Enable importance sampling for plugin toys.", false);
 	TCLAP::SwitchArg nosystArg("", "nosyst", "Sets all systematic errors to zero.", false);
+	TCLAP::SwitchArg pruningArg("", "pruning", "Plugin: skip the free fit of a toy if its scan fit chi2 is"
+			" already 0.2 below the test statistic of the data, so that the toy can't be better. Needs a combination"
+			" of Gaussian PDFs, where the free fit chi2 is bounded by zero. Pruned toys are flagged in the"
+			" 'pruned' branch of the ToyTree. As their free fit is unknown, they are counted as physical with the"
+			" fraction of physical toys among the others; this biases the p-value if the pruned toys are more often"
+			" unphysical than the others. Not with --intprob.", false);
 	TCLAP::SwitchArg printcorArg("", "printcor", "Print the correlation matrix of each solution found.", false);
+	TCLAP::SwitchArg tailsamplingArg("", "tailsampling", "Plugin: at scan points far in the tail, draw the Gaussian"
+			" observables of the toys from a distribution that is widened towards the data, mixed with the"
+			" nominal one, and store the log of a weight for each toy. This makes"
+			" small p-values reachable with few toys.", false);
 	TCLAP::SwitchArg smooth2dArg("", "smooth2d", "Smooth 2D p-value or cl histograms for nicer contour (particularly useful for 2D plugin)", false);
 
 	// --------------- aruments that can be given multiple times
@@ -522,24 +628,31 @@ void OptParser::parseArguments(int argc, char* argv[])
 	// The order is alphabetical - this order defines how the options
 	// are ordered on the command line, unfortunately in reverse.
 	//
+	if ( isIn<TString>(bookedOptions, "walltime" ) ) cmd.add(walltimeArg);
 	if ( isIn<TString>(bookedOptions, "verbose" ) ) cmd.add( verboseArg );
 	if ( isIn<TString>(bookedOptions, "var" ) ) cmd.add(varArg);
 	if ( isIn<TString>(bookedOptions, "usage" ) ) cmd.add( usageArg );
 	if ( isIn<TString>(bookedOptions, "unoff" ) ) cmd.add( plotunoffArg );
 	if ( isIn<TString>(bookedOptions, "title" ) ) cmd.add( titleArg );
+	if ( isIn<TString>(bookedOptions, "tailsampling" ) ) cmd.add( tailsamplingArg );
 	if ( isIn<TString>(bookedOptions, "sn2d" ) ) cmd.add(sn2dArg);
 	if ( isIn<TString>(bookedOptions, "sn" ) ) cmd.add(snArg);
 	if ( isIn<TString>(bookedOptions, "smooth2d" ) ) cmd.add( smooth2dArg );
+	if ( isIn<TString>(bookedOptions, "seed" ) ) cmd.add(seedArg);
 	if ( isIn<TString>(bookedOptions, "scanrangey" ) ) cmd.add( scanrangeyArg );
 	if ( isIn<TString>(bookedOptions, "scanrange" ) ) cmd.add( scanrangeArg );
 	if ( isIn<TString>(bookedOptions, "scanforce" ) ) cmd.add( scanforceArg );
+	if ( isIn<TString>(bookedOptions, "resume" ) ) cmd.add( resumeArg );
 	if ( isIn<TString>(bookedOptions, "relation" ) ) cmd.add(relationArg);
 	if ( isIn<TString>(bookedOptions, "qh" ) ) cmd.add(qhArg);
   if ( isIn<TString>(bookedOptions, "queue") ) cmd.add(queueArg);
 	if ( isIn<TString>(bookedOptions, "pulls" ) ) cmd.add( plotpullsArg );
 	if ( isIn<TString>(bookedOptions, "ps" ) ) cmd.add( plotsolutionsArg );
+	if ( isIn<TString>(bookedOptions, "pruning" ) ) cmd.add( pruningArg );
 	if ( isIn<TString>(bookedOptions, "probimprove" ) ) cmd.add( probimproveArg );
 	if ( isIn<TString>(bookedOptions, "probforce" ) ) cmd.add( probforceArg );
+	if ( isIn<TString>(bookedOptions, "probadaptive2d" ) ) cmd.add(probadaptive2dArg);
+	if ( isIn<TString>(bookedOptions, "probadaptive" ) ) cmd.add(probadaptiveArg);
 	if ( isIn<TString>(bookedOptions, "printcor" ) ) cmd.add( printcorArg );
 	if ( isIn<TString>(bookedOptions, "prelim" ) ) cmd.add( plotprelimArg );
 	if ( isIn<TString>(bookedOptions, "po" ) ) cmd.add( plotpluginonlyArg );
@@ -552,12 +665,14 @@ void OptParser::parseArguments(int argc, char* argv[])
 	if ( isIn<TString>(bookedOptions, "physrange" ) ) cmd.add(physrangeArg);
 	if ( isIn<TString>(bookedOptions, "pevid" ) ) cmd.add( pevidArg );
 	if ( isIn<TString>(bookedOptions, "ntoys" ) ) cmd.add(ntoysArg);
+	if ( isIn<TString>(bookedOptions, "nthreads" ) ) cmd.add(nthreadsArg);
 	if ( isIn<TString>(bookedOptions, "nrun" ) ) cmd.add(nrunArg);
 	if ( isIn<TString>(bookedOptions, "npointstoy" ) ) cmd.add(npointstoyArg);
 	if ( isIn<TString>(bookedOptions, "npoints2dy" ) ) cmd.add(npoints2dyArg);
 	if ( isIn<TString>(bookedOptions, "npoints2dx" ) ) cmd.add(npoints2dxArg);
 	if ( isIn<TString>(bookedOptions, "npoints" ) ) cmd.add(npointsArg);
 	if ( isIn<TString>(bookedOptions, "nosyst" ) ) cmd.add( nosystArg );
+	if ( isIn<TString>(bookedOptions, "nforcestarts" ) ) cmd.add(nforcestartsArg);
 	if ( isIn<TString>(bookedOptions, "ndivy" ) ) cmd.add(ndivyArg);
 	if ( isIn<TString>(bookedOptions, "ndiv" ) ) cmd.add(ndivArg);
 	if ( isIn<TString>(bookedOptions, "nBBpoints" ) ) cmd.add(nBBpointsArg);
@@ -576,7 +691,9 @@ void OptParser::parseArguments(int argc, char* argv[])
 	if ( isIn<TString>(bookedOptions, "id" ) ) cmd.add(idArg);
 	if ( isIn<TString>(bookedOptions, "group" ) ) cmd.add( plotgroupArg );
 	if ( isIn<TString>(bookedOptions, "grouppos" ) ) cmd.add( plotgroupposArg );
+	if ( isIn<TString>(bookedOptions, "forcestarts" ) ) cmd.add(forcestartsArg);
 	if ( isIn<TString>(bookedOptions, "fix" ) ) cmd.add(fixArg);
+	if ( isIn<TString>(bookedOptions, "fitpolicy" ) ) cmd.add(fitpolicyArg);
 	if ( isIn<TString>(bookedOptions, "ext" ) ) cmd.add(filenameadditionArg);
 	if ( isIn<TString>(bookedOptions, "evol" ) ) cmd.add(parevolArg);
 	if ( isIn<TString>(bookedOptions, "digits" ) ) cmd.add(digitsArg);
@@ -585,21 +702,29 @@ void OptParser::parseArguments(int argc, char* argv[])
 	if ( isIn<TString>(bookedOptions, "covCorrect" ) ) cmd.add(coverageCorrectionIDArg);
 	if ( isIn<TString>(bookedOptions, "controlplots" ) ) cmd.add(controlplotArg);
 	if ( isIn<TString>(bookedOptions, "combid" ) ) cmd.add(combidArg);
+	if ( isIn<TString>(bookedOptions, "checkpoint" ) ) cmd.add(checkpointArg);
+	if ( isIn<TString>(bookedOptions, "columnar" ) ) cmd.add( columnarArg );
 	if ( isIn<TString>(bookedOptions, "color" ) ) cmd.add(colorArg);
 	if ( isIn<TString>(bookedOptions, "asimovfile" ) ) cmd.add( asimovFileArg );
 	if ( isIn<TString>(bookedOptions, "asimov") ) cmd.add(asimovArg);
+	if ( isIn<TString>(bookedOptions, "adaptive") ) cmd.add(adaptiveArg);
 	if ( isIn<TString>(bookedOptions, "action") ) cmd.add(actionArg);
 	cmd.parse( argc, argv );
 
 	//
 	// copy over parsed values into data members
 	//
+	adaptive          = adaptiveArg.getValue();
 	asimov            = asimovArg.getValue();
+	checkpoint        = checkpointArg.getValue();
 	color             = colorArg.getValue();
+	columnar          = columnarArg.getValue();
 	controlplot       = controlplotArg.getValue();
 	digits            = digitsArg.getValue();
 	enforcePhysRange  = prArg.getValue();
 	filenameaddition  = filenameadditionArg.getValue();
+	fitpolicy         = fitpolicyArg.getValue();
+	forcestarts       = forcestartsArg.getValue();
 	group             = plotgroupArg.getValue();
 	id                = idArg.getValue();
 	importance        = importanceArg.getValue();
@@ -612,12 +737,14 @@ void OptParser::parseArguments(int argc, char* argv[])
 	nBBpoints         = nBBpointsArg.getValue();
 	ndiv              = ndivArg.getValue();
 	ndivy             = ndivyArg.getValue();
+	nforcestarts      = nforcestartsArg.getValue();
 	nosyst            = nosystArg.getValue();
 	npoints1d         = npointsArg.getValue()==-1 ? 100 : npointsArg.getValue();
 	npoints2dx        = npoints2dxArg.getValue()==-1 ? (npointsArg.getValue()==-1 ? 50 : npointsArg.getValue()) : npoints2dxArg.getValue();
 	npoints2dy        = npoints2dyArg.getValue()==-1 ? (npointsArg.getValue()==-1 ? 50 : npointsArg.getValue()) : npoints2dyArg.getValue();
 	npointstoy        = npointstoyArg.getValue();
 	nrun	          = nrunArg.getValue();
+	nthreads          = nthreadsArg.getValue();
 	ntoys	          = ntoysArg.getValue();
 	parevol           = parevolArg.getValue();
 	pevid             = pevidArg.getValue();
@@ -630,15 +757,22 @@ void OptParser::parseArguments(int argc, char* argv[])
 	plotpulls         = plotpullsArg.getValue();
 	plotunoff         = plotunoffArg.getValue();
 	printcor          = printcorArg.getValue();
+	probadaptive      = probadaptiveArg.getValue();
+	probadaptive2d    = probadaptive2dArg.getValue();
 	probforce         = probforceArg.getValue();
 	probimprove       = probimproveArg.getValue();
+	pruning           = pruningArg.getValue();
 	qh                = qhArg.getValue();
   queue             = TString(queueArg.getValue());
+	resume            = resumeArg.getValue();
 	savenuisances1d   = snArg.getValue();
 	scanforce         = scanforceArg.getValue();
+	seed              = seedArg.getValue();
 	smooth2d          = smooth2dArg.getValue();
+	tailsampling      = tailsamplingArg.getValue();
 	usage             = usageArg.getValue();
 	verbose           = verboseArg.getValue();
+	walltime          = walltimeArg.getValue();
 
 	//
 	// The following options need some post-processing to
@@ -905,6 +1039,50 @@ void OptParser::parseArguments(int argc, char* argv[])
 		cout << "ERROR : --po can only be given when -a plugin is set." << endl;
 		exit(1);
 	}
+
+	// check --fitpolicy argument
+	if ( fitpolicy!="twice" && fitpolicy!="adaptive" ){
+		cout << "ERROR : --fitpolicy must be one of twice, adaptive." << endl;
+		exit(1);
+	}
+	if ( fitpolicy=="adaptive" && nthreads>0 ){
+		cout << "ERROR : --fitpolicy adaptive can't be combined with --nthreads: the statistics would depend"
+			" on which toys each worker fits, and so would the toys." << endl;
+		exit(1);
+	}
+
+	// check --checkpoint, --walltime, --resume arguments
+	if ( checkpoint<0 || walltime<0 ){
+		cout << "ERROR : --checkpoint and --walltime must be positive." << endl;
+		exit(1);
+	}
+	if ( (checkpoint>0 || walltime>0 || resume) && !isAction("pluginbatch") ){
+		cout << "ERROR : --checkpoint, --walltime and --resume can only be given when -a pluginbatch is set." << endl;
+		exit(1);
+	}
+
+	// check --seed argument
+	if ( seed<0 ){
+		cout << "ERROR : --seed must be positive, or 0 for a random seed." << endl;
+		exit(1);
+	}
+
+	// check --forcestarts argument
+	if ( forcestarts!="corners" && forcestarts!="lhs" && forcestarts!="sobol" ){
+		cout << "ERROR : --forcestarts must be one of corners, lhs, sobol." << endl;
+		exit(1);
+	}
+
+	// check --probadaptive2d argument. The Plugin method needs the
+	// Prob fit results at every point of the 2D scan.
+	if ( probadaptive2d<0 ){
+		cout << "ERROR : --probadaptive2d must be positive." << endl;
+		exit(1);
+	}
+	if ( probadaptive2d>0 && (isAction("plugin") || isAction("pluginbatch")) ){
+		cout << "ERROR : --probadaptive2d can't be used with -a plugin or -a pluginbatch." << endl;
+		exit(1);
+	}
 }
 
 ///
@@ -122,7 +122,7 @@ void PDF_Abs::setObservablesToy()
 	if( !pdf ){ cout<< "PDF_Abs::setObservables(): ERROR: pdf not initialized."<<endl; exit(1); }
 	if ( toyObservables==0 || iToyObs==nToyObs )
 	{
-		RooRandom::randomGenerator()->SetSeed(0);
+		CounterRng::seedRooRandom();
 		if ( iToyObs==nToyObs ) delete toyObservables;
 		toyObservables = pdf->generate(*(RooArgSet*)observables, nToyObs);
 		iToyObs=0;
@@ -566,15 +566,10 @@ bool PDF_Abs::test()
 	fixParameters(observables);
 	floatParameters(parameters);
 	setLimit(parameters, "free");
-	RooFormulaVar ll("ll", "ll", "-2*log(@0)", RooArgSet(*pdf));
-	RooMinuit m(ll);
-	if(quiet) m.setPrintLevel(-2);
-	m.setNoWarn();
+	MinimizerSession m(pdf);
+	m.setPrintLevel(quiet ? -1 : 1);
 	m.setLogFile("/dev/zero");
-	m.setErrorLevel(1.0);
-	m.setStrategy(2);
-	// m.setProfile(1);
-	m.migrad();
+	m.fit();
 	RooFitResult *f = m.save();
 	bool status = !(f->edm()<1 && f->status()==0);
 	if(!quiet) f->Print("v");
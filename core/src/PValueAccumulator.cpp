@@ -0,0 +1,350 @@
+#include "PValueAccumulator.h"
+
+PValueAccumulator::PValueAccumulator()
+{
+	reset();
+}
+
+PValueAccumulator::~PValueAccumulator()
+{}
+
+///
+/// Forget all counts and ingested files. The config is kept.
+///
+void PValueAccumulator::reset()
+{
+	nEntries = 0;
+	nFailed = 0;
+	nWrongRun = 0;
+	nToysId = 0;
+	points.clear();
+	files.clear();
+}
+
+///
+/// Register a scan point. Every scan point found in the toys
+/// defines a bin of the p-value histogram, even if all its toys
+/// fail the cuts, see ToyTree::computeMinMaxN().
+///
+void PValueAccumulator::addScanpoint(float scanpoint)
+{
+	if ( points.find(scanpoint)!=points.end() ) return;
+	Counts c;
+	c.nAll = 0;
+	c.nBackground = 0;
+	c.wBetter = 0.;
+	c.wAll = 0.;
+	c.wGof = 0.;
+	c.w2Better = 0.;
+	c.w2All = 0.;
+	c.nFailedFree = 0;
+	c.wPruned = 0.;
+	c.w2Pruned = 0.;
+	points[scanpoint] = c;
+}
+
+///
+/// Count a toy whose scan fit passed the cuts, but whose free fit
+/// failed. Needed for the acceptance of the pruned toys.
+///
+void PValueAccumulator::addFailedFreeFit(float scanpoint)
+{
+	addScanpoint(scanpoint);
+	points[scanpoint].nFailedFree++;
+}
+
+///
+/// Count a toy whose free fit was pruned, see
+/// MethodPluginScan::fitToy().
+///
+void PValueAccumulator::addPrunedToy(float scanpoint, double weight)
+{
+	addScanpoint(scanpoint);
+	Counts &c = points[scanpoint];
+	c.wPruned += weight;
+	c.w2Pruned += weight*weight;
+}
+
+///
+/// The fraction of unpruned toys with a good scan fit that end up
+/// as physical toys, i.e. whose free fit converged and is below the
+/// scan fit. Used as the probability that a pruned toy would have been
+/// counted, had its free fit been run. This assumes that the pruned toys
+/// behave like the others. It is exact when all toys with a good scan fit
+/// are physical, which is the usual case for a combination of Gaussian
+/// PDFs.
+///
+double PValueAccumulator::getAcceptance(const Counts &c) const
+{
+	Long64_t n = c.nAll+c.nBackground+c.nFailedFree;
+	if ( n==0 ) return 1.;
+	return (double)c.nAll/(double)n;
+}
+
+///
+/// Sum of weights of the physical toys, including the expected
+/// contribution of the pruned toys.
+///
+double PValueAccumulator::getWall(const Counts &c) const
+{
+	return c.wAll+getAcceptance(c)*c.wPruned;
+}
+
+double PValueAccumulator::getW2all(const Counts &c) const
+{
+	return c.w2All+getAcceptance(c)*c.w2Pruned;
+}
+
+///
+/// Count a toy that passed all cuts.
+///
+/// \param scanpoint - the scan point the toy was generated at
+/// \param inPhysicalRegion - false for background toys
+/// \param better - the toy has a better test statistic than the data
+/// \param gof - the toy has a worse global minimum than the data
+/// \param weight - weight of the toy, 1 unless importance sampled
+///
+void PValueAccumulator::addToy(float scanpoint, bool inPhysicalRegion, bool better, bool gof, double weight)
+{
+	addScanpoint(scanpoint);
+	Counts &c = points[scanpoint];
+	if ( !inPhysicalRegion ){
+		c.nBackground++;
+		return;
+	}
+	c.nAll++;
+	c.wAll += weight;
+	c.w2All += weight*weight;
+	if ( better ){
+		c.wBetter += weight;
+		c.w2Better += weight*weight;
+	}
+	if ( gof ) c.wGof += weight;
+}
+
+bool PValueAccumulator::getFileInfo(TString file, FileInfo &info) const
+{
+	Long_t id, flags;
+	if ( gSystem->GetPathInfo(file, &id, &info.size, &flags, &info.modTime)!=0 ) return false;
+	return true;
+}
+
+///
+/// Remember that a toy file was ingested.
+///
+void PValueAccumulator::addFile(TString file)
+{
+	FileInfo info;
+	if ( !getFileInfo(file, info) ){
+		cout << "PValueAccumulator::addFile() : ERROR : file not found: " << file << ". Exit." << endl;
+		exit(1);
+	}
+	files[file] = info;
+}
+
+///
+/// Check if a toy file was ingested already.
+///
+/// \return 0 if the file is new, 1 if it was ingested and did not
+///         change since, 2 if it was ingested but has changed since.
+///
+int PValueAccumulator::checkFile(TString file) const
+{
+	map<TString,FileInfo>::const_iterator it = files.find(file);
+	if ( it==files.end() ) return 0;
+	FileInfo info;
+	if ( !getFileInfo(file, info) ) return 2;
+	if ( info.size!=it->second.size || info.modTime!=it->second.modTime ) return 2;
+	return 1;
+}
+
+///
+/// Check if toy files were ingested that are not in the given list,
+/// e.g. because a different run range is requested.
+///
+bool PValueAccumulator::hasFilesOtherThan(const vector<TString>& fileList) const
+{
+	int nFound = 0;
+	for ( int i=0; i<fileList.size(); i++ ){
+		if ( files.find(fileList[i])!=files.end() ) nFound++;
+	}
+	return nFound!=files.size();
+}
+
+float PValueAccumulator::getScanpointMin() const
+{
+	if ( points.empty() ) return 0.;
+	return points.begin()->first;
+}
+
+float PValueAccumulator::getScanpointMax() const
+{
+	if ( points.empty() ) return 0.;
+	return points.rbegin()->first;
+}
+
+Long64_t PValueAccumulator::getNall(float scanpoint) const
+{
+	map<float,Counts>::const_iterator it = points.find(scanpoint);
+	if ( it==points.end() ) return 0;
+	return it->second.nAll;
+}
+
+///
+/// Get the p-value at a scan point, the weighted fraction
+/// of physical toys with a better test statistic than the data.
+///
+double PValueAccumulator::getPvalue(float scanpoint) const
+{
+	map<float,Counts>::const_iterator it = points.find(scanpoint);
+	if ( it==points.end() || getWall(it->second)==0. ) return 0.;
+	return it->second.wBetter/getWall(it->second);
+}
+
+///
+/// Get the error of the p-value at a scan point. For unit weights this
+/// is the binomial error sqrt(p(1-p)/n).
+///
+double PValueAccumulator::getPvalueError(float scanpoint) const
+{
+	map<float,Counts>::const_iterator it = points.find(scanpoint);
+	if ( it==points.end() || getWall(it->second)==0. ) return 0.;
+	const Counts &c = it->second;
+	double wAll = getWall(c);
+	double p = c.wBetter/wAll;
+	return sqrt((1.-p)*(1.-p)*c.w2Better + p*p*(getW2all(c)-c.w2Better))/wAll;
+}
+
+///
+/// Get the effective number of physical toys at a scan point,
+/// (sum w)^2/(sum w^2). Equals the number of toys for unit weights.
+///
+double PValueAccumulator::getNeff(float scanpoint) const
+{
+	map<float,Counts>::const_iterator it = points.find(scanpoint);
+	if ( it==points.end() || getW2all(it->second)==0. ) return 0.;
+	return getWall(it->second)*getWall(it->second)/getW2all(it->second);
+}
+
+Long64_t PValueAccumulator::getNbackground() const
+{
+	Long64_t n = 0;
+	for ( map<float,Counts>::const_iterator it=points.begin(); it!=points.end(); it++ ) n += it->second.nBackground;
+	return n;
+}
+
+///
+/// Check if the scan points are not equidistant, in which case the
+/// p-value histogram will have binning problems.
+///
+bool PValueAccumulator::hasDifferentBinWidths() const
+{
+	if ( points.size()<3 ) return false;
+	map<float,Counts>::const_iterator it = points.begin();
+	float prev = it->first;
+	it++;
+	float binWidth = it->first-prev;
+	for ( ; it!=points.end(); it++ ){
+		if ( fabs(binWidth-(it->first-prev))>1e-6 ) return true;
+		prev = it->first;
+	}
+	return false;
+}
+
+///
+/// Fill the counts into histograms. Each scan point is filled once,
+/// weighted by the sum of the toy weights. The errors of h_better and
+/// h_all are set to the square root of the sum of squared weights.
+/// h_all includes the pruned toys, see getAcceptance(). h_gof is scaled
+/// such that h_gof/h_all is the goodness-of-fit fraction of the unpruned
+/// toys.
+///
+void PValueAccumulator::fillHistograms(TH1F *h_better, TH1F *h_all, TH1F *h_gof, TH1F *h_background) const
+{
+	h_better->Sumw2();
+	h_all->Sumw2();
+	for ( map<float,Counts>::const_iterator it=points.begin(); it!=points.end(); it++ ){
+		const Counts &c = it->second;
+		int iBin = h_better->FindBin(it->first);
+		h_better->SetBinContent(iBin, h_better->GetBinContent(iBin)+c.wBetter);
+		h_better->SetBinError(iBin, sqrt(pow(h_better->GetBinError(iBin),2)+c.w2Better));
+		h_all->SetBinContent(iBin, h_all->GetBinContent(iBin)+getWall(c));
+		h_all->SetBinError(iBin, sqrt(pow(h_all->GetBinError(iBin),2)+getW2all(c)));
+		if ( c.wGof>0 ) h_gof->Fill(it->first, c.wGof*getWall(c)/c.wAll);
+		if ( c.nBackground>0 ) h_background->Fill(it->first, c.nBackground);
+	}
+}
+
+///
+/// Save the accumulator into a text file.
+///
+void PValueAccumulator::write(TString fileName) const
+{
+	ofstream outf;
+	outf.open(fileName);
+	if ( !outf.is_open() ){
+		cout << "PValueAccumulator::write() : ERROR : couldn't open file " << fileName << endl;
+		return;
+	}
+	outf << "config " << config << endl;
+	outf << "counters " << nEntries << " " << nFailed << " " << nWrongRun << " " << nToysId << endl;
+	for ( map<TString,FileInfo>::const_iterator it=files.begin(); it!=files.end(); it++ ){
+		outf << "file " << it->second.size << " " << it->second.modTime << " " << it->first << endl;
+	}
+	for ( map<float,Counts>::const_iterator it=points.begin(); it!=points.end(); it++ ){
+		const Counts &c = it->second;
+		// 9 significant digits reproduce a float exactly
+		outf << "point " << Form("%.9g", it->first) << " " << c.nAll << " " << c.nBackground
+			<< Form(" %.17g %.17g %.17g %.17g %.17g", c.wBetter, c.wAll, c.wGof, c.w2Better, c.w2All)
+			<< " " << c.nFailedFree << Form(" %.17g %.17g", c.wPruned, c.w2Pruned) << endl;
+	}
+	outf.close();
+}
+
+///
+/// Load the accumulator from a text file written by write().
+///
+/// \return false if the file doesn't exist or can't be parsed. The
+///         accumulator is empty then.
+///
+bool PValueAccumulator::read(TString fileName)
+{
+	reset();
+	config = "";
+	ifstream inf(fileName);
+	if ( !inf.is_open() ) return false;
+	string line;
+	while ( getline(inf, line) ){
+		if ( line.empty() ) continue;
+		TString key;
+		istringstream ss(line);
+		string word;
+		ss >> word;
+		key = word;
+		if ( key=="config" ){
+			config = line.size()>7 ? line.substr(7).c_str() : "";
+		}
+		else if ( key=="counters" ){
+			ss >> nEntries >> nFailed >> nWrongRun >> nToysId;
+		}
+		else if ( key=="file" ){
+			FileInfo info;
+			string file;
+			ss >> info.size >> info.modTime >> file;
+			files[file.c_str()] = info;
+		}
+		else if ( key=="point" ){
+			double scanpoint;
+			Counts c;
+			ss >> scanpoint >> c.nAll >> c.nBackground >> c.wBetter >> c.wAll >> c.wGof >> c.w2Better >> c.w2All
+				>> c.nFailedFree >> c.wPruned >> c.w2Pruned;
+			points[(float)scanpoint] = c;
+		}
+		if ( ss.fail() ){
+			cout << "PValueAccumulator::read() : WARNING : couldn't parse " << fileName << ", ignoring it." << endl;
+			reset();
+			return false;
+		}
+	}
+	return true;
+}
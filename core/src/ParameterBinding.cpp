@@ -0,0 +1,177 @@
+#include "ParameterBinding.h"
+
+///
+/// Bind the variables of a set. The set must hold RooRealVars
+/// and outlive the binding, e.g. a set of the workspace.
+///
+ParameterBinding::ParameterBinding(const RooAbsCollection* set)
+{
+	if ( !set ){
+		cout << "ParameterBinding::ParameterBinding() : ERROR : no set given. Exit." << endl;
+		exit(1);
+	}
+	source = set;
+	TIterator* it = set->createIterator();
+	while ( RooRealVar* p = (RooRealVar*)it->Next() ) vars.push_back(p);
+	delete it;
+}
+
+ParameterBinding::~ParameterBinding()
+{}
+
+///
+/// Exit with an error if a stored point doesn't have one entry per
+/// bound variable, e.g. because it was never stored, or stored by a
+/// binding of a different set.
+///
+void ParameterBinding::checkSize(int n, TString method) const
+{
+	if ( n!=vars.size() ){
+		cout << "ParameterBinding::" << method << "() : ERROR : got " << n << " entries for "
+			<< vars.size() << " variables. Exit." << endl;
+		exit(1);
+	}
+}
+
+///
+/// Return the position of a variable in the binding.
+/// \return -1 if the variable isn't bound
+///
+int ParameterBinding::getIndex(TString name) const
+{
+	for ( int i=0; i<vars.size(); i++ ){
+		if ( name==vars[i]->GetName() ) return i;
+	}
+	return -1;
+}
+
+///
+/// Set the values of all bound variables.
+/// \param values - one value per variable, in the order of the binding
+///
+void ParameterBinding::load(const vector<double>& values) const
+{
+	checkSize(values.size(), "load");
+	for ( int i=0; i<vars.size(); i++ ) vars[i]->setVal(values[i]);
+}
+
+void ParameterBinding::load(const vector<float>& values) const
+{
+	checkSize(values.size(), "load");
+	for ( int i=0; i<vars.size(); i++ ) vars[i]->setVal(values[i]);
+}
+
+///
+/// Set the values of all bound variables that are not constant.
+///
+void ParameterBinding::loadFloating(const vector<double>& values) const
+{
+	checkSize(values.size(), "loadFloating");
+	for ( int i=0; i<vars.size(); i++ ){
+		if ( !vars[i]->isConstant() ) vars[i]->setVal(values[i]);
+	}
+}
+
+///
+/// Set the bound variables to the values of a fit result. Variables
+/// that are not in the fit result keep their values. Same as
+/// Utils::setParameters(RooWorkspace*, TString, RooSlimFitResult*, bool).
+///
+/// \param r - the fit result
+/// \param constAndFloat - if false, only take values of parameters that
+///                        were floating in the fit
+///
+void ParameterBinding::load(const RooSlimFitResult* r, bool constAndFloat)
+{
+	const RooSlimFitSchema* schema = r->getSchema();
+	if ( !schema ) return;
+	const vector<int>& slots = getSlots(schema);
+	for ( int i=0; i<vars.size(); i++ ){
+		int iPar = slots[i];
+		if ( iPar<0 ) continue;
+		if ( !constAndFloat && schema->isConst(iPar) ) continue;
+		vars[i]->setVal(r->getParVal(iPar));
+	}
+}
+
+void ParameterBinding::loadConstant(const vector<bool>& isConstant) const
+{
+	checkSize(isConstant.size(), "loadConstant");
+	for ( int i=0; i<vars.size(); i++ ) vars[i]->setConstant(isConstant[i]);
+}
+
+///
+/// Set the errors of all bound variables. They set the initial step
+/// sizes of Minuit, so resetting them makes a fit independent of the
+/// fits done before it.
+/// \param errors - one error per variable, see storeErrors()
+///
+void ParameterBinding::loadErrors(const vector<double>& errors) const
+{
+	checkSize(errors.size(), "loadErrors");
+	for ( int i=0; i<vars.size(); i++ ) vars[i]->setError(errors[i]);
+}
+
+///
+/// Get the values of all bound variables.
+/// \param values - filled with one value per variable
+///
+void ParameterBinding::store(vector<double>& values) const
+{
+	values.resize(vars.size());
+	for ( int i=0; i<vars.size(); i++ ) values[i] = vars[i]->getVal();
+}
+
+void ParameterBinding::store(vector<float>& values) const
+{
+	values.resize(vars.size());
+	for ( int i=0; i<vars.size(); i++ ) values[i] = vars[i]->getVal();
+}
+
+///
+/// Get the values of another set, in the order of the binding. This
+/// converts a point given as a RooArgSet into the vector format, the
+/// variables are found by name. Variables not contained in the set
+/// take their current value.
+///
+void ParameterBinding::store(const RooAbsCollection* set, vector<double>& values) const
+{
+	if ( set==source ){
+		store(values);
+		return;
+	}
+	values.resize(vars.size());
+	for ( int i=0; i<vars.size(); i++ ){
+		RooRealVar *var = (RooRealVar*)set->find(vars[i]->GetName());
+		values[i] = var ? var->getVal() : vars[i]->getVal();
+	}
+}
+
+void ParameterBinding::storeConstant(vector<bool>& isConstant) const
+{
+	isConstant.resize(vars.size());
+	for ( int i=0; i<vars.size(); i++ ) isConstant[i] = vars[i]->isConstant();
+}
+
+///
+/// Get the errors of all bound variables.
+/// \param errors - filled with one error per variable
+///
+void ParameterBinding::storeErrors(vector<double>& errors) const
+{
+	errors.resize(vars.size());
+	for ( int i=0; i<vars.size(); i++ ) errors[i] = vars[i]->getError();
+}
+
+///
+/// Get the position of each bound variable in a fit result schema.
+/// Computed on first use of the schema.
+///
+const vector<int>& ParameterBinding::getSlots(const RooSlimFitSchema* schema)
+{
+	map<const RooSlimFitSchema*, vector<int> >::iterator it = schemaSlots.find(schema);
+	if ( it!=schemaSlots.end() ) return it->second;
+	vector<int>& slots = schemaSlots[schema];
+	for ( int i=0; i<vars.size(); i++ ) slots.push_back(schema->getIndex(vars[i]->GetName()));
+	return slots;
+}
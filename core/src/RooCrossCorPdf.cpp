@@ -15,10 +15,12 @@ RooCrossCorPdf::RooCrossCorPdf(const char *name, const char *title,
 	_th("th","parameters",this,kTRUE,kFALSE),
 	_obs("obs","observables",this,kTRUE,kFALSE),
 	_invcov(invcov),
-	_nObsPdf1(nObsPdf1)
+	_nObsPdf1(nObsPdf1),
+	_entriesBuilt(false)
 {
 	_th.add(th) ;
 	_obs.add(obs) ;
+	buildEntries();
 }
 
 
@@ -27,30 +29,75 @@ RooCrossCorPdf::RooCrossCorPdf(const RooCrossCorPdf& other, const char* name) :
 	_th("th",this,other._th), 
 	_obs("obs",this,other._obs),
 	_invcov(other._invcov),
-	_nObsPdf1(other._nObsPdf1)
+	_nObsPdf1(other._nObsPdf1),
+	_entryI(other._entryI),
+	_entryJ(other._entryJ),
+	_entryVal(other._entryVal),
+	_entriesBuilt(other._entriesBuilt)
 {
 }
 
+///
+/// Collect the non-zero entries of _invcov that connect an observable
+/// of the first PDF to one of the second. Only the upper triangle is
+/// used, like in the former full loop. The list isn't stored in files,
+/// so it is rebuilt on first use after reading.
+///
+void RooCrossCorPdf::buildEntries() const
+{
+	_entryI.clear();
+	_entryJ.clear();
+	_entryVal.clear();
+	int n = _invcov.GetNrows();
+	for ( int i=0; i<_nObsPdf1 && i<n; i++ )
+		for ( int j=_nObsPdf1; j<n; j++ ){
+			if ( _invcov[i][j]==0 ) continue;
+			_entryI.push_back(i);
+			_entryJ.push_back(j);
+			_entryVal.push_back(_invcov[i][j]);
+		}
+	_entriesBuilt = true;
+}
 
-Double_t RooCrossCorPdf::evaluate() const 
+///
+/// Compute the exponent of the PDF, -log() of its value.
+///
+Double_t RooCrossCorPdf::computeExponent() const
 {
-	//return 1.;
-	// Represent observables and theory as vector
-	TVectorD obs(_obs.getSize()) ;
-	TVectorD th(_th.getSize()) ;
-	for (int i=0 ; i<_obs.getSize() ; i++) {
-		obs[i] = ((RooAbsReal*)_obs.at(i))->getVal() ;
-		th[i] = ((RooAbsReal*)_th.at(i))->getVal() ;
+	if ( !_entriesBuilt ) buildEntries();
+	int n = _obs.getSize();
+	_delta.resize(n);
+	for ( int i=0; i<n; i++ ){
+		_delta[i] = ((RooAbsReal*)_obs.at(i))->getVal() - ((RooAbsReal*)_th.at(i))->getVal();
 	}
-
 	double ret = 0.0;
-	for ( int i=0; i<_obs.getSize(); i++ )
-		for ( int j=i; j<_obs.getSize(); j++ ){
-			if ( i< _nObsPdf1 && j< _nObsPdf1 ) continue;
-			if ( i>=_nObsPdf1 && j>=_nObsPdf1 ) continue;
-			if ( _invcov[i][j]==0 ) continue;
-			ret += _invcov[i][j] * (obs[i]-th[i]) * (obs[j]-th[j]);
-		}
-	return exp(-ret);
+	for ( int k=0; k<_entryVal.size(); k++ ){
+		ret += _entryVal[k] * _delta[_entryI[k]] * _delta[_entryJ[k]];
+	}
+	return ret;
+}
+
+///
+/// Return -2*log() of the PDF, without going through exp() and log().
+/// Used by RooGausChi2Var.
+///
+Double_t RooCrossCorPdf::getChi2() const
+{
+	return 2.*computeExponent();
+}
+
+///
+/// Return the log of the unnormalized PDF directly. Normalized values
+/// are left to RooAbsPdf.
+///
+Double_t RooCrossCorPdf::getLogVal(const RooArgSet* set) const
+{
+	if ( set ) return RooAbsPdf::getLogVal(set);
+	return -computeExponent();
+}
+
+Double_t RooCrossCorPdf::evaluate() const 
+{
+	return exp(-computeExponent());
 }
 
@@ -0,0 +1,98 @@
+#include "RooGausChi2Var.h"
+
+#include <iostream>
+
+///
+/// Create an empty chi2 function. Add the PDFs of the combination
+/// using addBlock().
+///
+/// \param pdf - the combined PDF whose -2*log() this chi2 reproduces
+///
+RooGausChi2Var::RooGausChi2Var(const char *name, const char *title, RooAbsPdf& pdf) :
+	RooAbsReal(name, title),
+	_pdf("pdf","combined pdf",this,pdf,kFALSE,kFALSE),
+	_th("th","theory",this,kTRUE,kFALSE),
+	_obs("obs","observables",this,kTRUE,kFALSE),
+	_crossCor("crossCor","cross correlation pdfs",this,kTRUE,kFALSE)
+{
+}
+
+RooGausChi2Var::RooGausChi2Var(const RooGausChi2Var& other, const char* name) :
+	RooAbsReal(other, name),
+	_pdf("pdf",this,other._pdf),
+	_th("th",this,other._th),
+	_obs("obs",this,other._obs),
+	_crossCor("crossCor",this,other._crossCor),
+	_blockSize(other._blockSize),
+	_invCov(other._invCov)
+{
+}
+
+///
+/// Add one multivariate Gaussian to the chi2.
+///
+/// \param th  - the theory relations, same order as the observables
+/// \param obs - the observables
+/// \param cov - the covariance matrix of the observables
+///
+void RooGausChi2Var::addBlock(const RooArgList& th, const RooArgList& obs, const TMatrixDSym& cov)
+{
+	int n = obs.getSize();
+	if ( th.getSize()!=n || cov.GetNrows()!=n ){
+		std::cout << "RooGausChi2Var::addBlock() : ERROR : inconsistent dimensions: th=" << th.getSize()
+			<< " obs=" << n << " cov=" << cov.GetNrows() << ". Exit." << std::endl;
+		exit(1);
+	}
+	TMatrixDSym invCov(cov);
+	invCov.Invert();
+	for ( int i=0; i<n; i++ )
+		for ( int j=0; j<n; j++ ) _invCov.push_back(invCov[i][j]);
+	_th.add(th);
+	_obs.add(obs);
+	_blockSize.push_back(n);
+}
+
+///
+/// Add a cross correlation PDF to the chi2. Its observables and theory
+/// relations must be those of blocks added through addBlock().
+///
+void RooGausChi2Var::addCrossCorPdf(RooCrossCorPdf& pdf)
+{
+	_crossCor.add(pdf);
+}
+
+///
+/// Fill the scratch vector _delta with th-obs of all blocks.
+///
+void RooGausChi2Var::computeDelta() const
+{
+	int n = _obs.getSize();
+	_delta.resize(n);
+	for ( int i=0; i<n; i++ ){
+		_delta[i] = ((RooAbsReal*)_th.at(i))->getVal() - ((RooAbsReal*)_obs.at(i))->getVal();
+	}
+}
+
+Double_t RooGausChi2Var::evaluate() const
+{
+	double chi2 = 0.0;
+	for ( int k=0; k<_crossCor.getSize(); k++ ){
+		chi2 += ((RooCrossCorPdf*)_crossCor.at(k))->getChi2();
+	}
+	computeDelta();
+	if ( _delta.size()==0 ) return chi2;
+	const double *d = &_delta[0];
+	const double *c = &_invCov[0];
+	for ( int b=0; b<_blockSize.size(); b++ ){
+		int n = _blockSize[b];
+		for ( int i=0; i<n; i++ ){
+			// use the symmetry of the inverse covariance
+			double row = 0.5*c[i*n+i]*d[i];
+			for ( int j=i+1; j<n; j++ ) row += c[i*n+j]*d[j];
+			chi2 += 2.*d[i]*row;
+		}
+		d += n;
+		c += n*n;
+	}
+	return chi2;
+}
@@ -0,0 +1,101 @@
+#include "RooImproveChi2Var.h"
+
+#include <iostream>
+#include <math.h>
+
+///
+/// Create the augmented chi2. The bump is off until a minimum
+/// was set with setMinimum().
+///
+/// \param chi2 - the chi2 to be augmented
+/// \param pars - all parameters the bump may depend on, usually the
+///               parameters of the combination
+///
+RooImproveChi2Var::RooImproveChi2Var(const char *name, const char *title, RooAbsReal& chi2, const RooArgList& pars) :
+	RooAbsReal(name, title),
+	_chi2("chi2","chi2",this,chi2),
+	_pars("pars","parameters",this),
+	_height(0.)
+{
+	_pars.add(pars);
+}
+
+RooImproveChi2Var::RooImproveChi2Var(const RooImproveChi2Var& other, const char* name) :
+	RooAbsReal(other, name),
+	_chi2("chi2",this,other._chi2),
+	_pars("pars",this,other._pars),
+	_index(other._index),
+	_mu(other._mu),
+	_invCov(other._invCov),
+	_height(other._height)
+{
+}
+
+void RooImproveChi2Var::setHeight(double height)
+{
+	_height = height;
+	setValueDirty();
+}
+
+///
+/// Move the bump to the minimum of a fit. Its position are the fitted
+/// values of the floating parameters, its width their covariance
+/// matrix. Floating parameters not contained in the parameter list
+/// given to the constructor are ignored.
+///
+/// \return false if the fit result has no usable covariance matrix,
+///         the bump is unchanged then
+///
+bool RooImproveChi2Var::setMinimum(const RooFitResult& r)
+{
+	const RooArgList& floatPars = r.floatParsFinal();
+	const TMatrixDSym& cov = r.covarianceMatrix();
+	if ( cov.GetNrows()!=floatPars.getSize() ) return false;
+
+	// positions of the parameters in the fit result and in _pars
+	std::vector<int> iFit;
+	std::vector<int> index;
+	for ( int i=0; i<floatPars.getSize(); i++ ){
+		RooAbsArg *p = _pars.find(floatPars.at(i)->GetName());
+		if ( !p ) continue;
+		iFit.push_back(i);
+		index.push_back(_pars.index(p));
+	}
+	int n = index.size();
+	if ( n==0 ) return false;
+
+	TMatrixDSym invCov(n);
+	for ( int i=0; i<n; i++ )
+		for ( int j=0; j<n; j++ ) invCov[i][j] = cov[iFit[i]][iFit[j]];
+	double det = 0.;
+	invCov.Invert(&det);
+	if ( det==0. ) return false;
+
+	_index = index;
+	_mu.resize(n);
+	for ( int i=0; i<n; i++ ) _mu[i] = ((RooAbsReal*)floatPars.at(iFit[i]))->getVal();
+	_invCov.resize(n*n);
+	for ( int i=0; i<n; i++ )
+		for ( int j=0; j<n; j++ ) _invCov[i*n+j] = invCov[i][j];
+	setValueDirty();
+	return true;
+}
+
+Double_t RooImproveChi2Var::evaluate() const
+{
+	double chi2 = _chi2;
+	int n = _index.size();
+	if ( _height==0. || n==0 ) return chi2;
+	_delta.resize(n);
+	for ( int i=0; i<n; i++ ) _delta[i] = ((RooAbsReal*)_pars.at(_index[i]))->getVal() - _mu[i];
+	const double *d = &_delta[0];
+	const double *c = &_invCov[0];
+	double alpha = 0.0;
+	for ( int i=0; i<n; i++ ){
+		// use the symmetry of the inverse covariance
+		double row = 0.5*c[i*n+i]*d[i];
+		for ( int j=i+1; j<n; j++ ) row += c[i*n+j]*d[j];
+		alpha += 2.*d[i]*row;
+	}
+	return chi2 + _height*exp(-0.5*alpha);
+}
@@ -1,5 +1,51 @@
 #include "RooSlimFitResult.h"
 
+map<string,RooSlimFitSchema*> RooSlimFitSchema::_schemas;
+
+RooSlimFitSchema::RooSlimFitSchema(const vector<string>& names, const vector<bool>& isConst, const vector<bool>& isAngle)
+{
+	_names = names;
+	_isConst = isConst;
+	_isAngle = isAngle;
+	int nFloat = 0;
+	for ( int i=0; i<_names.size(); i++ ){
+		_floatIds.push_back(_isConst[i] ? -1 : nFloat++);
+		if ( _index.find(_names[i])==_index.end() ) _index[_names[i]] = i;
+	}
+}
+
+///
+/// Get the shared schema for a list of parameters. A new schema
+/// is only created if no schema with exactly these parameters,
+/// in this order and with these flags, exists yet.
+///
+const RooSlimFitSchema* RooSlimFitSchema::intern(const vector<string>& names, const vector<bool>& isConst, const vector<bool>& isAngle)
+{
+	string key;
+	for ( int i=0; i<names.size(); i++ ){
+		key += names[i];
+		key += isConst[i] ? " c" : " f";
+		key += isAngle[i] ? "a\n" : "\n";
+	}
+	map<string,RooSlimFitSchema*>::iterator it = _schemas.find(key);
+	if ( it!=_schemas.end() ) return it->second;
+	RooSlimFitSchema *schema = new RooSlimFitSchema(names, isConst, isAngle);
+	_schemas[key] = schema;
+	return schema;
+}
+
+///
+/// Return the position of a parameter in the schema.
+/// \param name - the parameter name
+/// \return - the index, -1 if the parameter wasn't found.
+///
+int RooSlimFitSchema::getIndex(const TString& name) const
+{
+	map<string,int>::const_iterator it = _index.find(name.Data());
+	if ( it==_index.end() ) return -1;
+	return it->second;
+}
+
 RooSlimFitResult::RooSlimFitResult(RooFitResult* r, bool storeCorrelation)
 {
 	init(r, storeCorrelation);
@@ -7,7 +53,7 @@ RooSlimFitResult::RooSlimFitResult(RooFitResult* r, bool storeCorrelation)
 
 RooSlimFitResult::RooSlimFitResult(RooSlimFitResult* r)
 {
-	init(r);
+	copy(r);
 }
 
 ///
@@ -16,7 +62,7 @@ RooSlimFitResult::RooSlimFitResult(RooSlimFitResult* r)
 RooSlimFitResult::RooSlimFitResult(const RooSlimFitResult &r) :
 	TObject(reinterpret_cast<const TObject&>(r))
 {
-	init(&r);
+	copy(&r);
 }
 
 ///
@@ -25,6 +71,7 @@ RooSlimFitResult::RooSlimFitResult(const RooSlimFitResult &r) :
 	RooSlimFitResult::RooSlimFitResult()
 : _correlationMatrix(0)
 {
+	_schema = 0;
 	_edm = std::numeric_limits<double>::quiet_NaN(); // set to nan
 	_minNLL = std::numeric_limits<double>::quiet_NaN();
 	_covQual = -9;
@@ -41,6 +88,24 @@ RooSlimFitResult* RooSlimFitResult::Clone()
 	return new RooSlimFitResult(this);
 }
 
+///
+/// Helper for the copy constructors. Shares the schema of the other
+/// fit result. Like in a copy from a RooFitResult without correlation,
+/// the correlation matrix isn't copied and the copy is not confirmed.
+///
+void RooSlimFitResult::copy(const RooSlimFitResult *r)
+{
+	assert(r);
+	_schema = r->_schema;
+	_parsVal = r->_parsVal;
+	_parsErr = r->_parsErr;
+	_covQual = r->_covQual;
+	_edm = r->_edm;
+	_minNLL = r->_minNLL;
+	_status = r->_status;
+	_isConfirmed = false;
+}
+
 ///
 /// Return a RooArgList of RooRealVars that constitute the
 /// constant fit parameters. Ownership belongs to this class,
@@ -52,13 +117,13 @@ RooArgList& RooSlimFitResult::constPars() const
 	if ( _constParsDummy.getSize()>0 ) return _constParsDummy;
 	// create a RooArgList out of the content in the map
 	_constParsDummy.removeAll();
-	for ( int i=0; i<_parsNames.size(); i++ ){
-		if (!_parsConst[i]) continue;
-		TString name(_parsNames[i]);
+	for ( int i=0; i<getNpars(); i++ ){
+		if (!_schema->isConst(i)) continue;
+		TString name(_schema->getName(i));
 		float value = _parsVal[i];
 		RooRealVar var(name,name,value);
 		var.setConstant(true);
-		var.setUnit(_parsAngle[i] ? "Rad" : "" );
+		var.setUnit(_schema->isAngle(i) ? "Rad" : "" );
 		_constParsDummy.addClone(var);
 	}
 	return _constParsDummy;
@@ -74,15 +139,15 @@ RooArgList& RooSlimFitResult::floatParsFinal() const
 	if ( _floatParsFinalDummy.getSize()>0 ) return _floatParsFinalDummy;
 	// create a RooArgList out of the content in the map
 	_floatParsFinalDummy.removeAll();
-	for ( int i=0; i<_parsNames.size(); i++ ){
-		if (_parsConst[i]) continue;
-		TString name(_parsNames[i]);
+	for ( int i=0; i<getNpars(); i++ ){
+		if (_schema->isConst(i)) continue;
+		TString name(_schema->getName(i));
 		float value = _parsVal[i];
 		float error = _parsErr[i];
 		RooRealVar var(name,name,value);
 		var.setError(error);
 		var.setConstant(false);
-		var.setUnit(_parsAngle[i] ? "Rad" : "" );
+		var.setUnit(_schema->isAngle(i) ? "Rad" : "" );
 		_floatParsFinalDummy.addClone(var);
 	}
 	return _floatParsFinalDummy;
@@ -96,11 +161,9 @@ RooArgList& RooSlimFitResult::floatParsFinal() const
 ///
 float RooSlimFitResult::getConstParVal(TString name) const
 {
-	for ( int i=0; i<_parsNames.size(); i++ ){
-		if ( !_parsConst[i] ) continue;
-		if ( TString(_parsNames[i])==name ) return _parsVal[i];
-	}
-	return std::numeric_limits<double>::quiet_NaN(); // return nan
+	int i = getParIndex(name);
+	if ( i<0 || !_schema->isConst(i) ) return std::numeric_limits<double>::quiet_NaN(); // return nan
+	return _parsVal[i];
 }
 
 ///
@@ -111,11 +174,9 @@ float RooSlimFitResult::getConstParVal(TString name) const
 ///
 float RooSlimFitResult::getFloatParFinalVal(TString name) const
 {
-	for ( int i=0; i<_parsNames.size(); i++ ){
-		if ( _parsConst[i] ) continue;
-		if ( TString(_parsNames[i])==name ) return _parsVal[i];
-	}
-	return std::numeric_limits<double>::quiet_NaN(); // return nan
+	int i = getParIndex(name);
+	if ( i<0 || _schema->isConst(i) ) return std::numeric_limits<double>::quiet_NaN(); // return nan
+	return _parsVal[i];
 }
 
 ///
@@ -126,10 +187,9 @@ float RooSlimFitResult::getFloatParFinalVal(TString name) const
 ///
 float RooSlimFitResult::getParVal(TString name) const
 {
-	for ( int i=0; i<_parsNames.size(); i++ ){
-		if ( TString(_parsNames[i])==name ) return _parsVal[i];
-	}
-	return std::numeric_limits<double>::quiet_NaN(); // return nan
+	int i = getParIndex(name);
+	if ( i<0 ) return std::numeric_limits<double>::quiet_NaN(); // return nan
+	return _parsVal[i];
 }
 
 ///
@@ -140,10 +200,9 @@ float RooSlimFitResult::getParVal(TString name) const
 ///
 float RooSlimFitResult::getParErr(TString name) const
 {
-	for ( int i=0; i<_parsNames.size(); i++ ){
-		if ( TString(_parsNames[i])==name ) return _parsErr[i];
-	}
-	return std::numeric_limits<double>::quiet_NaN(); // return nan
+	int i = getParIndex(name);
+	if ( i<0 ) return std::numeric_limits<double>::quiet_NaN(); // return nan
+	return _parsErr[i];
 }
 
 ///
@@ -154,10 +213,7 @@ float RooSlimFitResult::getParErr(TString name) const
 ///
 bool RooSlimFitResult::hasParameter(TString name) const
 {
-	for ( int i=0; i<_parsNames.size(); i++ ){
-		if ( TString(_parsNames[i])==name ) return true;
-	}
-	return false;
+	return getParIndex(name)>=0;
 }
 
 void RooSlimFitResult::Print(bool verbose, bool printcor)
@@ -168,25 +224,26 @@ void RooSlimFitResult::Print(bool verbose, bool printcor)
 	cout << endl;
 	cout << "    Parameter                      FinalValue +/- Error " << (_isConfirmed?"(HESSE)":"(MIGRAD)") << endl;
 	cout << "  ----------------------------   ---------------------------------" << endl;
-	for ( int i=0; i<_parsNames.size(); i++ ){
+	for ( int i=0; i<getNpars(); i++ ){
+		TString name(_schema->getName(i));
 		float val = _parsVal[i];
 		float err = _parsErr[i];
-		if (_parsAngle[i]){
+		if (_schema->isAngle(i)){
 			val *= 180./TMath::Pi();
 			err *= 180./TMath::Pi();
 		}
 		// print constant parameters
-		if (_parsConst[i]){
-			if ( ! TString(_parsNames[i]).Contains("obs") ){
-				printf("       %22s    %11.6g +/- %10.6g (const)", TString(_parsNames[i]).Data(), val, err);
-				if (_parsAngle[i]) cout << " (Deg)";
+		if (_schema->isConst(i)){
+			if ( ! name.Contains("obs") ){
+				printf("       %22s    %11.6g +/- %10.6g (const)", name.Data(), val, err);
+				if (_schema->isAngle(i)) cout << " (Deg)";
 				cout << endl;
 			}
 		}
 		// print floating parameters
 		else{
-			printf("    %2i %22s    %11.6g +/- %10.6g", _parsFloatId[i], TString(_parsNames[i]).Data(), val, err);
-			if (_parsAngle[i]) cout << " (Deg)";
+			printf("    %2i %22s    %11.6g +/- %10.6g", _schema->getFloatId(i), name.Data(), val, err);
+			if (_schema->isAngle(i)) cout << " (Deg)";
 			cout << endl;
 		}
 	}
@@ -200,7 +257,170 @@ void RooSlimFitResult::Print(bool verbose, bool printcor)
 }
 
 
+///
+/// Helper function for readVersion1(). Reads the header of an STL
+/// container member: byte count, version, and number of elements.
+///
+/// \return the number of elements, -1 if it doesn't fit before end
+///
+static Int_t readStlHeader(TBuffer &R__b, UInt_t end)
+{
+	UInt_t R__s, R__c;
+	R__b.ReadVersion(&R__s, &R__c);
+	Int_t n;
+	R__b >> n;
+	if ( n<0 || R__b.Length()+n>(Int_t)end ) return -1;
+	return n;
+}
+
+///
+/// Helper function for Streamer(). Reads a fit result of version 1,
+/// which the automatic streamer wrote member by member: the names, float
+/// IDs, values, errors, angle and constant flags of the parameters as
+/// STL vectors, then the fit quantities, the correlation matrix, and the
+/// confirmed flag. The schema is interned from the names and flags, the
+/// float IDs follow from it. If the layout doesn't match the byte count,
+/// the fit result is skipped and read empty, without schema, see
+/// MethodAbsScan::loadScanner().
+///
+void RooSlimFitResult::readVersion1(TBuffer &R__b, UInt_t R__s, UInt_t R__c)
+{
+	_schema = 0;
+	_parsVal.clear();
+	_parsErr.clear();
+	if ( R__c==0 ){
+		cout << "RooSlimFitResult::readVersion1() : ERROR : fit result of version 1 without byte count. Exit." << endl;
+		exit(1);
+	}
+	UInt_t end = R__s + R__c + sizeof(UInt_t);
+	vector<string> names;
+	vector<bool> isConst;
+	vector<bool> isAngle;
+	bool ok = true;
+	TObject::Streamer(R__b);
+	Int_t n = readStlHeader(R__b, end);
+	for ( int i=0; i<n; i++ ){
+		TString name;
+		name.Streamer(R__b);
+		names.push_back(name.Data());
+	}
+	ok = ok && n>=0;
+	n = readStlHeader(R__b, end);
+	vector<Int_t> floatIds(n>0 ? n : 0);
+	if ( n>0 ) R__b.ReadFastArray(&floatIds[0], n);
+	ok = ok && n==names.size();
+	n = readStlHeader(R__b, end);
+	_parsVal.resize(n>0 ? n : 0);
+	if ( n>0 ) R__b.ReadFastArray(&_parsVal[0], n);
+	ok = ok && n==names.size();
+	n = readStlHeader(R__b, end);
+	_parsErr.resize(n>0 ? n : 0);
+	if ( n>0 ) R__b.ReadFastArray(&_parsErr[0], n);
+	ok = ok && n==names.size();
+	n = readStlHeader(R__b, end);
+	for ( int i=0; i<n; i++ ){
+		Bool_t a;
+		R__b >> a;
+		isAngle.push_back(a);
+	}
+	ok = ok && n==names.size();
+	n = readStlHeader(R__b, end);
+	for ( int i=0; i<n; i++ ){
+		Bool_t c;
+		R__b >> c;
+		isConst.push_back(c);
+	}
+	ok = ok && n==names.size();
+	if ( ok ){
+		R__b >> _edm >> _minNLL >> _covQual >> _status;
+		_correlationMatrix.Streamer(R__b);
+		Bool_t confirmed;
+		R__b >> confirmed;
+		_isConfirmed = confirmed;
+	}
+	if ( !ok || R__b.Length()!=end ){
+		static bool warned = false;
+		if ( !warned ){
+			cout << "RooSlimFitResult::readVersion1() : WARNING : couldn't decode a fit result of version 1, skipping it." << endl;
+			warned = true;
+		}
+		R__b.SetBufferOffset(end);
+		_parsVal.clear();
+		_parsErr.clear();
+		return;
+	}
+	_schema = RooSlimFitSchema::intern(names, isConst, isAngle);
+}
+
 bool RooSlimFitResult::isAngle(RooRealVar* v)
 {
 	return v->getUnit()==TString("Rad") || v->getUnit()==TString("rad");
 }
+
+///
+/// Custom streamer, needed because the shared schema can't be written
+/// by the automatic one. Each fit result is written self-contained,
+/// with the names and flags of its parameters, and the schema is
+/// interned again when reading. Version 1, written by the automatic
+/// streamer before the schema was introduced, is read by readVersion1().
+///
+void RooSlimFitResult::Streamer(TBuffer &R__b)
+{
+	UInt_t R__s, R__c;
+	if ( R__b.IsReading() ){
+		Version_t R__v = R__b.ReadVersion(&R__s, &R__c);
+		if ( R__v<2 ){
+			readVersion1(R__b, R__s, R__c);
+			return;
+		}
+		TObject::Streamer(R__b);
+		Int_t n;
+		R__b >> n;
+		vector<string> names(n);
+		vector<bool> isConst(n);
+		vector<bool> isAngle(n);
+		for ( int i=0; i<n; i++ ){
+			TString name;
+			Bool_t c, a;
+			name.Streamer(R__b);
+			R__b >> c >> a;
+			names[i] = name.Data();
+			isConst[i] = c;
+			isAngle[i] = a;
+		}
+		_schema = RooSlimFitSchema::intern(names, isConst, isAngle);
+		_parsVal.resize(n);
+		_parsErr.resize(n);
+		if ( n>0 ){
+			R__b.ReadFastArray(&_parsVal[0], n);
+			R__b.ReadFastArray(&_parsErr[0], n);
+		}
+		R__b >> _edm >> _minNLL >> _covQual >> _status;
+		_correlationMatrix.Streamer(R__b);
+		Bool_t confirmed;
+		R__b >> confirmed;
+		_isConfirmed = confirmed;
+		_constParsDummy.removeAll();
+		_floatParsFinalDummy.removeAll();
+		R__b.CheckByteCount(R__s, R__c, RooSlimFitResult::IsA());
+	}
+	else {
+		R__c = R__b.WriteVersion(RooSlimFitResult::IsA(), kTRUE);
+		TObject::Streamer(R__b);
+		Int_t n = getNpars();
+		R__b << n;
+		for ( int i=0; i<n; i++ ){
+			TString name(_schema->getName(i));
+			name.Streamer(R__b);
+			R__b << (Bool_t)_schema->isConst(i) << (Bool_t)_schema->isAngle(i);
+		}
+		if ( n>0 ){
+			R__b.WriteFastArray(&_parsVal[0], n);
+			R__b.WriteFastArray(&_parsErr[0], n);
+		}
+		R__b << _edm << _minNLL << _covQual << _status;
+		_correlationMatrix.Streamer(R__b);
+		R__b << (Bool_t)_isConfirmed;
+		R__b.SetByteCount(R__c, kTRUE);
+	}
+}
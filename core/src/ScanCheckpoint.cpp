@@ -0,0 +1,136 @@
+#include "ScanCheckpoint.h"
+
+time_t ScanCheckpoint::programStart = time(0);
+
+///
+/// \param arg - command line options, uses --checkpoint, --walltime
+/// \param fileName - the output file of the job
+///
+ScanCheckpoint::ScanCheckpoint(OptParser *arg, TString fileName)
+{
+	this->arg = arg;
+	this->fileName = fileName;
+	lastWrite = time(0);
+	point = 0;
+	toy = 0;
+	stopped = false;
+}
+
+ScanCheckpoint::~ScanCheckpoint()
+{}
+
+///
+/// Continue a job from its output file. The toys of the file are
+/// copied into the tree, and the progress record is loaded, see
+/// getPoint() and getToy(). Unless --seed is given, the random numbers
+/// are keyed by the seed of the original job.
+///
+/// \param t - the ToyTree of the job, after init()
+/// \return false if the file holds a finished job, true otherwise,
+///         also if there is no file
+///
+bool ScanCheckpoint::resume(ToyTree *t)
+{
+	if ( !Utils::FileExists(fileName) ){
+		cout << "ScanCheckpoint::resume() : no checkpoint " << fileName << ", starting from scratch." << endl;
+		return true;
+	}
+	TFile *f = TFile::Open(fileName);
+	TTree *saved = f ? (TTree*)f->Get("plugin") : 0;
+	if ( !saved ){
+		cout << "ScanCheckpoint::resume() : ERROR : no toys found in " << fileName << ". Exit." << endl;
+		exit(1);
+	}
+	TParameter<int> *savedPoint = (TParameter<int>*)f->Get("checkpointPoint");
+	TParameter<int> *savedToy = (TParameter<int>*)f->Get("checkpointToy");
+	TParameter<Long64_t> *savedSeed = (TParameter<Long64_t>*)f->Get("checkpointSeed");
+	if ( !savedPoint || !savedToy ){
+		cout << "ScanCheckpoint::resume() : " << fileName << " holds a finished job, nothing to do." << endl;
+		f->Close();
+		delete f;
+		return false;
+	}
+	if ( saved->GetListOfBranches()->GetEntries()!=t->getTree()->GetListOfBranches()->GetEntries() ){
+		cout << "ScanCheckpoint::resume() : ERROR : the toys in " << fileName << " have different branches."
+			" Resume with the same options as the original job. Exit." << endl;
+		exit(1);
+	}
+	t->getTree()->CopyEntries(saved);
+	point = savedPoint->GetVal();
+	toy = savedToy->GetVal();
+	if ( savedSeed && arg->seed==0 ) CounterRng::configure(savedSeed->GetVal(), arg->nrun);
+	cout << "ScanCheckpoint::resume() : resuming at scan point " << point << ", toy " << toy
+		<< ", with " << t->getTree()->GetEntries() << " toys from " << fileName
+		<< ", seed " << CounterRng::getMasterSeed() << endl;
+	f->Close();
+	delete f;
+	return true;
+}
+
+///
+/// Checks the wall time budget, --walltime.
+///
+bool ScanCheckpoint::isOutOfTime() const
+{
+	return arg->walltime>0 && difftime(time(0), programStart) >= 60.*arg->walltime;
+}
+
+///
+/// Report the progress of the job. Writes a checkpoint if one is due,
+/// or if the wall time budget is used up. Call this only between toys,
+/// when all toys before the given position are in the tree.
+///
+/// \param t - the ToyTree of the job
+/// \param nextPoint - the scan point to continue with
+/// \param nextToy - the toy of that scan point to continue with
+/// \return true if the job has to stop
+///
+bool ScanCheckpoint::update(ToyTree *t, int nextPoint, int nextToy)
+{
+	bool outOfTime = isOutOfTime();
+	bool due = arg->checkpoint>0 && difftime(time(0), lastWrite) >= 60.*arg->checkpoint;
+	if ( !due && !outOfTime ) return false;
+	point = nextPoint;
+	toy = nextToy;
+	write(t, false);
+	if ( outOfTime ){
+		cout << "ScanCheckpoint::update() : wall time budget of " << arg->walltime << " min used up, stopping at scan point "
+			<< point << ", toy " << toy << ". Continue with --resume." << endl;
+		stopped = true;
+	}
+	return stopped;
+}
+
+///
+/// Write the finished job, without progress record.
+///
+void ScanCheckpoint::writeFinal(ToyTree *t)
+{
+	write(t, true);
+}
+
+///
+/// Write the tree, and the progress record unless the job is finished,
+/// under a temporary name, then replace the output file by it.
+///
+void ScanCheckpoint::write(ToyTree *t, bool final)
+{
+	TString tmpName = fileName+".tmp";
+	if ( arg->debug ) cout << "ScanCheckpoint::write() : ";
+	if ( final ) cout << "saving toys to: " << fileName << endl;
+	else cout << "saving checkpoint to: " << fileName << endl;
+	TFile *f = new TFile(tmpName, "recreate");
+	t->getTree()->Write();
+	if ( !final ){
+		TParameter<int>("checkpointPoint", point).Write();
+		TParameter<int>("checkpointToy", toy).Write();
+		TParameter<Long64_t>("checkpointSeed", CounterRng::getMasterSeed()).Write();
+	}
+	f->Close();
+	delete f;
+	if ( rename(tmpName, fileName)!=0 ){
+		cout << "ScanCheckpoint::write() : ERROR : couldn't rename " << tmpName << " to " << fileName << ". Exit." << endl;
+		exit(1);
+	}
+	lastWrite = time(0);
+}
@@ -0,0 +1,384 @@
+#include "ToyGenerator.h"
+
+const double ToyGenerator::defensiveFraction = 0.3;
+
+///
+/// Set up the generator for a combination. The Cholesky
+/// factors of all Gaussian PDFs are computed here.
+///
+/// \param c - the combiner, combine() must have been called
+///
+ToyGenerator::ToyGenerator(Combiner *c)
+{
+	if ( !c->isCombined() ){
+		cout << "ToyGenerator::ToyGenerator() : ERROR : combiner " << c->getName() << " needs to be combined first. Exit." << endl;
+		exit(1);
+	}
+	w = c->getWorkspace();
+	nToys = 0;
+	firstToy = 0;
+	streamPoint = 0;
+	tailSampling = false;
+	proposalScale = 1.;
+
+	// fix the order of the observables in the toy array
+	TIterator* it = w->set(c->getObsName())->createIterator();
+	while ( RooRealVar* p = (RooRealVar*)it->Next() ) observables.push_back(p);
+	delete it;
+
+	// cross correlation PDFs share observables with the other PDFs,
+	// generate the full combined PDF then
+	vector<PDF_Abs*>& pdfs = c->getPdfs();
+	for ( int i=0; i<pdfs.size(); i++ ){
+		if ( pdfs[i]->isCrossCorPdf() ){
+			addRooFitPdf(w->pdf("pdf_"+c->getPdfName()), w->set(c->getObsName()));
+			return;
+		}
+	}
+
+	for ( int i=0; i<pdfs.size(); i++ ){
+		RooAbsPdf *pdf = w->pdf(pdfs[i]->getPdf()->GetName());
+		if ( !pdf->InheritsFrom("RooMultiVarGaussian") ){
+			addRooFitPdf(pdf, w->set("obs_"+pdfs[i]->getName()));
+			continue;
+		}
+		const TMatrixDSym& cov = ((RooMultiVarGaussian*)pdf)->covarianceMatrix();
+		int n = pdfs[i]->getObservables()->getSize();
+		TDecompChol chol(cov);
+		if ( cov.GetNrows()!=n || !chol.Decompose() ){
+			cout << "ToyGenerator::ToyGenerator() : WARNING : no Cholesky decomposition for PDF "
+				<< pdfs[i]->getName() << ", using RooFit to generate its toys." << endl;
+			addRooFitPdf(pdf, w->set("obs_"+pdfs[i]->getName()));
+			continue;
+		}
+		// TDecompChol computes the upper triangle U with cov = U^T U
+		const TMatrixD& U = chol.GetU();
+		for ( int k=0; k<n; k++ ){
+			gausTheory.push_back(w->function(pdfs[i]->getTheory()->at(k)->GetName()));
+			TString obsName = pdfs[i]->getObservables()->at(k)->GetName();
+			int index = -1;
+			for ( int l=0; l<observables.size(); l++ ){
+				if ( obsName==observables[l]->GetName() ) index = l;
+			}
+			if ( index<0 ){
+				cout << "ToyGenerator::ToyGenerator() : ERROR : observable " << obsName << " not found in the combination. Exit." << endl;
+				exit(1);
+			}
+			gausObsIndex.push_back(index);
+			for ( int l=0; l<n; l++ ) gausCholesky.push_back(l<=k ? U[l][k] : 0.);
+		}
+		gausBlockSize.push_back(n);
+	}
+}
+
+ToyGenerator::~ToyGenerator()
+{}
+
+void ToyGenerator::addRooFitPdf(RooAbsPdf *pdf, const RooArgSet *obs)
+{
+	rooFitPdfs.push_back(pdf);
+	rooFitObs.push_back(obs);
+}
+
+///
+/// Draw the Gaussian toys from a proposal that is widened towards the
+/// data, and weight them accordingly. The proposal is computed from the
+/// current parameter values by each call of generate(), or by
+/// updateProposal().
+///
+/// \param data - the observables of the data, 0 switches tail sampling off
+///
+void ToyGenerator::setTailSampling(const RooArgSet *data)
+{
+	tailSampling = data!=0;
+	proposalScale = 1.;
+	if ( !tailSampling ) return;
+	if ( gausBlockSize.empty() ){
+		cout << "ToyGenerator::setTailSampling() : WARNING : no Gaussian PDFs that can be widened, toys will not be weighted." << endl;
+	}
+	tailData.resize(gausObsIndex.size());
+	for ( int k=0; k<gausObsIndex.size(); k++ ){
+		tailData[k] = data->getRealValue(observables[gausObsIndex[k]]->GetName());
+	}
+}
+
+///
+/// Compute the proposal of the tail sampling at the current parameter
+/// values: the direction u towards the data and the scale s.
+///
+/// \return the scale s, 1 if tail sampling is off
+///
+double ToyGenerator::updateProposal()
+{
+	proposalScale = 1.;
+	if ( !tailSampling || gausBlockSize.empty() ) return proposalScale;
+	tailDirection.assign(gausObsIndex.size(), 0.);
+	double r2 = 0.;
+	int offset = 0;
+	int cholOffset = 0;
+	for ( int b=0; b<gausBlockSize.size(); b++ ){
+		int n = gausBlockSize[b];
+		const double *L = &gausCholesky[cholOffset];
+		// solve L*y = data - th by forward substitution
+		for ( int k=0; k<n; k++ ){
+			double y = tailData[offset+k] - gausTheory[offset+k]->getVal();
+			for ( int l=0; l<k; l++ ) y -= L[k*n+l]*tailDirection[offset+l];
+			y /= L[k*n+k];
+			tailDirection[offset+k] = y;
+			r2 += y*y;
+		}
+		offset += n;
+		cholOffset += n*n;
+	}
+	if ( r2==0. ) return proposalScale;
+	double r = sqrt(r2);
+	for ( int k=0; k<tailDirection.size(); k++ ) tailDirection[k] /= r;
+	proposalScale = TMath::Max(1., r/2.);
+	return proposalScale;
+}
+
+///
+/// Approximate probability that a toy from the proposal has a test
+/// statistic above dchi2, for --importance. The widened part of the
+/// mixture is approximated by a chi2 distribution scaled by s^2.
+///
+double ToyGenerator::getProposalPvalue(double dchi2) const
+{
+	double p = TMath::Prob(dchi2, 1);
+	if ( proposalScale==1. ) return p;
+	return defensiveFraction*p + (1.-defensiveFraction)*TMath::Prob(dchi2/(proposalScale*proposalScale), 1);
+}
+
+///
+/// Generate toys at the current values of the parameters.
+/// Toy j is drawn from the CounterRng stream (point, firstToy+j) of the
+/// scan point set by setStreamKey(). RooFit is seeded from the stream of
+/// the first toy. With tail sampling, the proposal is updated first.
+///
+/// \param nToys - generate this many toys
+/// \param firstToy - stream number of the first toy
+///
+void ToyGenerator::generate(int nToys, int firstToy)
+{
+	this->nToys = nToys;
+	this->firstToy = firstToy;
+	int nObs = observables.size();
+	toys.assign(nToys*nObs, 0.);
+	logWeights.assign(nToys, 0.);
+
+	if ( nToys==0 ) return;
+
+	// theory values of the Gaussian PDFs, the same for all toys
+	vector<double> th(gausTheory.size());
+	for ( int k=0; k<gausTheory.size(); k++ ) th[k] = gausTheory[k]->getVal();
+	updateProposal();
+
+	// Gaussian PDFs. Like RooMultiVarGaussian::generateEvent(), redraw
+	// a toy of a PDF if it falls outside the range of one of its observables.
+	vector<double> z;
+	vector<double> x;
+	for ( int j=0; j<nToys; j++ ){
+		CounterRng rng = CounterRng::stream(streamPoint, firstToy+j, CounterRng::kSubStreamGaus);
+		double *toy = &toys[j*nObs];
+		if ( proposalScale>1. ){
+			generateTailToy(rng, th, toy, logWeights[j]);
+			continue;
+		}
+		int offset = 0;
+		int cholOffset = 0;
+		for ( int b=0; b<gausBlockSize.size(); b++ ){
+			int n = gausBlockSize[b];
+			const double *L = &gausCholesky[cholOffset];
+			z.resize(n);
+			x.resize(n);
+			bool inRange;
+			do {
+				for ( int k=0; k<n; k++ ) z[k] = rng.gaus();
+				inRange = true;
+				for ( int k=0; k<n; k++ ){
+					x[k] = th[offset+k];
+					for ( int l=0; l<=k; l++ ) x[k] += L[k*n+l]*z[l];
+					RooRealVar *obs = observables[gausObsIndex[offset+k]];
+					if ( x[k]<obs->getMin() || x[k]>obs->getMax() ) inRange = false;
+				}
+			} while ( !inRange );
+			for ( int k=0; k<n; k++ ) toy[gausObsIndex[offset+k]] = x[k];
+			offset += n;
+			cholOffset += n*n;
+		}
+	}
+
+	// all other PDFs
+	if ( rooFitPdfs.empty() ) return;
+	CounterRng rng = CounterRng::stream(streamPoint, firstToy, CounterRng::kSubStreamRooFit);
+	RooRandom::randomGenerator()->SetSeed(rng.seed());
+	for ( int i=0; i<rooFitPdfs.size(); i++ ) generateRooFit(i);
+}
+
+///
+/// Helper function for generate(). Draws the Gaussian observables of one
+/// toy from the tail sampling proposal, see updateProposal(). As the
+/// widening couples all Gaussian PDFs, the whole toy is redrawn if one
+/// observable falls outside its range.
+///
+/// \param rng - the stream of the toy
+/// \param th - the theory values of the Gaussian PDFs
+/// \param toy - the toy in the toy array
+/// \param logWeight - return value: log of the weight of the toy
+///
+void ToyGenerator::generateTailToy(CounterRng &rng, const vector<double> &th, double *toy, double &logWeight)
+{
+	int nGaus = gausObsIndex.size();
+	double s = proposalScale;
+	double a = defensiveFraction;
+	vector<double> z(nGaus);
+	bool inRange;
+	do {
+		bool widen = rng.uniform()>=a;
+		for ( int k=0; k<nGaus; k++ ) z[k] = rng.gaus();
+		double t = 0.;
+		for ( int k=0; k<nGaus; k++ ) t += tailDirection[k]*z[k];
+		if ( widen ){
+			for ( int k=0; k<nGaus; k++ ) z[k] += (s-1.)*t*tailDirection[k];
+			t *= s;
+		}
+		// log(1/(a + exp(c))), computed without overflow
+		double c = log((1.-a)/s) + 0.5*(1.-1./(s*s))*t*t;
+		double hi = TMath::Max(log(a), c);
+		logWeight = -(hi + log(exp(log(a)-hi) + exp(c-hi)));
+		inRange = true;
+		int offset = 0;
+		int cholOffset = 0;
+		for ( int b=0; b<gausBlockSize.size(); b++ ){
+			int n = gausBlockSize[b];
+			const double *L = &gausCholesky[cholOffset];
+			for ( int k=0; k<n; k++ ){
+				double x = th[offset+k];
+				for ( int l=0; l<=k; l++ ) x += L[k*n+l]*z[offset+l];
+				RooRealVar *obs = observables[gausObsIndex[offset+k]];
+				if ( x<obs->getMin() || x>obs->getMax() ) inRange = false;
+				toy[gausObsIndex[offset+k]] = x;
+			}
+			offset += n;
+			cholOffset += n*n;
+		}
+	} while ( !inRange );
+}
+
+///
+/// Helper function for generate(). Generates the toys of one PDF
+/// through RooFit and copies them into the toy array.
+///
+void ToyGenerator::generateRooFit(int iPdf)
+{
+	RooAbsPdf *pdf = rooFitPdfs[iPdf];
+	const RooArgSet *obs = rooFitObs[iPdf];
+	RooMsgService::instance().setStreamStatus(0,kFALSE);
+	RooMsgService::instance().setStreamStatus(1,kFALSE);
+	RooDataSet* dataset = pdf->generate(*obs, nToys, AutoBinned(false));
+	RooMsgService::instance().setStreamStatus(0,kTRUE);
+	RooMsgService::instance().setStreamStatus(1,kTRUE);
+
+	// The following code is an embarrasment. Something goes wrong
+	// in RooFit's toy generation when a Th2F PDF is used. We try to
+	// work around it.
+	// Sometimes there is an error from TFoam (the TH2F clearly isn't zero):
+	// Error in <TFoam::MakeActiveList>: Integrand function is zero
+	// Then it proceeds "generating" observables that are, in every toy, set to their boundaries.
+	// This happens only for kD_k3pi_obs.
+	// Workaround: If it happens, flucutate the parameters of the histogram
+	// ever so slightly and regenerate.
+
+	// read the generated values for one variable from the
+	// first two toys
+	bool hasK3pi = false;
+	float generatedValues[2];
+	for ( int i=0; i<2 && i<nToys; i++ ){
+		const RooArgSet* toyData = dataset->get(i);
+		TIterator* it = toyData->createIterator();
+		while(RooRealVar* var = (RooRealVar*)it->Next()){
+			if ( TString(var->GetName()).Contains("kD_k3pi_obs") ){
+				hasK3pi = true;
+				generatedValues[i] = var->getVal();
+				continue;
+			}
+		}
+		delete it;
+	}
+
+	// check if they are the same, if so, fluctuate and regenerate
+	if ( hasK3pi && nToys>1 && generatedValues[0]==generatedValues[1] ){
+		delete dataset;
+		cout << "kD_k3pi_obs GENERATION ERROR AT kD_k3pi=" << w->var("kD_k3pi")->getVal()
+			<< " dD_k3pi=" << w->var("dD_k3pi")->getVal() << endl;
+		TRandom3 r;
+		w->var("kD_k3pi")->setVal(r.Gaus(w->var("kD_k3pi")->getVal(),0.05));
+		w->var("dD_k3pi")->setVal(r.Gaus(w->var("dD_k3pi")->getVal(),0.05));
+		cout << "kD_k3pi_obs SECOND GENERATION AT kD_k3pi=" << w->var("kD_k3pi")->getVal()
+			<< " dD_k3pi=" << w->var("dD_k3pi")->getVal() << endl;
+		RooMsgService::instance().setStreamStatus(0,kFALSE);
+		RooMsgService::instance().setStreamStatus(1,kFALSE);
+		dataset = pdf->generate(*obs, nToys, AutoBinned(false));
+		RooMsgService::instance().setStreamStatus(0,kTRUE);
+		RooMsgService::instance().setStreamStatus(1,kTRUE);
+		for ( int i=0; i<2; i++ ){
+			const RooArgSet* toyData = dataset->get(i);
+			TIterator* it = toyData->createIterator();
+			while(RooRealVar* var = (RooRealVar*)it->Next()){
+				if ( TString(var->GetName()).Contains("kD_k3pi_obs") ){
+					generatedValues[i] = var->getVal();
+					continue;
+				}
+			}
+			delete it;
+		}
+		cout << "kD_k3pi_obs NEW VALUES : toy 0: " << generatedValues[0] << " toy 1: " << generatedValues[1] << endl;
+	}
+
+	// copy into the toy array. RooDataSet::get() always returns
+	// the same row object, so look up the variables only once
+	int nObs = observables.size();
+	const RooArgSet* row = dataset->get(0);
+	vector<RooRealVar*> rowVars;
+	vector<int> rowIndex;
+	for ( int l=0; l<nObs; l++ ){
+		RooRealVar *var = (RooRealVar*)row->find(observables[l]->GetName());
+		if ( !var ) continue;
+		rowVars.push_back(var);
+		rowIndex.push_back(l);
+	}
+	for ( int j=0; j<nToys; j++ ){
+		dataset->get(j);
+		double *toy = &toys[j*nObs];
+		for ( int l=0; l<rowVars.size(); l++ ) toy[rowIndex[l]] = rowVars[l]->getVal();
+	}
+	delete dataset;
+}
+
+///
+/// Set the observables in the workspace to the values of a toy.
+///
+/// \param j - the toy number
+///
+void ToyGenerator::loadToy(int j)
+{
+	if ( j<0 || j>=nToys ){
+		cout << "ToyGenerator::loadToy() : ERROR : toy " << j << " out of range, have " << nToys << " toys. Exit." << endl;
+		exit(1);
+	}
+	int nObs = observables.size();
+	const double *toy = &toys[j*nObs];
+	for ( int l=0; l<nObs; l++ ) observables[l]->setVal(toy[l]);
+}
+
+///
+/// Print the observables of a toy.
+///
+void ToyGenerator::print(int j) const
+{
+	int nObs = observables.size();
+	cout << "ToyGenerator::print() : toy " << j << endl;
+	for ( int l=0; l<nObs; l++ ){
+		cout << "  " << observables[l]->GetName() << " = " << toys[j*nObs+l] << endl;
+	}
+}
@@ -61,6 +61,8 @@ void ToyTree::initMembers(TChain* t){
 	statusScanPDF       = -5.;
 	chi2minToyPDF       = 0.;
 	chi2minGlobalToyPDF = 0.;
+	logWeight           = 0.;
+	pruned              = 0.;
 };
 
 ///
@@ -84,6 +86,25 @@ void ToyTree::setCombiner(Combiner* c)
 	obsName  = "obs_"+c->getPdfName();
 	parsName = "par_"+c->getPdfName();
 	thName   = "th_"+c->getPdfName();
+
+	// If init() was already called, point the store*() functions to the
+	// variables of the new combiner. They are matched by position.
+	if ( parsVars.size()>0 || obsVars.size()>0 || thVars.size()>0 ){
+		const RooArgSet* pars = w->set(parsName);
+		const RooArgSet* obs  = w->set(obsName);
+		const RooArgSet* th   = w->set(thName);
+		if ( pars->getSize()!=parsVars.size() || (obsVars.size()>0 && obs->getSize()!=obsVars.size())
+				|| (thVars.size()>0 && th->getSize()!=thVars.size()) ){
+			cout << "ToyTree::setCombiner() : ERROR : new combiner has a different structure. Exit." << endl;
+			exit(1);
+		}
+		RooArgList parsList(*pars);
+		for ( int i=0; i<parsVars.size(); i++ ) parsVars[i] = (RooRealVar*)parsList.at(i);
+		RooArgList obsList(*obs);
+		for ( int i=0; i<obsVars.size(); i++ ) obsVars[i] = (RooRealVar*)obsList.at(i);
+		RooArgList thList(*th);
+		for ( int i=0; i<thVars.size(); i++ ) thVars[i] = (RooAbsReal*)thList.at(i);
+	}
 }
 
 ///
@@ -136,6 +157,7 @@ void ToyTree::init()
 	t->Branch("id",               &id,                "id/F");
 	t->Branch("nBergerBoos",      &nBergerBoos,       "nBergerBoos/F");
 	t->Branch("nrun",             &nrun,              "nrun/F");
+	t->Branch("pruned",           &pruned,            "pruned/F");
 	t->Branch("scanbest",         &scanbest,          "scanbest/F");
 	t->Branch("scanbesty",        &scanbesty,         "scanbesty/F");
 	t->Branch("scanpoint",        &scanpoint,         "scanpoint/F");
@@ -143,36 +165,47 @@ void ToyTree::init()
 	t->Branch("statusFree",       &statusFree,        "statusFree/F");
 	t->Branch("statusScan",       &statusScan,        "statusScan/F");
 	t->Branch("statusScanData",   &statusScanData,    "statusScanData/F");
+	t->Branch("logWeight",        &logWeight,         "logWeight/D");
 
 	if ( !arg->lightfiles )
 	{
+		// parameters
+		vector<TString> names;
 		TIterator* it = w->set(parsName)->createIterator();
 		while ( RooRealVar* p = (RooRealVar*)it->Next() )
 		{
-			parametersScan.insert(pair<string,float>(p->GetName(),p->getVal()));
-			t->Branch(TString(p->GetName())+"_scan", &parametersScan[p->GetName()], TString(p->GetName())+"_scan/F");
-			parametersFree.insert(pair<string,float>(p->GetName(),p->getVal()));
-			t->Branch(TString(p->GetName())+"_free", &parametersFree[p->GetName()], TString(p->GetName())+"_free/F");
-			parametersPll.insert(pair<string,float>(p->GetName(),p->getVal()));
-			t->Branch(TString(p->GetName())+"_start", &parametersPll[p->GetName()], TString(p->GetName())+"_start/F");
+			parsVars.push_back(p);
+			names.push_back(p->GetName());
+			parametersScan.push_back(p->getVal());
+			parametersFree.push_back(p->getVal());
+			parametersPll.push_back(p->getVal());
 		}
+		bookBranches("pars_scan", "_scan", names, parametersScan);
+		bookBranches("pars_free", "_free", names, parametersFree);
+		bookBranches("pars_start", "_start", names, parametersPll);
 		// observables
 		if(this->storeObs){
+			names.clear();
 			delete it; it = w->set(obsName)->createIterator();
 			while ( RooRealVar* p = (RooRealVar*)it->Next() )
 			{
-				observables.insert(pair<string,float>(p->GetName(),p->getVal()));
-				t->Branch(TString(p->GetName()), &observables[p->GetName()], TString(p->GetName())+"/F");
+				obsVars.push_back(p);
+				names.push_back(p->GetName());
+				observables.push_back(p->getVal());
 			}
+			bookBranches("obs", "", names, observables);
 		}
 		// theory
 		if(this->storeTh){
+			names.clear();
 			delete it; it = w->set(thName)->createIterator();
-			while ( RooRealVar* p = (RooRealVar*)it->Next() )
+			while ( RooAbsReal* p = (RooAbsReal*)it->Next() )
 			{
-				theory.insert(pair<string,float>(p->GetName(),p->getVal()));
-				t->Branch(TString(p->GetName()), &theory[p->GetName()], TString(p->GetName())+"/F");
+				thVars.push_back(p);
+				names.push_back(p->GetName());
+				theory.push_back(p->getVal());
 			}
+			bookBranches("th", "", names, theory);
 		}
 		// gau constraints for B2MuMu Combinations
 		if(!this->storeTh){
@@ -189,6 +222,34 @@ void ToyTree::init()
 	}
 }
 
+///
+/// Helper function for init(). Book the branches of one category
+/// of variables. By default each variable gets its own branch, named
+/// by the variable name plus a suffix. With --columnar the whole
+/// category is stored in one array branch instead, and tree aliases
+/// with the usual branch names point to the array elements, so that
+/// e.g. TTree::Draw("g_free") keeps working.
+///
+/// \param arrayName - name of the array branch
+/// \param suffix    - appended to the variable names, e.g. "_free"
+/// \param names     - names of the variables
+/// \param values    - storage of the values, must not be resized afterwards
+///
+void ToyTree::bookBranches(TString arrayName, TString suffix, const vector<TString>& names, vector<float>& values)
+{
+	if ( values.size()==0 ) return;
+	if ( arg->columnar ){
+		t->Branch(arrayName, &values[0], arrayName+Form("[%i]/F", (int)values.size()));
+		for ( int i=0; i<names.size(); i++ ){
+			t->SetAlias(names[i]+suffix, arrayName+Form("[%i]", i));
+		}
+		return;
+	}
+	for ( int i=0; i<names.size(); i++ ){
+		t->Branch(names[i]+suffix, &values[i], names[i]+suffix+"/F");
+	}
+}
+
 ///
 /// Provide the interface to read an external TChain.
 ///
@@ -205,6 +266,7 @@ void ToyTree::open()
 	if(branches->FindObject("covQualScanData"    )) t->SetBranchAddress("covQualScanData",    &covQualScanData);
 	if(branches->FindObject("genericProbPValue"  )) t->SetBranchAddress("genericProbPValue",  &genericProbPValue);
 	if(branches->FindObject("nBergerBoos"        )) t->SetBranchAddress("nBergerBoos",        &nBergerBoos);
+	if(branches->FindObject("pruned"             )) t->SetBranchAddress("pruned",             &pruned);
 	if(branches->FindObject("scanbest"           )) t->SetBranchAddress("scanbest",           &scanbest);
 	if(branches->FindObject("scanbesty"          )) t->SetBranchAddress("scanbesty",          &scanbesty);
 	if(branches->FindObject("scanpoint"          )) t->SetBranchAddress("scanpoint",          &scanpoint);
@@ -220,6 +282,17 @@ void ToyTree::open()
 	if(branches->FindObject("statusFreePDF"      )) t->SetBranchAddress("statusFreePDF",      &statusFreePDF);
 	if(branches->FindObject("statusScanData"     )) t->SetBranchAddress("statusScanData",     &statusScanData);
 	if(branches->FindObject("statusScanPDF"      )) t->SetBranchAddress("statusScanPDF",      &statusScanPDF);
+	if(branches->FindObject("logWeight"          )) t->SetBranchAddress("logWeight",          &logWeight);
+
+	// files written with --columnar store the per-variable names as
+	// tree aliases, make them available on the chain as well
+	if ( t->LoadTree(0)>=0 && t->GetTree() && t->GetTree()!=t && t->GetTree()->GetListOfAliases() ){
+		TIterator* it = t->GetTree()->GetListOfAliases()->MakeIterator();
+		while ( TNamed* alias = (TNamed*)it->Next() ){
+			if ( !t->GetAlias(alias->GetName()) ) t->SetAlias(alias->GetName(), alias->GetTitle());
+		}
+		delete it;
+	}
 }
 
 ///
@@ -237,6 +310,7 @@ void ToyTree::activateCoreBranchesOnly()
 	if(branches->FindObject("genericProbPValue"))     t->SetBranchStatus("genericProbPValue",  1);
 	if(branches->FindObject("id"))                    t->SetBranchStatus("id",                 1);
 	if(branches->FindObject("nBergerBoos"))           t->SetBranchStatus("nBergerBoos",        1);
+	if(branches->FindObject("pruned"))                t->SetBranchStatus("pruned",             1);
 	if(branches->FindObject("scanpoint"))             t->SetBranchStatus("scanpoint",          1);
 	if(branches->FindObject("scanpointy"))            t->SetBranchStatus("scanpointy",         1);
 	if(branches->FindObject("statusFree"))            t->SetBranchStatus("statusFree",         1);
@@ -250,6 +324,7 @@ void ToyTree::activateCoreBranchesOnly()
 	if(branches->FindObject("statusFreePDF"))         t->SetBranchStatus("statusFreePDF",      1);
 	if(branches->FindObject("statusScanData"))        t->SetBranchStatus("statusScanData",     1);
 	if(branches->FindObject("statusScanPDF"))         t->SetBranchStatus("statusScanPDF",      1);
+	if(branches->FindObject("logWeight"))             t->SetBranchStatus("logWeight",          1);
 }
 
 ///
@@ -281,9 +356,7 @@ void ToyTree::storeParsPll()
 		w->Print("v");
 		assert(0);
 	}
-	TIterator* it = w->set(parsName)->createIterator();
-	while ( RooRealVar* p = (RooRealVar*)it->Next() ) parametersPll[p->GetName()] = p->getVal();
-	delete it;
+	for ( int i=0; i<parsVars.size(); i++ ) parametersPll[i] = parsVars[i]->getVal();
 }
 
 ///
@@ -292,11 +365,7 @@ void ToyTree::storeParsPll()
 ///
 void ToyTree::storeParsFree()
 {
-	TIterator* it = w->set(parsName)->createIterator();
-	while ( RooRealVar* p = (RooRealVar*)it->Next() ){
-		parametersFree[p->GetName()] = p->getVal();
-	}
-	delete it;
+	for ( int i=0; i<parsVars.size(); i++ ) parametersFree[i] = parsVars[i]->getVal();
 }
 
 ///
@@ -328,9 +397,7 @@ void ToyTree::storeParsGau()
 ///
 void ToyTree::storeParsScan()
 {
-	TIterator* it = w->set(parsName)->createIterator();
-	while ( RooRealVar* p = (RooRealVar*)it->Next() ) parametersScan[p->GetName()] = p->getVal();
-	delete it;
+	for ( int i=0; i<parsVars.size(); i++ ) parametersScan[i] = parsVars[i]->getVal();
 }
 
 ///
@@ -338,9 +405,7 @@ void ToyTree::storeParsScan()
 ///
 void ToyTree::storeTheory()
 {
-	TIterator* it = w->set(thName)->createIterator();
-	while ( RooRealVar* p = (RooRealVar*)it->Next() ) theory[p->GetName()] = p->getVal();
-	delete it;
+	for ( int i=0; i<thVars.size(); i++ ) theory[i] = thVars[i]->getVal();
 }
 
 ///
@@ -348,9 +413,59 @@ void ToyTree::storeTheory()
 ///
 void ToyTree::storeObservables()
 {
-	TIterator* it = w->set(obsName)->createIterator();
-	while ( RooRealVar* p = (RooRealVar*)it->Next() ) observables[p->GetName()] = p->getVal();
-	delete it;
+	for ( int i=0; i<obsVars.size(); i++ ) observables[i] = obsVars[i]->getVal();
+}
+
+///
+/// Copy the current values of all proxy variables, i.e. of everything
+/// that fill() would write into the tree, into a flat vector. Together
+/// with setProxyValues() this allows to transfer a tree entry that was
+/// computed elsewhere, e.g. by a parallel toy worker.
+///
+/// \param values - the vector to be filled, previous content is discarded
+///
+void ToyTree::getProxyValues(vector<double>& values)
+{
+	values.clear();
+	float core[] = {BergerBoos_id, chi2min, chi2minGlobal, chi2minGlobalToy, chi2minToy,
+		covQualFree, covQualScan, covQualScanData, genericProbPValue, id, nBergerBoos,
+		nrun, pruned, scanbest, scanbesty, scanpoint, scanpointy, statusFree, statusScan, statusScanData};
+	values.insert(values.end(), core, core+sizeof(core)/sizeof(float));
+	values.push_back(logWeight);
+	values.insert(values.end(), parametersScan.begin(), parametersScan.end());
+	values.insert(values.end(), parametersFree.begin(), parametersFree.end());
+	values.insert(values.end(), parametersPll.begin(), parametersPll.end());
+	values.insert(values.end(), observables.begin(), observables.end());
+	values.insert(values.end(), theory.begin(), theory.end());
+	for ( map<TString,float>::iterator it=constraintMeans.begin(); it!=constraintMeans.end(); it++ ) values.push_back(it->second);
+}
+
+///
+/// Set all proxy variables from a flat vector that was previously
+/// obtained by getProxyValues() of a ToyTree with identical structure.
+/// Call fill() afterwards to write the entry into the tree.
+///
+void ToyTree::setProxyValues(const vector<double>& values)
+{
+	int i = 0;
+	float* core[] = {&BergerBoos_id, &chi2min, &chi2minGlobal, &chi2minGlobalToy, &chi2minToy,
+		&covQualFree, &covQualScan, &covQualScanData, &genericProbPValue, &id, &nBergerBoos,
+		&nrun, &pruned, &scanbest, &scanbesty, &scanpoint, &scanpointy, &statusFree, &statusScan, &statusScanData};
+	int nCore = sizeof(core)/sizeof(float*);
+	int nExpected = nCore + 1 + parametersScan.size() + parametersFree.size() + parametersPll.size()
+		+ observables.size() + theory.size() + constraintMeans.size();
+	if ( values.size()!=nExpected ){
+		cout << "ToyTree::setProxyValues() : ERROR : expected " << nExpected << " values, got " << values.size() << ". Exit." << endl;
+		exit(1);
+	}
+	for ( int j=0; j<nCore; j++ ) *core[j] = values[i++];
+	logWeight = values[i++];
+	for ( int j=0; j<parametersScan.size(); j++ ) parametersScan[j] = values[i++];
+	for ( int j=0; j<parametersFree.size(); j++ ) parametersFree[j] = values[i++];
+	for ( int j=0; j<parametersPll.size(); j++ ) parametersPll[j] = values[i++];
+	for ( int j=0; j<observables.size(); j++ ) observables[j] = values[i++];
+	for ( int j=0; j<theory.size(); j++ ) theory[j] = values[i++];
+	for ( map<TString,float>::iterator it=constraintMeans.begin(); it!=constraintMeans.end(); it++ ) it->second = values[i++];
 }
 
 Long64_t ToyTree::GetEntries()
@@ -6,61 +6,63 @@
  **/
 
 #include "Utils.h"
+#include "ImproveFitter.h"
+#include "MultiStartFitter.h"
+#include "OptParser.h"
 
 int Utils::countFitBringBackAngle;      ///< counts how many times an angle needed to be brought back
 int Utils::countAllFitBringBackAngle;   ///< counts how many times fitBringBackAngle() was called
+bool Utils::isWorkerProcess = false;    ///< true in forked worker processes, which must not fork again
 
 ///
 /// Fit PDF to minimum.
 /// \param pdf The PDF.
 /// \param thorough Activate Hesse and Minos
 /// \param printLevel -1 = no output, 1 verbose output
+/// \param session Reuse the minimizer of this session. If it is 0 or was built
+///                for a different PDF, a temporary session is used.
 ///
-RooFitResult* Utils::fitToMin(RooAbsPdf *pdf, bool thorough, int printLevel)
+RooFitResult* Utils::fitToMin(RooAbsPdf *pdf, bool thorough, int printLevel, MinimizerSession *session)
 {
-	RooMsgService::instance().setGlobalKillBelow(ERROR);
-
-	RooFormulaVar ll("ll", "ll", "-2*log(@0)", RooArgSet(*pdf));
+	MinimizerSession *s = session;
+	if ( !s || s->getPdf()!=pdf ) s = new MinimizerSession(pdf);
 	bool quiet = printLevel<0;
-	RooMinuit m(ll);
-	if (quiet){
-		m.setPrintLevel(-2);
-		m.setNoWarn();
-	}
-	else m.setPrintLevel(1);
-	// if (quiet) m.setLogFile();
-	m.setErrorLevel(1.0);
-	m.setStrategy(2);
-	m.setProfile(0); // 1 enables migrad timer
+	s->setPrintLevel(printLevel);
+	s->setErrorLevel(1.0);
+	s->setStrategy(2);
 	unsigned long long start = rdtsc();
-	int status = m.migrad();
-	// m.simplex();
-	// m.migrad();
-	// m.simplex();
-	if (thorough){
-		m.hesse();
-		// MINOS seems to fail in more complicated scenarios
-		// Can't just use m.minos() because there's a cout that cannot be turned off (root 5-34-03).
-		// It's not there when we run minos only on selected parameters- so select them all!
-		// //m.minos();
-		// RooArgSet floatingPars;
-		// TIterator* it = pdf->getVariables()->createIterator();
-		// while ( RooRealVar* p = (RooRealVar*)it->Next() ){
-		//   if ( !p->isConstant() ) floatingPars.add(*p);
-		// }
-		// delete it;
-		// m.minos(floatingPars);
-		// IMPROVE doesn't really improve much
-		// //m.improve();
-	}
+	s->fit(thorough);
+	// MINOS seems to fail in more complicated scenarios, and
+	// IMPROVE doesn't really improve much, so HESSE is all we run.
 	unsigned long long stop = rdtsc();
 	if (!quiet) std::printf("Fit took %llu clock cycles.\n", stop - start);
-	RooFitResult *r = m.save();
-	// if (!quiet) r->Print("v");
-	RooMsgService::instance().setGlobalKillBelow(INFO);
+	RooFitResult *r = s->save();
+	if ( s!=session ) delete s;
 	return r;
 }
 
+///
+/// Find the native chi2 function (RooGausChi2Var) of a PDF. It is
+/// built by Combiner::combine() for combinations that consist only
+/// of multivariate Gaussians, and computes the same value as
+/// -2*log(pdf), only faster.
+///
+/// \param pdf - the (combined) PDF
+/// \return the chi2 function, or 0 if the PDF doesn't have one
+///
+RooAbsReal* Utils::findGausChi2Var(RooAbsPdf *pdf)
+{
+	TIterator* it = pdf->clientIterator();
+	while ( RooAbsArg* client = (RooAbsArg*)it->Next() ){
+		if ( client->InheritsFrom("RooGausChi2Var") ){
+			delete it;
+			return (RooAbsReal*)client;
+		}
+	}
+	delete it;
+	return 0;
+}
+
 ///
 /// Return an equivalent angle between 0 and 2pi.
 /// \param angle Angle that is possibly smaller than 0 or larger than 2pi.
@@ -95,160 +97,82 @@ double Utils::angularDifference(double angle1, double angle2)
 /// interval, add multiples of 2pi to bring it back. Then, refit.
 /// All variables that have unit 'rad' are taken to be angles.
 ///
-RooFitResult* Utils::fitToMinBringBackAngles(RooAbsPdf *pdf, bool thorough, int printLevel)
+/// \param session Reuse the minimizer of this session. If it is 0 or was built
+///                for a different PDF, a temporary session is used.
+///
+RooFitResult* Utils::fitToMinBringBackAngles(RooAbsPdf *pdf, bool thorough, int printLevel, MinimizerSession *session)
+{
+	MinimizerSession *s = session;
+	if ( !s || s->getPdf()!=pdf ) s = new MinimizerSession(pdf);
+	fitToMinBringBackAngles(s, thorough, printLevel);
+	RooFitResult *r = s->save();
+	if ( s!=session ) delete s;
+	return r;
+}
+
+///
+/// Same as above, but don't create a RooFitResult. The fit status,
+/// EDM, covariance quality and minimum chi2 can be obtained from
+/// the session, the parameters are left at the minimum.
+///
+/// \param session - the minimizer session
+/// \param thorough - activate Hesse
+/// \param printLevel - -1 = no output, 1 verbose output
+///
+void Utils::fitToMinBringBackAngles(MinimizerSession *session, bool thorough, int printLevel)
 {
 	countAllFitBringBackAngle++;
-	RooFitResult* r = fitToMin(pdf, thorough, printLevel);
+	session->setPrintLevel(printLevel);
+	session->setErrorLevel(1.0);
+	session->setStrategy(2);
+	session->fit(thorough);
 	bool refit = false;
-	TIterator* it = r->floatParsFinal().createIterator();
-	while ( RooRealVar* p = (RooRealVar*)it->Next() ){
-		if ( ! isAngle(p) ) continue;
+	const RooArgList& pars = session->getParameters();
+	for ( int i=0; i<pars.getSize(); i++ ){
+		RooRealVar *p = (RooRealVar*)pars.at(i);
+		if ( p->isConstant() || !isAngle(p) ) continue;
 		if ( p->getVal()<0.0 || p->getVal()>2.*TMath::Pi() ){
-			RooArgSet *pdfPars = pdf->getParameters(RooArgSet());
-			RooRealVar *pdfPar = (RooRealVar*)pdfPars->find(p->GetName());
-			pdfPar->setVal(bringBackAngle(p->getVal()));
+			p->setVal(bringBackAngle(p->getVal()));
 			refit = true;
-			delete pdfPars;
 		}
 	}
 	if ( refit ){
 		countFitBringBackAngle++;
-		delete r;
-		r = fitToMin(pdf, thorough, printLevel);
+		session->fit(thorough);
 	}
-	delete it;
-	return r;
 }
 
 ///
 /// Find the global minimum in a more thorough way.
-/// First fit with external start parameters, then
-/// for each parameter that starts with "d" or "r" (typically angles and ratios):
-///   - at upper scan range, rest at start parameters
-///   - at lower scan range, rest at start parameters
-/// This amounts to a maximum of 1+2^n fits, where n is the number
-/// of parameters to be varied.
+/// First fit with external start parameters, then refit from a set of
+/// start points for the parameters that start with "d" or "k" (typically
+/// angles and some ratios). By default these are all corners of the
+/// force ranges, which amounts to a maximum of 1+2^n fits, where n is the
+/// number of parameters to be varied. See MultiStartFitter.
 ///
 /// \param w Workspace holding the pdf.
 /// \param name Name of the pdf without leading "pdf_".
 /// \param forceVariables Apply the force method for these variables only. Format
 /// "var1,var2,var3," (list must end with comma). Default is to apply for all angles,
 /// all ratios except rD_k3pi and rD_kpi, and the k3pi coherence factor.
+/// \param session Minimizer to be used for all fits.
+/// \param arg If given, the start set (--forcestarts, --nforcestarts) and the
+/// number of parallel workers (--nthreads) are taken from the command line.
+/// Starts are then abandoned early, see MultiStartFitter::setAbandonMargin(),
+/// unless the default corners are fitted serially.
 ///
-RooFitResult* Utils::fitToMinForce(RooWorkspace *w, TString name, TString forceVariables)
+RooFitResult* Utils::fitToMinForce(RooWorkspace *w, TString name, TString forceVariables, MinimizerSession *session, OptParser *arg)
 {
-	bool debug = true;
-
-	TString parsName = "par_"+name;
-	TString obsName  = "obs_"+name;
-	TString pdfName  = "pdf_"+name;
-	RooFitResult *r = 0;
-	int printlevel = -1;
-	RooMsgService::instance().setGlobalKillBelow(ERROR);
-
-	// save start parameters
-	if ( !w->set(parsName) ){
-		cout << "MethodProbScan::scan2d() : ERROR : parsName not found: " << parsName << endl;
-		exit(1);
-	}
-	RooDataSet *startPars = new RooDataSet("startParsForce", "startParsForce", *w->set(parsName));
-	startPars->add(*w->set(parsName));
-
-	// set up parameters and ranges
-	RooArgList *varyPars = new RooArgList();
-	TIterator* it = w->set(parsName)->createIterator();
-	while ( RooRealVar* p = (RooRealVar*)it->Next() )
-	{
-		if ( p->isConstant() ) continue;
-		if ( forceVariables=="" && ( false
-					|| TString(p->GetName()).BeginsWith("d") ///< use these variables
-					// || TString(p->GetName()).BeginsWith("r")
-					|| TString(p->GetName()).BeginsWith("k")
-					|| TString(p->GetName()) == "g"
-					) && ! (
-						TString(p->GetName()) == "rD_k3pi"  ///< don't use these
-						|| TString(p->GetName()) == "rD_kpi"
-						// || TString(p->GetName()) == "dD_kpi"
-						|| TString(p->GetName()) == "d_dk"
-						|| TString(p->GetName()) == "d_dsk"
-						))
-		{
-			varyPars->add(*p);
-		}
-		else if ( forceVariables.Contains(TString(p->GetName())+",") )
-		{
-			varyPars->add(*p);
-		}
-	}
-	delete it;
-	int nPars = varyPars->getSize();
-	if ( debug ) cout << "Utils::fitToMinForce() : nPars = " << nPars << " => " << pow(2.,nPars) << " fits" << endl;
-	if ( debug ) cout << "Utils::fitToMinForce() : varying ";
-	if ( debug ) varyPars->Print();
-
-	//////////
-
-	r = fitToMinBringBackAngles(w->pdf(pdfName), false, printlevel);
-
-	//////////
-
-	int nErrors = 0;
-
-	// We define a binary mask where each bit corresponds
-	// to parameter at max or at min.
-	for ( int i=0; i<pow(2.,nPars); i++ )
-	{
-		if ( debug ) cout << "Utils::fitToMinForce() : fit " << i << "        \r" << flush;
-		setParameters(w, parsName, startPars->get(0));
-
-		for ( int ip=0; ip<nPars; ip++ )
-		{
-			RooRealVar *p = (RooRealVar*)varyPars->at(ip);
-			float oldMin = p->getMin();
-			float oldMax = p->getMax();
-			setLimit(w, p->GetName(), "force");
-			if ( i/(int)pow(2.,ip) % 2==0 ) { p->setVal(p->getMin()); }
-			if ( i/(int)pow(2.,ip) % 2==1 ) { p->setVal(p->getMax()); }
-			p->setRange(oldMin, oldMax);
-		}
-
-		// check if start parameters are sensible, skip if they're not
-		double startParChi2 = getChi2(w->pdf(pdfName));
-		if ( startParChi2>2000 ){
-			nErrors += 1;
-			continue;
-		}
-
-		// refit
-		RooFitResult *r2 = fitToMinBringBackAngles(w->pdf(pdfName), false, printlevel);
-
-		// In case the initial fit failed, accept the second one.
-		// If both failed, still select the second one and hope the
-		// next fit succeeds.
-		if ( !(r->edm()<1 && r->covQual()==3) ){
-			delete r;
-			r = r2;
-		}
-		else if ( r2->edm()<1 && r2->covQual()==3 && r2->minNll()<r->minNll() ){
-			// better minimum found!
-			delete r;
-			r = r2;
-		}
-		else{
-			delete r2;
-		}
+	MultiStartFitter f(w, name, session);
+	f.setForceVariables(forceVariables);
+	if ( arg ){
+		f.setStartSet(arg->forcestarts);
+		f.setNstarts(arg->nforcestarts);
+		f.setNworkers(arg->nthreads);
+		// abandon starts early only where it can't change the default
+		if ( arg->nthreads>0 || arg->forcestarts!="corners" ) f.setAbandonMargin(1.);
 	}
-
-	if ( debug ) cout << endl;
-	if ( debug ) cout << "Utils::fitToMinForce() : nErrors = " << nErrors << endl;
-
-	RooMsgService::instance().setGlobalKillBelow(INFO);
-
-	// (re)set to best parameters
-	setParameters(w, parsName, r);
-
-	delete startPars;
-	return r;
+	return f.fit();
 }
 
 ///
@@ -266,147 +190,20 @@ RooFitResult* Utils::fitToMinForce(RooWorkspace *w, TString name, TString forceV
 /// parameters.
 /// So far it is only available for the Prob method, via the probimprove
 /// command line flag.
+/// This builds the augmented chi2 for a single fit. When fitting many
+/// times, keep an ImproveFitter instead, see MethodAbsScan::getImproveFitter().
 ///
 RooFitResult* Utils::fitToMinImprove(RooWorkspace *w, TString name)
 {
-	TString parsName = "par_"+name;
-	TString obsName  = "obs_"+name;
-	TString pdfName  = "pdf_"+name;
-	int printlevel = -1;
-	RooMsgService::instance().setGlobalKillBelow(ERROR);
-
-	// step 1: find a minimum to start with
-	RooFitResult *r1 = 0;
-	{
-		RooFormulaVar ll("ll", "ll", "-2*log(@0)", RooArgSet(*w->pdf(pdfName)));
-		// RooFitResult* r1 = fitToMin(&ll, printlevel);
-		RooMinuit m(ll);
-		m.setPrintLevel(-2);
-		m.setNoWarn();
-		m.setErrorLevel(4.0); ///< define 2 sigma errors. This will make the hesse PDF 2 sigma wide!
-		int status = m.migrad();
-		r1 = m.save();
-		// if ( 102<RadToDeg(w->var("g")->getVal())&&RadToDeg(w->var("g")->getVal())<103 )
-		// {
-		//   cout << "step 1" << endl;
-		//   r1->Print("v");
-		//   gStyle->SetPalette(1);
-		//   float xmin = 0.;
-		//   float xmax = 3.14;
-		//   float ymin = 0.;
-		//   float ymax = 0.2;
-		//   TH2F* histo = new TH2F("histo", "histo", 100, xmin, xmax, 100, ymin, ymax);
-		//   for ( int ix=0; ix<100; ix++ )
-		//   for ( int iy=0; iy<100; iy++ )
-		//   {
-		//     float x = xmin + (xmax-xmin)*(double)ix/(double)100;
-		//     float y = ymin + (ymax-ymin)*(double)iy/(double)100;
-		//     w->var("d_dk")->setVal(x);
-		//     w->var("r_dk")->setVal(y);
-		//     histo->SetBinContent(ix+1,iy+1,ll.getVal());
-		//   }
-		//   newNoWarnTCanvas("c2");
-		//   histo->GetZaxis()->SetRangeUser(0,20);
-		//   histo->Draw("colz");
-		//   setParameters(w, parsName, r1);
-		// }
-	}
-
-	// step 2: build and fit the improved fcn
-	RooFitResult *r2 = 0;
-	{
-		// create a Hesse PDF, import both PDFs into a new workspace,
-		// so that their parameters are linked
-		RooAbsPdf* hessePdf = r1->createHessePdf(*w->set(parsName));
-		if ( !hessePdf ) return r1;
-		// RooWorkspace* wImprove = (RooWorkspace*)w->Clone();
-		RooWorkspace* wImprove = new RooWorkspace();
-		wImprove->import(*w->pdf(pdfName));
-		wImprove->import(*hessePdf);
-		hessePdf = wImprove->pdf(hessePdf->GetName());
-		RooAbsPdf* fullPdf = wImprove->pdf(pdfName);
-
-		RooFormulaVar ll("ll", "ll", "-2*log(@0) +16*@1", RooArgSet(*fullPdf, *hessePdf));
-		// RooFitResult *r2 = fitToMin(&ll, printlevel);
-		RooMinuit m(ll);
-		m.setPrintLevel(-2);
-		m.setNoWarn();
-		m.setErrorLevel(1.0);
-		int status = m.migrad();
-		r2 = m.save();
-
-		// if ( 102<RadToDeg(w->var("g")->getVal())&&RadToDeg(w->var("g")->getVal())<103 )
-		// {
-		//   cout << "step 3" << endl;
-		//   r2->Print("v");
-		//
-		//   gStyle->SetPalette(1);
-		//   float xmin = 0.;
-		//   float xmax = 3.14;
-		//   float ymin = 0.;
-		//   float ymax = 0.2;
-		//   TH2F* histo = new TH2F("histo", "histo", 100, xmin, xmax, 100, ymin, ymax);
-		//   for ( int ix=0; ix<100; ix++ )
-		//   for ( int iy=0; iy<100; iy++ )
-		//   {
-		//     float x = xmin + (xmax-xmin)*(double)ix/(double)100;
-		//     float y = ymin + (ymax-ymin)*(double)iy/(double)100;
-		//     wImprove->var("d_dk")->setVal(x);
-		//     wImprove->var("r_dk")->setVal(y);
-		//     histo->SetBinContent(ix+1,iy+1,ll.getVal());
-		//   }
-		//   newNoWarnTCanvas("c7");
-		//   histo->GetZaxis()->SetRangeUser(0,20);
-		//   histo->Draw("colz");
-		//   // setParameters(wImprove, parsName, r1);
-		// }
-		delete wImprove;
-	}
-
-	// step 3: use the fit result of the improved fit as
-	// start parameters for the nominal fcn
-	RooFitResult* r3;
-	{
-		setParameters(w, parsName, r2);
-		RooFormulaVar ll("ll", "ll", "-2*log(@0)", RooArgSet(*w->pdf(pdfName)));
-		RooMinuit m(ll);
-		m.setPrintLevel(-2);
-		m.setNoWarn();
-		m.setErrorLevel(1.0);
-		int status = m.migrad();
-		r3 = m.save();
-		// if ( 102<RadToDeg(w->var("g")->getVal())&&RadToDeg(w->var("g")->getVal())<103 )
-		// {
-		//   cout << "step 3" << endl;
-		//   r3->Print("v");
-		// }
-	}
-
-	// step 5: chose better minimum
-	// cout << r1->minNll() << " " << r3->minNll() << endl;
-	RooFitResult* r = 0;
-	if ( r1->minNll()<r3->minNll() )
-	{
-		delete r3;
-		r = r1;
-	}
-	else
-	{
-		delete r1;
-		r = r3;
-		// cout << "Utils::fitToMinImprove() : improved fit is better!" << endl;
-	}
-
-	RooMsgService::instance().setGlobalKillBelow(INFO);
-
-	// set to best parameters
-	setParameters(w, parsName, r);
-	return r;
+	ImproveFitter f(w, name);
+	return f.fit();
 }
 
 
 double Utils::getChi2(RooAbsPdf *pdf)
 {
+	RooAbsReal *chi2 = findGausChi2Var(pdf);
+	if ( chi2 ) return chi2->getVal();
 	RooFormulaVar ll("ll", "ll", "-2*log(@0)", RooArgSet(*pdf));
 	return ll.getVal();
 }
@@ -705,15 +502,26 @@ TMatrixDSym* Utils::buildCovMatrix(TMatrixDSym &cor, vector<double> &err)
 /// Duplicate variables will only be contained once.
 ///
 void Utils::mergeNamedSets(RooWorkspace *w, TString mergedSet, TString set1, TString set2)
+{
+	vector<TString> sets;
+	sets.push_back(set1);
+	sets.push_back(set2);
+	mergeNamedSets(w, mergedSet, sets);
+}
+
+///
+/// Merge any number of named sets of variables inside a RooWorkspace.
+/// Duplicate variables will only be contained once.
+///
+void Utils::mergeNamedSets(RooWorkspace *w, TString mergedSet, const vector<TString>& sets)
 {
 	// 1. fill all variables into a vector
 	vector<string> varsAll;
-	TIterator* it = w->set(set1)->createIterator();
-	while ( RooRealVar* p = (RooRealVar*)it->Next() ) varsAll.push_back(p->GetName());
-	delete it;
-	it = w->set(set2)->createIterator();
-	while ( RooRealVar* p = (RooRealVar*)it->Next() ) varsAll.push_back(p->GetName());
-	delete it;
+	for ( int i=0; i<sets.size(); i++ ){
+		TIterator* it = w->set(sets[i])->createIterator();
+		while ( RooRealVar* p = (RooRealVar*)it->Next() ) varsAll.push_back(p->GetName());
+		delete it;
+	}
 
 	// 2. remove duplicates
 	sort(varsAll.begin(), varsAll.end());
@@ -862,10 +670,18 @@ TH1F* Utils::histHardCopy(const TH1F* h, bool copyContent, bool uniqueName)
 {
 	TString name = h->GetTitle();
 	if ( uniqueName ) name += getUniqueRootName();
-	TH1F* hNew = new TH1F(name, h->GetTitle(),
-			h->GetNbinsX(),
-			h->GetXaxis()->GetXmin(),
-			h->GetXaxis()->GetXmax());
+	TH1F* hNew;
+	if ( h->GetXaxis()->IsVariableBinSize() ){
+		hNew = new TH1F(name, h->GetTitle(),
+				h->GetNbinsX(),
+				h->GetXaxis()->GetXbins()->GetArray());
+	}
+	else {
+		hNew = new TH1F(name, h->GetTitle(),
+				h->GetNbinsX(),
+				h->GetXaxis()->GetXmin(),
+				h->GetXaxis()->GetXmax());
+	}
 	for ( int l=1; l<=h->GetNbinsX(); l++ ){
 		if ( copyContent ) hNew->SetBinContent(l, h->GetBinContent(l));
 		else hNew->SetBinContent(l, 0);